@@ -0,0 +1,2 @@
+-- Cells to multipolygon WKB (h3_postgis): a 30301 cell grid disk.
+SELECT length(h3_cells_to_multi_polygon_wkb(cells)) FROM bench_cell_sets WHERE name = 'disk_res9_k100';
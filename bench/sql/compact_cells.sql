@@ -0,0 +1,2 @@
+-- Compaction of the resolution 10 polyfill of the fixture polygon.
+SELECT count(*) FROM bench_cell_sets, h3_compact_cells(cells) WHERE name = 'city_res10';
@@ -0,0 +1,3 @@
+-- Grid disk: k = 10 around a random resolution 9 cell.
+\set id random(1, :rows)
+SELECT count(*) FROM bench_cells, h3_grid_disk(cell, 10) WHERE id = :id;
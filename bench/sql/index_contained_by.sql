@@ -0,0 +1,4 @@
+-- Index lookup: all indexed cells below the resolution 5 parent of a random
+-- indexed cell.
+\set id random(1, :rows)
+SELECT count(*) FROM bench_cells WHERE cell <@ (SELECT h3_cell_to_parent(cell, 5) FROM bench_cells WHERE id = :id);
@@ -0,0 +1,3 @@
+-- Index lookup: equality on a random indexed cell.
+\set id random(1, :rows)
+SELECT count(*) FROM bench_cells WHERE cell = (SELECT cell FROM bench_cells WHERE id = :id);
@@ -0,0 +1,3 @@
+-- Point indexing: 1000 random points to resolution 9 cells per transaction.
+\set start random(1, :rows - 999)
+SELECT count(h3_latlng_to_cell(pt, 9)) FROM bench_points WHERE id BETWEEN :start AND :start + 999;
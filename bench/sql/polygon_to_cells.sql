@@ -0,0 +1,2 @@
+-- Polyfill: the fixture polygon (with hole) at resolution :res.
+SELECT count(*) FROM bench_polygons, h3_polygon_to_cells(exterior, holes, :res) WHERE name = 'city';
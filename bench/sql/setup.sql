@@ -0,0 +1,72 @@
+-- Benchmark fixtures.
+--
+-- Everything is generated from a fixed seed so that result files produced by
+-- different builds describe the same workload. Expects the psql variable
+-- `rows` (number of random points) to be set by the runner.
+
+SELECT setseed(0.42);
+
+-- Random points on the sphere (uniform by area, not by lat/lng).
+CREATE TABLE bench_points AS
+    SELECT
+        i AS id,
+        point(
+            360 * random() - 180,
+            degrees(asin(2 * random() - 1))
+        ) AS pt
+    FROM generate_series(1, :rows) i;
+ALTER TABLE bench_points ADD PRIMARY KEY (id);
+
+-- Resolution 9 cells, physically ordered by cell so that BRIN sees the
+-- correlation it needs.
+CREATE TABLE bench_cells AS
+    SELECT
+        row_number() OVER (ORDER BY cell) AS id,
+        cell
+    FROM (SELECT h3_latlng_to_cell(pt, 9) AS cell FROM bench_points) c
+    ORDER BY cell;
+ALTER TABLE bench_cells ADD PRIMARY KEY (id);
+
+-- Roughly 11 km by 11 km polygon (with a hole) around Copenhagen.
+CREATE TABLE bench_polygons (name text PRIMARY KEY, exterior polygon, holes polygon[]);
+INSERT INTO bench_polygons VALUES (
+    'city',
+    '((12.50,55.63),(12.62,55.63),(12.62,55.73),(12.50,55.73))'::polygon,
+    ARRAY['((12.55,55.67),(12.57,55.67),(12.57,55.69),(12.55,55.69))'::polygon]
+);
+
+-- Cell sets used by the compact/uncompact and WKB benchmarks.
+CREATE TABLE bench_cell_sets (name text PRIMARY KEY, cells h3index[]);
+INSERT INTO bench_cell_sets
+    SELECT 'city_res10', array_agg(cell)
+    FROM bench_polygons, h3_polygon_to_cells(exterior, holes, 10) cell
+    WHERE name = 'city';
+INSERT INTO bench_cell_sets
+    SELECT 'city_res10_compact', array_agg(cell)
+    FROM bench_cell_sets, h3_compact_cells(cells) cell
+    WHERE name = 'city_res10';
+INSERT INTO bench_cell_sets
+    SELECT 'city_res8', array_agg(cell)
+    FROM bench_polygons, h3_polygon_to_cells(exterior, holes, 8) cell
+    WHERE name = 'city';
+INSERT INTO bench_cell_sets
+    SELECT 'disk_res9_k100', array_agg(cell)
+    FROM h3_grid_disk(h3_latlng_to_cell(point(12.56, 55.68), 9), 100) cell;
+
+-- Builds one index on bench_cells and reports how long it took and how big
+-- it ended up being.
+CREATE FUNCTION bench_build_index(method text, opclass text,
+    OUT build_ms double precision, OUT size_bytes bigint)
+AS $$
+DECLARE
+    started timestamptz;
+BEGIN
+    started := clock_timestamp();
+    EXECUTE format('CREATE INDEX bench_cells_idx ON bench_cells USING %s (cell %s)',
+        method, opclass);
+    build_ms := 1000 * extract(epoch FROM clock_timestamp() - started);
+    size_bytes := pg_relation_size('bench_cells_idx');
+END;
+$$ LANGUAGE plpgsql;
+
+VACUUM ANALYZE;
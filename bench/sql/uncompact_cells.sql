@@ -0,0 +1,2 @@
+-- Uncompaction of the compacted resolution 10 polyfill back to resolution 10.
+SELECT count(*) FROM bench_cell_sets, h3_uncompact_cells(cells, 10) WHERE name = 'city_res10_compact';
@@ -44,3 +44,49 @@ AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
 IS 'Finds the boundary of the index.
 
 Use `SET h3.extend_antimeridian TO true` to extend coordinates when crossing 180th meridian.';
+
+--@ availability: unreleased
+CREATE TYPE h3_bin_count AS (
+    cell h3index,
+    count bigint
+);
+
+CREATE OR REPLACE FUNCTION __h3_bin_points_transfn(
+    state internal,
+    latlng point,
+    resolution integer)
+RETURNS internal
+AS 'h3', 'h3_bin_points_transfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_bin_points_combinefn(
+    state1 internal,
+    state2 internal)
+RETURNS internal
+AS 'h3', 'h3_bin_points_combinefn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_bin_points_serialfn(state internal)
+RETURNS bytea
+AS 'h3', 'h3_bin_points_serialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_bin_points_deserialfn(serialized bytea, state internal)
+RETURNS internal
+AS 'h3', 'h3_bin_points_deserialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_bin_points_finalfn(state internal)
+RETURNS h3_bin_count[]
+AS 'h3', 'h3_bin_points_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ availability: unreleased
+CREATE AGGREGATE h3_bin_points_agg(latlng point, resolution integer) (
+    sfunc = __h3_bin_points_transfn,
+    stype = internal,
+    finalfunc = __h3_bin_points_finalfn,
+    combinefunc = __h3_bin_points_combinefn,
+    serialfunc = __h3_bin_points_serialfn,
+    deserialfunc = __h3_bin_points_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_bin_points_agg(point, integer) IS
+'Counts the points in each cell at the specified resolution, in h3index order. Use as `SELECT (unnest(h3_bin_points_agg(latlng, 9))).*`.
+
+Same as `SELECT h3_latlng_to_cell(latlng, 9), COUNT(*) ... GROUP BY 1`, but each worker of a parallel plan counts into its own hash table keyed by the cell, so only one row per distinct cell leaves it. NULL points are skipped.';
@@ -82,3 +82,17 @@ CREATE OR REPLACE FUNCTION
 AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
     h3_get_icosahedron_faces(h3index)
 IS 'Returns the icosahedron face numbers intersected by the index. Some cells span more than one face.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_get_resolutions(cells h3index[]) RETURNS integer[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_get_resolutions(h3index[])
+IS 'Returns the resolution of every index in the array, as an array of the same shape. NULL elements stay NULL.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_validate_cells(cells h3index[]) RETURNS integer[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_validate_cells(h3index[])
+IS 'Returns the subscripts of all elements of a one-dimensional array that are not valid H3 cells, in ascending order. NULL elements are skipped. An empty result means every cell is valid.';
@@ -33,6 +33,15 @@ AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
     h3_grid_disk_distances(h3index, integer)
 IS 'Preferred disk API with distances. Like h3_grid_disk(), but also returns the grid distance from origin for each returned cell. Handles pentagon distortion internally. Row order is not guaranteed.';
 
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_grid_disk_convolve(cells h3index[], cell_values double precision[], k integer DEFAULT 1, kernel text DEFAULT 'uniform', OUT cell h3index, OUT value double precision) RETURNS SETOF record
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_grid_disk_convolve(h3index[], double precision[], integer, text)
+IS 'Smooths values given per cell: returns, for every cell within k grid steps of an input cell, the sum of the input values around it weighted by their grid distance, in h3index order.
+
+Kernel `uniform` weights all distances by 1, `linear` by `1 - distance / (k + 1)`. Same as `SELECT d.index, SUM(weight * value) ... h3_grid_disk_distances(cell, k) d GROUP BY 1`, without producing a row per disk cell.';
+
 --@ availability: 4.5.0
 CREATE OR REPLACE FUNCTION
     h3_grid_ring(origin h3index, k integer DEFAULT 1) RETURNS SETOF h3index
@@ -135,3 +135,55 @@ CREATE OR REPLACE FUNCTION h3_cell_to_children_slow(index h3index) RETURNS SETOF
     AS $$ SELECT __h3_cell_to_children_aux($1, -1, -1) $$ LANGUAGE SQL;
     COMMENT ON FUNCTION h3_cell_to_children_slow(index h3index) IS
 'Compatibility wrapper that recursively expands one resolution step at a time.';
+
+--@ availability: unreleased
+CREATE TYPE h3_rollup_stats AS (
+    res integer,
+    cell h3index,
+    count bigint,
+    sum double precision,
+    min double precision,
+    max double precision
+);
+
+CREATE OR REPLACE FUNCTION __h3_rollup_transfn(
+    state internal,
+    cell h3index,
+    value double precision,
+    min_res integer,
+    max_res integer)
+RETURNS internal
+AS 'h3', 'h3_rollup_transfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_rollup_combinefn(
+    state1 internal,
+    state2 internal)
+RETURNS internal
+AS 'h3', 'h3_rollup_combinefn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_rollup_serialfn(state internal)
+RETURNS bytea
+AS 'h3', 'h3_rollup_serialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_rollup_deserialfn(serialized bytea, state internal)
+RETURNS internal
+AS 'h3', 'h3_rollup_deserialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_rollup_finalfn(state internal)
+RETURNS h3_rollup_stats[]
+AS 'h3', 'h3_rollup_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ availability: unreleased
+CREATE AGGREGATE h3_rollup(cell h3index, value double precision, min_res integer, max_res integer) (
+    sfunc = __h3_rollup_transfn,
+    stype = internal,
+    finalfunc = __h3_rollup_finalfn,
+    combinefunc = __h3_rollup_combinefn,
+    serialfunc = __h3_rollup_serialfn,
+    deserialfunc = __h3_rollup_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_rollup(h3index, double precision, integer, integer) IS
+'Aggregates values into count, sum, min and max for the ancestors of the cells at every resolution from `min_res` to `max_res`, sorted by resolution and cell. Use as `SELECT (unnest(h3_rollup(h3, value, 3, 9))).*`.
+
+Cells finer than `max_res` are counted in their ancestor at `max_res`, cells coarser than `min_res` and rows with a NULL cell or value are skipped. The state holds one entry per distinct cell at `max_res` in memory and the result is a single array, limited to 1 GB: for large inputs group by a coarse parent, e.g. `GROUP BY h3_cell_to_parent(h3, 3)`, to keep each group small.';
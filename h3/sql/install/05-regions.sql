@@ -37,6 +37,24 @@ CALLED ON NULL INPUT PARALLEL SAFE; COMMENT ON FUNCTION
     h3_polygon_to_cells_experimental(polygon, polygon[], integer, text)
 IS 'Takes an exterior polygon [and a set of hole polygon] and returns the set of hexagons that best fit the structure.';
 
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_polygon_to_cells_partition(exterior polygon, holes polygon[], resolution integer, part integer, nparts integer) RETURNS SETOF h3index
+AS 'h3' LANGUAGE C IMMUTABLE
+-- intentionally NOT STRICT
+CALLED ON NULL INPUT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_polygon_to_cells_partition(polygon, polygon[], integer, integer, integer)
+IS 'Returns part `part` (counting from 0) of `nparts` disjoint parts of `h3_polygon_to_cells`. Each part only fills a longitude strip of the polygon, so parts can be computed by parallel workers and their union is the full set of cells.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_tile_to_cells(z integer, x integer, y integer, resolution integer, margin double precision DEFAULT 0) RETURNS SETOF h3index
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_tile_to_cells(integer, integer, integer, integer, double precision)
+IS 'Returns the cells overlapping the bounding box of Web Mercator XYZ tile, extended by `margin` times the tile size.
+
+Same as `h3_polygon_to_cells_experimental` of `ST_Transform(ST_TileEnvelope(z, x, y, margin => margin), 4326)` in `overlapping_bbox` mode, without building the geometry.';
+
 --@ availability: 4.0.0
 --@ ref: h3_cells_to_multi_polygon_geometry, h3_cells_to_multi_polygon_geography, h3_cells_to_multi_polygon_geometry_agg, h3_cells_to_multi_polygon_geography_agg
 CREATE OR REPLACE FUNCTION
@@ -44,3 +62,30 @@ CREATE OR REPLACE FUNCTION
 AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
     h3_cells_to_multi_polygon(h3index[])
 IS 'Create a LinkedGeoPolygon describing the outline(s) of a set of hexagons. Polygon outlines will follow GeoJSON MultiPolygon order: Each polygon will have one outer loop, which is first in the list, followed by any holes.';
+
+--| ## Prepared regions
+--|
+--| A prepared region digests a polygon once for many point-in-polygon tests,
+--| e.g. when classifying a stream of points against a fixed set of areas.
+--| It stores, at the given resolution, the compacted cells inside the polygon
+--| and the cells near its boundary with the polygon edges crossing them. Most
+--| points are then answered by a cell lookup, and only points in boundary
+--| cells are tested against a few edges. Like `h3_polygon_to_cells`, edges
+--| are straight lines in longitude and latitude. Pick a resolution whose
+--| cells are small compared to the polygon.
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_region_prepare(exterior polygon, holes polygon[], resolution integer) RETURNS bytea
+AS 'h3' LANGUAGE C IMMUTABLE
+-- intentionally NOT STRICT
+CALLED ON NULL INPUT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_region_prepare(polygon, polygon[], integer)
+IS 'Prepares an exterior polygon [and a set of hole polygons] for `h3_region_contains`, using cells at the given resolution.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_region_contains(prepared bytea, latlng point) RETURNS boolean
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_region_contains(bytea, point)
+IS 'Returns true if the region prepared by `h3_region_prepare` contains the point.';
@@ -162,3 +162,34 @@ CREATE OPERATOR <@ (
 );
 COMMENT ON OPERATOR <@ (h3index, h3index) IS
   'Returns true if A is contained by B.';
+
+--@ availability: unreleased
+CREATE TYPE h3_grid_radius AS (
+    origin h3index,
+    k integer
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_within_radius(h3index, h3_grid_radius) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3_grid_radius_contains(h3_grid_radius, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ availability: unreleased
+CREATE OPERATOR <@ (
+    PROCEDURE = h3index_within_radius,
+    LEFTARG = h3index, RIGHTARG = h3_grid_radius,
+    COMMUTATOR = @>,
+    RESTRICT = contsel, JOIN = contjoinsel
+);
+COMMENT ON OPERATOR <@ (h3index, h3_grid_radius) IS
+  'Returns true if A is at most k grid steps from the origin, as measured by `<->`: `hex <@ (origin, k)::h3_grid_radius` is `hex <-> origin <= k`, but can use GiST and SP-GiST indexes.';
+--@ availability: unreleased
+CREATE OPERATOR @> (
+    PROCEDURE = h3_grid_radius_contains,
+    LEFTARG = h3_grid_radius, RIGHTARG = h3index,
+    COMMUTATOR = <@,
+    RESTRICT = contsel, JOIN = contjoinsel
+);
+COMMENT ON OPERATOR @> (h3_grid_radius, h3index) IS
+  'Returns true if B is at most k grid steps from the origin.';
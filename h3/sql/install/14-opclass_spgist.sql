@@ -18,7 +18,8 @@
 --| ## SP-GiST operator class (experimental)
 --|
 --| *This is still an experimental feature and may change in future versions.*
---| Supports containment queries (`@>`, `<@`) and equality (`=`) on `h3index` columns.
+--| Supports containment queries (`@>`, `<@`), equality (`=`) and grid radius
+--| searches (`<@ h3_grid_radius`) on `h3index` columns.
 --| Add an SP-GiST index using the `h3index_ops_experimental` operator class:
 --|
 --| ```sql
@@ -27,6 +28,9 @@
 --|
 --| -- containment query
 --| SELECT * FROM h3_data WHERE hex <@ '831c02fffffffff'::h3index;
+--|
+--| -- cells at most 2 grid steps away
+--| SELECT * FROM h3_data WHERE hex <@ ('831c02fffffffff', 2)::h3_grid_radius;
 --| ```
 
 --@ internal
@@ -62,8 +66,24 @@ AS
  -- OPERATOR  10  <<| ,  -- RTBelowStrategyNumber
  -- OPERATOR  11  |>> ,  -- RTAboveStrategyNumber
  -- OPERATOR  12  |&> ,  -- RTOverAboveStrategyNumber
+    OPERATOR  31  <@ (h3index, h3_grid_radius),  -- H3_GRID_RADIUS_STRATEGY
     FUNCTION  1  h3index_spgist_config(internal, internal),
     FUNCTION  2  h3index_spgist_choose(internal, internal),
     FUNCTION  3  h3index_spgist_picksplit(internal, internal),
     FUNCTION  4  h3index_spgist_inner_consistent(internal, internal),
     FUNCTION  5  h3index_spgist_leaf_consistent(internal, internal);
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION h3_spgist_index_stats(
+    index regclass,
+    OUT level integer, OUT pages bigint, OUT inner_tuples bigint,
+    OUT leaf_tuples bigint, OUT avg_fanout double precision,
+    OUT avg_fill double precision, OUT null_prefixes double precision,
+    OUT resolutions bigint[]
+) RETURNS SETOF record
+    AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION h3_spgist_index_stats(regclass) IS
+'Describes the tree of an SP-GiST index using `h3index_ops_experimental`, one row per level starting at the root.
+`avg_fanout` is the number of child links per inner tuple, `null_prefixes` the share of inner tuples without a prefix
+and `resolutions` counts inner tuple prefixes per resolution 0 to 15.
+Sibling nodes partition the cells by base cell or digit, so unlike GiST they never overlap.';
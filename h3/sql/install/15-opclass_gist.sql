@@ -20,7 +20,8 @@
 --|
 --| *This is still an experimental feature and may change in future versions.*
 --| Supports containment queries (`@>`, `<@`), overlap (`&&`), equality (`=`),
---| and KNN distance ordering (`<->`) on `h3index` columns.
+--| grid radius searches (`<@ h3_grid_radius`) and KNN distance ordering (`<->`)
+--| on `h3index` columns.
 --| Add a GiST index using the `h3index_gist_ops_experimental` operator class:
 --|
 --| ```sql
@@ -30,6 +31,9 @@
 --| -- containment query
 --| SELECT * FROM h3_data WHERE hex <@ '831c02fffffffff'::h3index;
 --|
+--| -- cells at most 2 grid steps away
+--| SELECT * FROM h3_data WHERE hex <@ ('831c02fffffffff', 2)::h3_grid_radius;
+--|
 --| -- KNN nearest-neighbor ordering
 --| SELECT hex FROM h3_data ORDER BY hex <-> '831c02fffffffff'::h3index LIMIT 10;
 --| ```
@@ -65,6 +69,7 @@ AS
     OPERATOR  7   @>  ,  -- RTContainsStrategyNumber
     OPERATOR  8   <@  ,  -- RTContainedByStrategyNumber
     OPERATOR  15  <-> (h3index, h3index) FOR ORDER BY integer_ops,
+    OPERATOR  31  <@ (h3index, h3_grid_radius),  -- H3_GRID_RADIUS_STRATEGY
     FUNCTION  1  h3index_gist_consistent(internal, h3index, smallint, oid, internal),
     FUNCTION  2  h3index_gist_union(internal, internal),
     FUNCTION  5  h3index_gist_penalty(internal, internal, internal),
@@ -82,3 +87,18 @@ BEGIN
     END IF;
 END
 $$;
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION h3_gist_index_stats(
+    index regclass,
+    OUT level integer, OUT pages bigint, OUT tuples bigint,
+    OUT avg_fanout double precision, OUT avg_fill double precision,
+    OUT null_keys double precision, OUT overlap double precision,
+    OUT resolutions bigint[]
+) RETURNS SETOF record
+    AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION h3_gist_index_stats(regclass) IS
+'Describes the tree of a GiST index using `h3index_gist_ops_experimental`, one row per level starting at the root.
+The number of rows is the depth of the tree. `null_keys` is the share of mixed-base union keys,
+`overlap` the share of sibling keys on internal pages where one contains the other (NULL for the leaf level),
+and `resolutions` counts keys per resolution 0 to 15.';
@@ -35,3 +35,25 @@ COMMENT ON CAST (h3index AS bigint) IS
 CREATE CAST (h3index AS point) WITH FUNCTION h3_cell_to_latlng(h3index);
 COMMENT ON CAST (h3index AS point) IS
     'Convert H3 index to point.';
+
+--| # Packed cell arrays
+--|
+--| Binary form of cell arrays for bulk transfer, e.g. as `bytea` query
+--| parameters or through `COPY ... (FORMAT binary)`. The plain form is one
+--| little-endian unsigned 64-bit integer per cell. The delta form stores the
+--| first cell and the difference to each previous cell as LEB128 varints,
+--| which is compact for sorted input.
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_packed(cells h3index[], delta boolean DEFAULT FALSE) RETURNS bytea
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cells_to_packed(h3index[], boolean)
+IS 'Packs the cells into little-endian unsigned 64-bit integers, or LEB128 varint deltas when `delta` is true. The array must not contain NULLs.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_cells_from_packed(packed bytea, delta boolean DEFAULT FALSE) RETURNS h3index[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cells_from_packed(bytea, boolean)
+IS 'Unpacks cells written by `h3_cells_to_packed` with the same `delta` setting. The values are not validated.';
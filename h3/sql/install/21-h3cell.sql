@@ -0,0 +1,410 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+--| # Compact cell type
+--|
+--| `h3cell` stores a cell of resolution 0 to 10 in 5 bytes instead of the 8
+--| bytes of `h3index`, and needs no alignment padding in a row. It only keeps
+--| the resolution, base cell and used digits of the cell. Text and binary
+--| formats are the same as for `h3index`. `h3cell` casts implicitly to
+--| `h3index`, so every function taking `h3index` accepts it, and `h3index`
+--| values are converted on assignment, e.g. on `INSERT`. Only valid cells up
+--| to resolution 10 are accepted. B-tree, hash and BRIN indexes on `h3cell`
+--| columns also serve comparisons with `h3index` values, and sort cells in the
+--| same order as `h3index`.
+
+CREATE TYPE h3cell;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3cell_in(cstring) RETURNS h3cell
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3cell_out(h3cell) RETURNS cstring
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3cell_recv(internal) RETURNS h3cell
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3cell_send(h3cell) RETURNS bytea
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE h3cell (
+  INPUT          = h3cell_in,
+  OUTPUT         = h3cell_out,
+  RECEIVE        = h3cell_recv,
+  SEND           = h3cell_send,
+  INTERNALLENGTH = 5,
+  ALIGNMENT      = char,
+  STORAGE        = plain
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3cell_to_h3index(h3cell) RETURNS h3index
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ availability: unreleased
+CREATE CAST (h3cell AS h3index) WITH FUNCTION h3cell_to_h3index(h3cell) AS IMPLICIT;
+COMMENT ON CAST (h3cell AS h3index) IS
+    'Convert compact cell to H3 index.';
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3index_to_h3cell(h3index) RETURNS h3cell
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ availability: unreleased
+CREATE CAST (h3index AS h3cell) WITH FUNCTION h3index_to_h3cell(h3index) AS ASSIGNMENT;
+COMMENT ON CAST (h3index AS h3cell) IS
+    'Convert H3 index to compact cell. Fails for invalid cells and cells finer than resolution 10.';
+
+-- ---------- ---------- ---------- ---------- ---------- ---------- ----------
+-- Comparison operators
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_eq(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR = (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_eq,
+  COMMUTATOR = =,
+  NEGATOR = <>,
+  RESTRICT = eqsel,
+  JOIN = eqjoinsel,
+  HASHES, MERGES
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_ne(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR <> (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_ne,
+  COMMUTATOR = <>,
+  NEGATOR = =,
+  RESTRICT = neqsel,
+  JOIN = neqjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_lt(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR < (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_lt,
+  COMMUTATOR = >,
+  NEGATOR = >=,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_le(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR <= (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_le,
+  COMMUTATOR = >=,
+  NEGATOR = >,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_gt(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR > (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_gt,
+  COMMUTATOR = <,
+  NEGATOR = <=,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_ge(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR >= (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_ge,
+  COMMUTATOR = <=,
+  NEGATOR = <,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_h3index_eq(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR = (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_eq,
+  COMMUTATOR = =,
+  NEGATOR = <>,
+  RESTRICT = eqsel,
+  JOIN = eqjoinsel,
+  HASHES, MERGES
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_h3index_ne(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR <> (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_ne,
+  COMMUTATOR = <>,
+  NEGATOR = =,
+  RESTRICT = neqsel,
+  JOIN = neqjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_h3index_lt(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR < (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_lt,
+  COMMUTATOR = >,
+  NEGATOR = >=,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_h3index_le(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR <= (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_le,
+  COMMUTATOR = >=,
+  NEGATOR = >,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_h3index_gt(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR > (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_gt,
+  COMMUTATOR = <,
+  NEGATOR = <=,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_h3index_ge(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR >= (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_ge,
+  COMMUTATOR = <=,
+  NEGATOR = <,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_h3cell_eq(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR = (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_eq,
+  COMMUTATOR = =,
+  NEGATOR = <>,
+  RESTRICT = eqsel,
+  JOIN = eqjoinsel,
+  HASHES, MERGES
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_h3cell_ne(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR <> (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_ne,
+  COMMUTATOR = <>,
+  NEGATOR = =,
+  RESTRICT = neqsel,
+  JOIN = neqjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_h3cell_lt(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR < (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_lt,
+  COMMUTATOR = >,
+  NEGATOR = >=,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_h3cell_le(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR <= (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_le,
+  COMMUTATOR = >=,
+  NEGATOR = >,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_h3cell_gt(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR > (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_gt,
+  COMMUTATOR = <,
+  NEGATOR = <=,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_h3cell_ge(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR >= (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_ge,
+  COMMUTATOR = <=,
+  NEGATOR = <,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+-- ---------- ---------- ---------- ---------- ---------- ---------- ----------
+-- Operator classes, sharing the families of h3index
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_cmp(h3cell, h3cell) RETURNS integer
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_h3index_cmp(h3cell, h3index) RETURNS integer
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_h3cell_cmp(h3index, h3cell) RETURNS integer
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_sortsupport(internal) RETURNS void
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OPERATOR CLASS h3cell_ops DEFAULT FOR TYPE h3cell USING btree FAMILY h3index_ops AS
+    OPERATOR  1  <  ,
+    OPERATOR  2  <= ,
+    OPERATOR  3   = ,
+    OPERATOR  4  >= ,
+    OPERATOR  5  >  ,
+    OPERATOR  1  <  (h3cell, h3index),
+    OPERATOR  2  <= (h3cell, h3index),
+    OPERATOR  3  =  (h3cell, h3index),
+    OPERATOR  4  >= (h3cell, h3index),
+    OPERATOR  5  >  (h3cell, h3index),
+    OPERATOR  1  <  (h3index, h3cell),
+    OPERATOR  2  <= (h3index, h3cell),
+    OPERATOR  3  =  (h3index, h3cell),
+    OPERATOR  4  >= (h3index, h3cell),
+    OPERATOR  5  >  (h3index, h3cell),
+    FUNCTION  1  h3cell_cmp(h3cell, h3cell),
+    FUNCTION  1  (h3cell, h3index) h3cell_h3index_cmp(h3cell, h3index),
+    FUNCTION  1  (h3index, h3cell) h3index_h3cell_cmp(h3index, h3cell),
+    FUNCTION  2  h3cell_sortsupport(internal);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_hash(h3cell) RETURNS integer
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3cell_hash_extended(h3cell, int8) RETURNS int8
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OPERATOR CLASS h3cell_ops DEFAULT FOR TYPE h3cell USING hash FAMILY h3index_ops AS
+    OPERATOR  1   = ,
+    OPERATOR  1  = (h3cell, h3index),
+    OPERATOR  1  = (h3index, h3cell),
+    FUNCTION  1  h3cell_hash(h3cell),
+    FUNCTION  2  h3cell_hash_extended(h3cell, int8);
+
+--@ internal
+CREATE OPERATOR CLASS h3cell_minmax_ops DEFAULT FOR TYPE h3cell USING brin FAMILY h3index_minmax_ops AS
+    OPERATOR  1  <  ,
+    OPERATOR  2  <= ,
+    OPERATOR  3   = ,
+    OPERATOR  4  >= ,
+    OPERATOR  5  >  ,
+    OPERATOR  1  <  (h3cell, h3index),
+    OPERATOR  2  <= (h3cell, h3index),
+    OPERATOR  3  =  (h3cell, h3index),
+    OPERATOR  4  >= (h3cell, h3index),
+    OPERATOR  5  >  (h3cell, h3index),
+    OPERATOR  1  <  (h3index, h3cell),
+    OPERATOR  2  <= (h3index, h3cell),
+    OPERATOR  3  =  (h3index, h3cell),
+    OPERATOR  4  >= (h3index, h3cell),
+    OPERATOR  5  >  (h3index, h3cell),
+    FUNCTION  1  brin_minmax_opcinfo(internal),
+    FUNCTION  2  brin_minmax_add_value(internal, internal, internal, internal),
+    FUNCTION  3  brin_minmax_consistent(internal, internal, internal),
+    FUNCTION  4  brin_minmax_union(internal, internal, internal);
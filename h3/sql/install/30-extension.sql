@@ -27,3 +27,42 @@ CREATE OR REPLACE FUNCTION h3_pg_migrate_pass_by_reference(h3index) RETURNS h3in
     AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
     COMMENT ON FUNCTION h3_pg_migrate_pass_by_reference(h3index) IS
 'Migrate h3index from pass-by-reference to pass-by-value.';
+
+--| ## Execution statistics
+--|
+--| With `h3.track_stats` enabled, the heavier functions record how often they
+--| are called, how long they take, how many cells they produce or consume and
+--| how much memory a single call grows its memory context by. The GiST and
+--| SP-GiST support functions record call counts only. Statistics are shared
+--| between sessions when h3 is listed in `shared_preload_libraries`, otherwise
+--| each session only sees its own.
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION __h3_stat_functions(
+    OUT function text, OUT calls bigint,
+    OUT total_time double precision, OUT max_time double precision,
+    OUT cells bigint, OUT max_mem_growth_bytes bigint
+) RETURNS SETOF record
+    AS 'h3', 'h3_stat_functions' LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+--@ availability: unreleased
+CREATE OR REPLACE VIEW h3_stat_functions AS
+    SELECT * FROM __h3_stat_functions();
+COMMENT ON VIEW h3_stat_functions IS
+'Execution statistics collected while `h3.track_stats` is enabled: calls, total and maximum time in milliseconds, cells produced or consumed, and the largest memory growth of a single call in bytes. Index support functions (`h3index_gist_recheck` counts lossy GiST matches) only report calls.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION h3_stat_reset() RETURNS void
+    AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+COMMENT ON FUNCTION h3_stat_reset() IS
+'Discards all statistics reported by `h3_stat_functions`.';
+REVOKE ALL ON FUNCTION h3_stat_reset() FROM PUBLIC;
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION h3_cell_cache_stats(
+    OUT entries bigint, OUT capacity integer,
+    OUT hits bigint, OUT misses bigint, OUT evictions bigint
+) RETURNS record
+    AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+COMMENT ON FUNCTION h3_cell_cache_stats() IS
+'Size and hit/miss counters of the cell boundary and area cache of the current session, see `h3.cell_cache_size`.';
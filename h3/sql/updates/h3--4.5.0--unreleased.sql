@@ -17,3 +17,576 @@
 
 -- complain if script is sourced in psql, rather than via CREATE EXTENSION
 \echo Use "ALTER EXTENSION h3 UPDATE TO 'unreleased'" to load this file. \quit
+
+CREATE OR REPLACE FUNCTION __h3_stat_functions(
+    OUT function text, OUT calls bigint,
+    OUT total_time double precision, OUT max_time double precision,
+    OUT cells bigint, OUT max_mem_growth_bytes bigint
+) RETURNS SETOF record
+    AS 'h3', 'h3_stat_functions' LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+CREATE OR REPLACE VIEW h3_stat_functions AS
+    SELECT * FROM __h3_stat_functions();
+COMMENT ON VIEW h3_stat_functions IS
+'Execution statistics collected while `h3.track_stats` is enabled: calls, total and maximum time in milliseconds, cells produced or consumed, and the largest memory growth of a single call in bytes. Index support functions (`h3index_gist_recheck` counts lossy GiST matches) only report calls.';
+
+CREATE OR REPLACE FUNCTION h3_stat_reset() RETURNS void
+    AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+COMMENT ON FUNCTION h3_stat_reset() IS
+'Discards all statistics reported by `h3_stat_functions`.';
+REVOKE ALL ON FUNCTION h3_stat_reset() FROM PUBLIC;
+
+CREATE OR REPLACE FUNCTION h3_spgist_index_stats(
+    index regclass,
+    OUT level integer, OUT pages bigint, OUT inner_tuples bigint,
+    OUT leaf_tuples bigint, OUT avg_fanout double precision,
+    OUT avg_fill double precision, OUT null_prefixes double precision,
+    OUT resolutions bigint[]
+) RETURNS SETOF record
+    AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION h3_spgist_index_stats(regclass) IS
+'Describes the tree of an SP-GiST index using `h3index_ops_experimental`, one row per level starting at the root.
+`avg_fanout` is the number of child links per inner tuple, `null_prefixes` the share of inner tuples without a prefix
+and `resolutions` counts inner tuple prefixes per resolution 0 to 15.
+Sibling nodes partition the cells by base cell or digit, so unlike GiST they never overlap.';
+
+CREATE OR REPLACE FUNCTION h3_gist_index_stats(
+    index regclass,
+    OUT level integer, OUT pages bigint, OUT tuples bigint,
+    OUT avg_fanout double precision, OUT avg_fill double precision,
+    OUT null_keys double precision, OUT overlap double precision,
+    OUT resolutions bigint[]
+) RETURNS SETOF record
+    AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION h3_gist_index_stats(regclass) IS
+'Describes the tree of a GiST index using `h3index_gist_ops_experimental`, one row per level starting at the root.
+The number of rows is the depth of the tree. `null_keys` is the share of mixed-base union keys,
+`overlap` the share of sibling keys on internal pages where one contains the other (NULL for the leaf level),
+and `resolutions` counts keys per resolution 0 to 15.';
+
+CREATE OR REPLACE FUNCTION h3_cell_cache_stats(
+    OUT entries bigint, OUT capacity integer,
+    OUT hits bigint, OUT misses bigint, OUT evictions bigint
+) RETURNS record
+    AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+COMMENT ON FUNCTION h3_cell_cache_stats() IS
+'Size and hit/miss counters of the cell boundary and area cache of the current session, see `h3.cell_cache_size`.';
+
+CREATE OR REPLACE FUNCTION
+    h3_get_resolutions(cells h3index[]) RETURNS integer[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_get_resolutions(h3index[])
+IS 'Returns the resolution of every index in the array, as an array of the same shape. NULL elements stay NULL.';
+
+CREATE OR REPLACE FUNCTION
+    h3_validate_cells(cells h3index[]) RETURNS integer[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_validate_cells(h3index[])
+IS 'Returns the subscripts of all elements of a one-dimensional array that are not valid H3 cells, in ascending order. NULL elements are skipped. An empty result means every cell is valid.';
+
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_packed(cells h3index[], delta boolean DEFAULT FALSE) RETURNS bytea
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cells_to_packed(h3index[], boolean)
+IS 'Packs the cells into little-endian unsigned 64-bit integers, or LEB128 varint deltas when `delta` is true. The array must not contain NULLs.';
+
+CREATE OR REPLACE FUNCTION
+    h3_cells_from_packed(packed bytea, delta boolean DEFAULT FALSE) RETURNS h3index[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cells_from_packed(bytea, boolean)
+IS 'Unpacks cells written by `h3_cells_to_packed` with the same `delta` setting. The values are not validated.';
+
+
+CREATE TYPE h3cell;
+
+CREATE OR REPLACE FUNCTION
+    h3cell_in(cstring) RETURNS h3cell
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION
+    h3cell_out(h3cell) RETURNS cstring
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION
+    h3cell_recv(internal) RETURNS h3cell
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION
+    h3cell_send(h3cell) RETURNS bytea
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE h3cell (
+  INPUT          = h3cell_in,
+  OUTPUT         = h3cell_out,
+  RECEIVE        = h3cell_recv,
+  SEND           = h3cell_send,
+  INTERNALLENGTH = 5,
+  ALIGNMENT      = char,
+  STORAGE        = plain
+);
+
+CREATE OR REPLACE FUNCTION
+    h3cell_to_h3index(h3cell) RETURNS h3index
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE CAST (h3cell AS h3index) WITH FUNCTION h3cell_to_h3index(h3cell) AS IMPLICIT;
+COMMENT ON CAST (h3cell AS h3index) IS
+    'Convert compact cell to H3 index.';
+
+CREATE OR REPLACE FUNCTION
+    h3index_to_h3cell(h3index) RETURNS h3cell
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE CAST (h3index AS h3cell) WITH FUNCTION h3index_to_h3cell(h3index) AS ASSIGNMENT;
+COMMENT ON CAST (h3index AS h3cell) IS
+    'Convert H3 index to compact cell. Fails for invalid cells and cells finer than resolution 10.';
+
+-- ---------- ---------- ---------- ---------- ---------- ---------- ----------
+-- Comparison operators
+
+CREATE OR REPLACE FUNCTION h3cell_eq(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR = (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_eq,
+  COMMUTATOR = =,
+  NEGATOR = <>,
+  RESTRICT = eqsel,
+  JOIN = eqjoinsel,
+  HASHES, MERGES
+);
+
+CREATE OR REPLACE FUNCTION h3cell_ne(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR <> (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_ne,
+  COMMUTATOR = <>,
+  NEGATOR = =,
+  RESTRICT = neqsel,
+  JOIN = neqjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3cell_lt(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR < (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_lt,
+  COMMUTATOR = >,
+  NEGATOR = >=,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3cell_le(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR <= (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_le,
+  COMMUTATOR = >=,
+  NEGATOR = >,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3cell_gt(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR > (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_gt,
+  COMMUTATOR = <,
+  NEGATOR = <=,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3cell_ge(h3cell, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR >= (
+  LEFTARG = h3cell,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3cell_ge,
+  COMMUTATOR = <=,
+  NEGATOR = <,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3cell_h3index_eq(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR = (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_eq,
+  COMMUTATOR = =,
+  NEGATOR = <>,
+  RESTRICT = eqsel,
+  JOIN = eqjoinsel,
+  HASHES, MERGES
+);
+
+CREATE OR REPLACE FUNCTION h3cell_h3index_ne(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR <> (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_ne,
+  COMMUTATOR = <>,
+  NEGATOR = =,
+  RESTRICT = neqsel,
+  JOIN = neqjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3cell_h3index_lt(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR < (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_lt,
+  COMMUTATOR = >,
+  NEGATOR = >=,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3cell_h3index_le(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR <= (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_le,
+  COMMUTATOR = >=,
+  NEGATOR = >,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3cell_h3index_gt(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR > (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_gt,
+  COMMUTATOR = <,
+  NEGATOR = <=,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3cell_h3index_ge(h3cell, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR >= (
+  LEFTARG = h3cell,
+  RIGHTARG = h3index,
+  PROCEDURE = h3cell_h3index_ge,
+  COMMUTATOR = <=,
+  NEGATOR = <,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3index_h3cell_eq(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR = (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_eq,
+  COMMUTATOR = =,
+  NEGATOR = <>,
+  RESTRICT = eqsel,
+  JOIN = eqjoinsel,
+  HASHES, MERGES
+);
+
+CREATE OR REPLACE FUNCTION h3index_h3cell_ne(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR <> (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_ne,
+  COMMUTATOR = <>,
+  NEGATOR = =,
+  RESTRICT = neqsel,
+  JOIN = neqjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3index_h3cell_lt(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR < (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_lt,
+  COMMUTATOR = >,
+  NEGATOR = >=,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3index_h3cell_le(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR <= (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_le,
+  COMMUTATOR = >=,
+  NEGATOR = >,
+  RESTRICT = scalarltsel,
+  JOIN = scalarltjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3index_h3cell_gt(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR > (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_gt,
+  COMMUTATOR = <,
+  NEGATOR = <=,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+CREATE OR REPLACE FUNCTION h3index_h3cell_ge(h3index, h3cell) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR >= (
+  LEFTARG = h3index,
+  RIGHTARG = h3cell,
+  PROCEDURE = h3index_h3cell_ge,
+  COMMUTATOR = <=,
+  NEGATOR = <,
+  RESTRICT = scalargtsel,
+  JOIN = scalargtjoinsel
+);
+
+-- ---------- ---------- ---------- ---------- ---------- ---------- ----------
+-- Operator classes, sharing the families of h3index
+
+CREATE OR REPLACE FUNCTION h3cell_cmp(h3cell, h3cell) RETURNS integer
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3cell_h3index_cmp(h3cell, h3index) RETURNS integer
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_h3cell_cmp(h3index, h3cell) RETURNS integer
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3cell_sortsupport(internal) RETURNS void
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS h3cell_ops DEFAULT FOR TYPE h3cell USING btree FAMILY h3index_ops AS
+    OPERATOR  1  <  ,
+    OPERATOR  2  <= ,
+    OPERATOR  3   = ,
+    OPERATOR  4  >= ,
+    OPERATOR  5  >  ,
+    OPERATOR  1  <  (h3cell, h3index),
+    OPERATOR  2  <= (h3cell, h3index),
+    OPERATOR  3  =  (h3cell, h3index),
+    OPERATOR  4  >= (h3cell, h3index),
+    OPERATOR  5  >  (h3cell, h3index),
+    OPERATOR  1  <  (h3index, h3cell),
+    OPERATOR  2  <= (h3index, h3cell),
+    OPERATOR  3  =  (h3index, h3cell),
+    OPERATOR  4  >= (h3index, h3cell),
+    OPERATOR  5  >  (h3index, h3cell),
+    FUNCTION  1  h3cell_cmp(h3cell, h3cell),
+    FUNCTION  1  (h3cell, h3index) h3cell_h3index_cmp(h3cell, h3index),
+    FUNCTION  1  (h3index, h3cell) h3index_h3cell_cmp(h3index, h3cell),
+    FUNCTION  2  h3cell_sortsupport(internal);
+
+CREATE OR REPLACE FUNCTION h3cell_hash(h3cell) RETURNS integer
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3cell_hash_extended(h3cell, int8) RETURNS int8
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS h3cell_ops DEFAULT FOR TYPE h3cell USING hash FAMILY h3index_ops AS
+    OPERATOR  1   = ,
+    OPERATOR  1  = (h3cell, h3index),
+    OPERATOR  1  = (h3index, h3cell),
+    FUNCTION  1  h3cell_hash(h3cell),
+    FUNCTION  2  h3cell_hash_extended(h3cell, int8);
+
+CREATE OPERATOR CLASS h3cell_minmax_ops DEFAULT FOR TYPE h3cell USING brin FAMILY h3index_minmax_ops AS
+    OPERATOR  1  <  ,
+    OPERATOR  2  <= ,
+    OPERATOR  3   = ,
+    OPERATOR  4  >= ,
+    OPERATOR  5  >  ,
+    OPERATOR  1  <  (h3cell, h3index),
+    OPERATOR  2  <= (h3cell, h3index),
+    OPERATOR  3  =  (h3cell, h3index),
+    OPERATOR  4  >= (h3cell, h3index),
+    OPERATOR  5  >  (h3cell, h3index),
+    OPERATOR  1  <  (h3index, h3cell),
+    OPERATOR  2  <= (h3index, h3cell),
+    OPERATOR  3  =  (h3index, h3cell),
+    OPERATOR  4  >= (h3index, h3cell),
+    OPERATOR  5  >  (h3index, h3cell),
+    FUNCTION  1  brin_minmax_opcinfo(internal),
+    FUNCTION  2  brin_minmax_add_value(internal, internal, internal, internal),
+    FUNCTION  3  brin_minmax_consistent(internal, internal, internal),
+    FUNCTION  4  brin_minmax_union(internal, internal, internal);
+
+CREATE OR REPLACE FUNCTION
+    h3_polygon_to_cells_partition(exterior polygon, holes polygon[], resolution integer, part integer, nparts integer) RETURNS SETOF h3index
+AS 'h3' LANGUAGE C IMMUTABLE
+-- intentionally NOT STRICT
+CALLED ON NULL INPUT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_polygon_to_cells_partition(polygon, polygon[], integer, integer, integer)
+IS 'Returns part `part` (counting from 0) of `nparts` disjoint parts of `h3_polygon_to_cells`. Each part only fills a longitude strip of the polygon, so parts can be computed by parallel workers and their union is the full set of cells.';
+
+CREATE OR REPLACE FUNCTION
+    h3_region_prepare(exterior polygon, holes polygon[], resolution integer) RETURNS bytea
+AS 'h3' LANGUAGE C IMMUTABLE
+-- intentionally NOT STRICT
+CALLED ON NULL INPUT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_region_prepare(polygon, polygon[], integer)
+IS 'Prepares an exterior polygon [and a set of hole polygons] for `h3_region_contains`, using cells at the given resolution.';
+
+CREATE OR REPLACE FUNCTION
+    h3_region_contains(prepared bytea, latlng point) RETURNS boolean
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_region_contains(bytea, point)
+IS 'Returns true if the region prepared by `h3_region_prepare` contains the point.';
+
+CREATE OR REPLACE FUNCTION
+    h3_tile_to_cells(z integer, x integer, y integer, resolution integer, margin double precision DEFAULT 0) RETURNS SETOF h3index
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_tile_to_cells(integer, integer, integer, integer, double precision)
+IS 'Returns the cells overlapping the bounding box of Web Mercator XYZ tile, extended by `margin` times the tile size.
+
+Same as `h3_polygon_to_cells_experimental` of `ST_Transform(ST_TileEnvelope(z, x, y, margin => margin), 4326)` in `overlapping_bbox` mode, without building the geometry.';
+
+CREATE TYPE h3_rollup_stats AS (
+    res integer,
+    cell h3index,
+    count bigint,
+    sum double precision,
+    min double precision,
+    max double precision
+);
+
+CREATE OR REPLACE FUNCTION __h3_rollup_transfn(
+    state internal,
+    cell h3index,
+    value double precision,
+    min_res integer,
+    max_res integer)
+RETURNS internal
+AS 'h3', 'h3_rollup_transfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_rollup_combinefn(
+    state1 internal,
+    state2 internal)
+RETURNS internal
+AS 'h3', 'h3_rollup_combinefn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_rollup_serialfn(state internal)
+RETURNS bytea
+AS 'h3', 'h3_rollup_serialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_rollup_deserialfn(serialized bytea, state internal)
+RETURNS internal
+AS 'h3', 'h3_rollup_deserialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_rollup_finalfn(state internal)
+RETURNS h3_rollup_stats[]
+AS 'h3', 'h3_rollup_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE h3_rollup(cell h3index, value double precision, min_res integer, max_res integer) (
+    sfunc = __h3_rollup_transfn,
+    stype = internal,
+    finalfunc = __h3_rollup_finalfn,
+    combinefunc = __h3_rollup_combinefn,
+    serialfunc = __h3_rollup_serialfn,
+    deserialfunc = __h3_rollup_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_rollup(h3index, double precision, integer, integer) IS
+'Aggregates values into count, sum, min and max for the ancestors of the cells at every resolution from `min_res` to `max_res`, sorted by resolution and cell. Use as `SELECT (unnest(h3_rollup(h3, value, 3, 9))).*`.
+
+Cells finer than `max_res` are counted in their ancestor at `max_res`, cells coarser than `min_res` and rows with a NULL cell or value are skipped. The state holds one entry per distinct cell at `max_res` in memory and the result is a single array, limited to 1 GB: for large inputs group by a coarse parent, e.g. `GROUP BY h3_cell_to_parent(h3, 3)`, to keep each group small.';
+
+CREATE TYPE h3_bin_count AS (
+    cell h3index,
+    count bigint
+);
+
+CREATE OR REPLACE FUNCTION __h3_bin_points_transfn(
+    state internal,
+    latlng point,
+    resolution integer)
+RETURNS internal
+AS 'h3', 'h3_bin_points_transfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_bin_points_combinefn(
+    state1 internal,
+    state2 internal)
+RETURNS internal
+AS 'h3', 'h3_bin_points_combinefn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_bin_points_serialfn(state internal)
+RETURNS bytea
+AS 'h3', 'h3_bin_points_serialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_bin_points_deserialfn(serialized bytea, state internal)
+RETURNS internal
+AS 'h3', 'h3_bin_points_deserialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_bin_points_finalfn(state internal)
+RETURNS h3_bin_count[]
+AS 'h3', 'h3_bin_points_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE h3_bin_points_agg(latlng point, resolution integer) (
+    sfunc = __h3_bin_points_transfn,
+    stype = internal,
+    finalfunc = __h3_bin_points_finalfn,
+    combinefunc = __h3_bin_points_combinefn,
+    serialfunc = __h3_bin_points_serialfn,
+    deserialfunc = __h3_bin_points_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_bin_points_agg(point, integer) IS
+'Counts the points in each cell at the specified resolution, in h3index order. Use as `SELECT (unnest(h3_bin_points_agg(latlng, 9))).*`.
+
+Same as `SELECT h3_latlng_to_cell(latlng, 9), COUNT(*) ... GROUP BY 1`, but each worker of a parallel plan counts into its own hash table keyed by the cell, so only one row per distinct cell leaves it. NULL points are skipped.';
+
+CREATE OR REPLACE FUNCTION
+    h3_grid_disk_convolve(cells h3index[], cell_values double precision[], k integer DEFAULT 1, kernel text DEFAULT 'uniform', OUT cell h3index, OUT value double precision) RETURNS SETOF record
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_grid_disk_convolve(h3index[], double precision[], integer, text)
+IS 'Smooths values given per cell: returns, for every cell within k grid steps of an input cell, the sum of the input values around it weighted by their grid distance, in h3index order.
+
+Kernel `uniform` weights all distances by 1, `linear` by `1 - distance / (k + 1)`. Same as `SELECT d.index, SUM(weight * value) ... h3_grid_disk_distances(cell, k) d GROUP BY 1`, without producing a row per disk cell.';
+
+CREATE TYPE h3_grid_radius AS (
+    origin h3index,
+    k integer
+);
+
+CREATE OR REPLACE FUNCTION h3index_within_radius(h3index, h3_grid_radius) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3_grid_radius_contains(h3_grid_radius, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR <@ (
+    PROCEDURE = h3index_within_radius,
+    LEFTARG = h3index, RIGHTARG = h3_grid_radius,
+    COMMUTATOR = @>,
+    RESTRICT = contsel, JOIN = contjoinsel
+);
+COMMENT ON OPERATOR <@ (h3index, h3_grid_radius) IS
+  'Returns true if A is at most k grid steps from the origin, as measured by `<->`: `hex <@ (origin, k)::h3_grid_radius` is `hex <-> origin <= k`, but can use GiST and SP-GiST indexes.';
+CREATE OPERATOR @> (
+    PROCEDURE = h3_grid_radius_contains,
+    LEFTARG = h3_grid_radius, RIGHTARG = h3index,
+    COMMUTATOR = <@,
+    RESTRICT = contsel, JOIN = contjoinsel
+);
+COMMENT ON OPERATOR @> (h3_grid_radius, h3index) IS
+  'Returns true if B is at most k grid steps from the origin.';
+
+ALTER OPERATOR FAMILY h3index_ops_experimental USING spgist ADD
+    OPERATOR  31  <@ (h3index, h3_grid_radius);  -- H3_GRID_RADIUS_STRATEGY
+
+ALTER OPERATOR FAMILY h3index_gist_ops_experimental USING gist ADD
+    OPERATOR  31  <@ (h3index, h3_grid_radius);  -- H3_GRID_RADIUS_STRATEGY
@@ -0,0 +1,675 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <access/htup_details.h> // heap_form_tuple
+#include <fmgr.h>				 // PG_FUNCTION_ARGS
+#include <funcapi.h>			 // HeapTupleGetDatum
+#include <libpq/pqformat.h>		 // pq_sendint64
+#include <utils/array.h>		 // construct_array
+#include <utils/geo_decls.h>	 // PG_GETARG_POINT_P
+#include <utils/lsyscache.h>	 // get_element_type
+#include <utils/typcache.h>		 // lookup_rowtype_tupdesc
+#include <math.h>
+
+#include "cell_bits.h"
+#include "error.h"
+#include "guc.h"
+#include "type.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_rollup_transfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_rollup_combinefn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_rollup_serialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_rollup_deserialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_rollup_finalfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_bin_points_transfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_bin_points_combinefn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_bin_points_serialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_bin_points_deserialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_bin_points_finalfn);
+
+/* Attributes of h3_rollup_stats */
+#define ROLLUP_STATS_NATTS 6
+
+/* Attributes of h3_bin_count */
+#define BIN_COUNT_NATTS 2
+
+#define AGG_ASSERT_CONTEXT(fcinfo, aggcontext)				\
+	ASSERT(													\
+		AggCheckCallContext(fcinfo, aggcontext),			\
+		ERRCODE_FEATURE_NOT_SUPPORTED,						\
+		"Function called in non-aggregate context")
+
+/* Running statistics of the values of one cell */
+typedef struct
+{
+	H3Index		cell;
+	char		status;			/* used by simplehash */
+	int64		count;
+	double		sum;
+	double		min;
+	double		max;
+}			RollupEntry;
+
+#define SH_PREFIX rollup
+#define SH_ELEMENT_TYPE RollupEntry
+#define SH_KEY_TYPE H3Index
+#define SH_KEY cell
+#define SH_HASH_KEY(tb, key) h3index_hash32(key)
+#define SH_EQUAL(tb, a, b) ((a) == (b))
+#define SH_SCOPE static inline
+#define SH_DECLARE
+#define SH_DEFINE
+#include <lib/simplehash.h>
+
+/*
+ * State of h3_rollup: statistics of the input cells at maxRes, or at their
+ * own resolution when they are coarser. The coarser levels are only derived
+ * by the final function, from these.
+ */
+typedef struct
+{
+	int			minRes;
+	int			maxRes;
+	rollup_hash *cells;
+}			RollupState;
+
+static MemoryContext
+agg_context(FunctionCallInfo fcinfo)
+{
+	MemoryContext aggcontext;
+
+	AGG_ASSERT_CONTEXT(fcinfo, &aggcontext);
+	return aggcontext;
+}
+
+static RollupState *
+rollup_state_create(MemoryContext context, int minRes, int maxRes)
+{
+	RollupState *state = MemoryContextAlloc(context, sizeof(RollupState));
+
+	state->minRes = minRes;
+	state->maxRes = maxRes;
+	state->cells = rollup_create(context, 1024, NULL);
+	return state;
+}
+
+/* Merges statistics into the entry of a cell. */
+static void
+rollup_add(RollupState * state, H3Index cell, int64 count, double sum, double min, double max)
+{
+	bool		found;
+	RollupEntry *entry = rollup_insert(state->cells, cell, &found);
+
+	if (!found)
+	{
+		entry->count = count;
+		entry->sum = sum;
+		entry->min = min;
+		entry->max = max;
+		return;
+	}
+	entry->count += count;
+	entry->sum += sum;
+	entry->min = fmin(entry->min, min);
+	entry->max = fmax(entry->max, max);
+}
+
+/* Orders cells by resolution, then in h3index order. */
+static int
+rollup_entry_cmp(const void *a, const void *b)
+{
+	H3Index		cellA = ((const RollupEntry *) a)->cell;
+	H3Index		cellB = ((const RollupEntry *) b)->cell;
+	int			resA = h3index_res(cellA);
+	int			resB = h3index_res(cellB);
+
+	if (resA != resB)
+		return resA < resB ? -1 : 1;
+	return cellA < cellB ? -1 : cellA > cellB;
+}
+
+/*
+ * Transition function of h3_rollup.
+ *
+ * Rows with a NULL cell or value are skipped.
+ */
+Datum
+h3_rollup_transfn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext = agg_context(fcinfo);
+	RollupState *state;
+	H3Index		cell;
+	double		value;
+	int			minRes;
+	int			maxRes;
+	int			res;
+
+	state = PG_ARGISNULL(0) ? NULL : (RollupState *) PG_GETARG_POINTER(0);
+
+	if (PG_ARGISNULL(1) || PG_ARGISNULL(2))
+	{
+		if (state == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state);
+	}
+
+	ASSERT(!PG_ARGISNULL(3) && !PG_ARGISNULL(4), ERRCODE_NULL_VALUE_NOT_ALLOWED,
+		   "min_res and max_res must not be NULL");
+	minRes = PG_GETARG_INT32(3);
+	maxRes = PG_GETARG_INT32(4);
+
+	if (state == NULL)
+	{
+		if (minRes < 0 || maxRes > MAX_H3_RES)
+			h3_assert(E_RES_DOMAIN);
+		ASSERT(minRes <= maxRes, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "min_res (%d) must not exceed max_res (%d)", minRes, maxRes);
+		state = rollup_state_create(aggcontext, minRes, maxRes);
+	}
+	else
+		ASSERT(minRes == state->minRes && maxRes == state->maxRes,
+			   ERRCODE_INVALID_PARAMETER_VALUE,
+			   "min_res and max_res must be the same for all rows of a group");
+
+	cell = PG_GETARG_H3INDEX(1);
+	value = PG_GETARG_FLOAT8(2);
+	res = h3index_res(cell);
+	if (res > maxRes)
+		cell = h3index_cell_to_parent_fast(cell, maxRes);
+
+	/* cells coarser than min_res have no ancestors to report */
+	if (res >= minRes)
+		rollup_add(state, cell, 1, value, value, value);
+
+	PG_RETURN_POINTER(state);
+}
+
+/* Combine function of h3_rollup. */
+Datum
+h3_rollup_combinefn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext = agg_context(fcinfo);
+	RollupState *state1;
+	RollupState *state2;
+	rollup_iterator iterator;
+	RollupEntry *entry;
+
+	state1 = PG_ARGISNULL(0) ? NULL : (RollupState *) PG_GETARG_POINTER(0);
+	state2 = PG_ARGISNULL(1) ? NULL : (RollupState *) PG_GETARG_POINTER(1);
+
+	if (state2 == NULL)
+	{
+		if (state1 == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state1);
+	}
+
+	if (state1 == NULL)
+		state1 = rollup_state_create(aggcontext, state2->minRes, state2->maxRes);
+	else
+		ASSERT(state1->minRes == state2->minRes && state1->maxRes == state2->maxRes,
+			   ERRCODE_INVALID_PARAMETER_VALUE,
+			   "min_res and max_res must be the same for all rows of a group");
+
+	rollup_start_iterate(state2->cells, &iterator);
+	while ((entry = rollup_iterate(state2->cells, &iterator)) != NULL)
+		rollup_add(state1, entry->cell, entry->count, entry->sum, entry->min, entry->max);
+
+	PG_RETURN_POINTER(state1);
+}
+
+/* Serialization function of h3_rollup. */
+Datum
+h3_rollup_serialfn(PG_FUNCTION_ARGS)
+{
+	RollupState *state;
+	StringInfoData buf;
+	rollup_iterator iterator;
+	RollupEntry *entry;
+
+	agg_context(fcinfo);
+	state = (RollupState *) PG_GETARG_POINTER(0);
+
+	pq_begintypsend(&buf);
+	pq_sendint32(&buf, state->minRes);
+	pq_sendint32(&buf, state->maxRes);
+	pq_sendint32(&buf, state->cells->members);
+
+	rollup_start_iterate(state->cells, &iterator);
+	while ((entry = rollup_iterate(state->cells, &iterator)) != NULL)
+	{
+		pq_sendint64(&buf, entry->cell);
+		pq_sendint64(&buf, entry->count);
+		pq_sendfloat8(&buf, entry->sum);
+		pq_sendfloat8(&buf, entry->min);
+		pq_sendfloat8(&buf, entry->max);
+	}
+
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+/* Deserialization function of h3_rollup. */
+Datum
+h3_rollup_deserialfn(PG_FUNCTION_ARGS)
+{
+	bytea	   *serialized;
+	RollupState *state;
+	StringInfoData buf;
+	int			minRes;
+	int			maxRes;
+	int			count;
+
+	agg_context(fcinfo);
+	serialized = PG_GETARG_BYTEA_PP(0);
+
+	initStringInfo(&buf);
+	appendBinaryStringInfo(&buf, VARDATA_ANY(serialized),
+						   VARSIZE_ANY_EXHDR(serialized));
+
+	minRes = pq_getmsgint(&buf, 4);
+	maxRes = pq_getmsgint(&buf, 4);
+	count = pq_getmsgint(&buf, 4);
+	state = rollup_state_create(CurrentMemoryContext, minRes, maxRes);
+
+	for (int i = 0; i < count; i++)
+	{
+		H3Index		cell = pq_getmsgint64(&buf);
+		int64		cellCount = pq_getmsgint64(&buf);
+		double		sum = pq_getmsgfloat8(&buf);
+		double		min = pq_getmsgfloat8(&buf);
+		double		max = pq_getmsgfloat8(&buf);
+
+		rollup_add(state, cell, cellCount, sum, min, max);
+	}
+	pq_getmsgend(&buf);
+
+	PG_RETURN_POINTER(state);
+}
+
+/*
+ * Merges the sorted rows of one level into the sorted rows of their parents
+ * at res, together with the sorted input cells of that resolution. Children
+ * of one parent are adjacent in h3index order, so this is a linear pass.
+ */
+static int
+rollup_level_up(const RollupEntry * children, int numChildren,
+				const RollupEntry * inputs, int numInputs,
+				int res, RollupEntry * parents)
+{
+	int			numParents = 0;
+	int			i = 0;
+	int			j = 0;
+
+	while (i < numChildren || j < numInputs)
+	{
+		RollupEntry next;
+		RollupEntry *last = numParents > 0 ? &parents[numParents - 1] : NULL;
+
+		if (j >= numInputs
+			|| (i < numChildren
+				&& h3index_cell_to_parent_fast(children[i].cell, res) < inputs[j].cell))
+		{
+			next = children[i++];
+			next.cell = h3index_cell_to_parent_fast(next.cell, res);
+		}
+		else
+			next = inputs[j++];
+
+		if (last != NULL && last->cell == next.cell)
+		{
+			last->count += next.count;
+			last->sum += next.sum;
+			last->min = fmin(last->min, next.min);
+			last->max = fmax(last->max, next.max);
+		}
+		else
+			parents[numParents++] = next;
+	}
+	return numParents;
+}
+
+/*
+ * Final function of h3_rollup.
+ *
+ * The cells of the state are sorted once, then each coarser level is derived
+ * from the one below it. Distinct cells are touched once per level rather
+ * than once per input row. The state and every output row are held in
+ * memory, and the result array is limited to 1 GB like any other array.
+ */
+Datum
+h3_rollup_finalfn(PG_FUNCTION_ARGS)
+{
+	RollupState *state;
+	RollupEntry *inputs;
+	RollupEntry *levels[MAX_H3_RES + 1];
+	int			levelSizes[MAX_H3_RES + 1];
+	int			inputStarts[MAX_H3_RES + 2] = {0};
+	int			numInputs = 0;
+	int			numRows = 0;
+	rollup_iterator iterator;
+	RollupEntry *entry;
+	Oid			elemType;
+	TupleDesc	tupdesc;
+	Datum	   *elems;
+	int16		elemLen;
+	bool		elemByVal;
+	char		elemAlign;
+
+	agg_context(fcinfo);
+	state = (RollupState *) PG_GETARG_POINTER(0);
+
+	inputs = palloc_extended(sizeof(RollupEntry) * state->cells->members, MCXT_ALLOC_HUGE);
+	rollup_start_iterate(state->cells, &iterator);
+	while ((entry = rollup_iterate(state->cells, &iterator)) != NULL)
+	{
+		inputs[numInputs++] = *entry;
+		inputStarts[h3index_res(entry->cell) + 1]++;
+	}
+	qsort(inputs, numInputs, sizeof(RollupEntry), rollup_entry_cmp);
+	for (int res = 0; res <= MAX_H3_RES; res++)
+		inputStarts[res + 1] += inputStarts[res];
+
+	/* the state holds no cells finer than max_res */
+	levels[state->maxRes] = &inputs[inputStarts[state->maxRes]];
+	levelSizes[state->maxRes] = inputStarts[state->maxRes + 1] - inputStarts[state->maxRes];
+	numRows = levelSizes[state->maxRes];
+	for (int res = state->maxRes - 1; res >= state->minRes; res--)
+	{
+		int			numLevelInputs = inputStarts[res + 1] - inputStarts[res];
+
+		levels[res] = palloc_extended(sizeof(RollupEntry) * (levelSizes[res + 1] + numLevelInputs),
+									 MCXT_ALLOC_HUGE);
+		levelSizes[res] = rollup_level_up(levels[res + 1], levelSizes[res + 1],
+										  &inputs[inputStarts[res]], numLevelInputs,
+										  res, levels[res]);
+		numRows += levelSizes[res];
+	}
+
+	elemType = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+	tupdesc = lookup_rowtype_tupdesc_copy(elemType, -1);
+	get_typlenbyvalalign(elemType, &elemLen, &elemByVal, &elemAlign);
+
+	elems = palloc_extended(sizeof(Datum) * numRows, MCXT_ALLOC_HUGE);
+	numRows = 0;
+	for (int res = state->minRes; res <= state->maxRes; res++)
+	{
+		for (int i = 0; i < levelSizes[res]; i++)
+		{
+			const RollupEntry *row = &levels[res][i];
+			Datum		values[ROLLUP_STATS_NATTS];
+			bool		nulls[ROLLUP_STATS_NATTS] = {0};
+
+			values[0] = Int32GetDatum(res);
+			values[1] = H3IndexGetDatum(row->cell);
+			values[2] = Int64GetDatum(row->count);
+			values[3] = Float8GetDatum(row->sum);
+			values[4] = Float8GetDatum(row->min);
+			values[5] = Float8GetDatum(row->max);
+			elems[numRows++] = HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls));
+		}
+	}
+
+	PG_RETURN_ARRAYTYPE_P(construct_array(elems, numRows, elemType,
+										  elemLen, elemByVal, elemAlign));
+}
+
+/* Number of points in one cell */
+typedef struct
+{
+	H3Index		cell;
+	char		status;			/* used by simplehash */
+	int64		count;
+}			BinEntry;
+
+#define SH_PREFIX bin
+#define SH_ELEMENT_TYPE BinEntry
+#define SH_KEY_TYPE H3Index
+#define SH_KEY cell
+#define SH_HASH_KEY(tb, key) h3index_hash32(key)
+#define SH_EQUAL(tb, a, b) ((a) == (b))
+#define SH_SCOPE static inline
+#define SH_DECLARE
+#define SH_DEFINE
+#include <lib/simplehash.h>
+
+/* State of h3_bin_points_agg: point counts of the cells seen so far */
+typedef struct
+{
+	int			resolution;
+	bin_hash   *cells;
+}			BinState;
+
+static BinState *
+bin_state_create(MemoryContext context, int resolution)
+{
+	BinState   *state = MemoryContextAlloc(context, sizeof(BinState));
+
+	state->resolution = resolution;
+	state->cells = bin_create(context, 1024, NULL);
+	return state;
+}
+
+static void
+bin_add(BinState * state, H3Index cell, int64 count)
+{
+	bool		found;
+	BinEntry   *entry = bin_insert(state->cells, cell, &found);
+
+	entry->count = found ? entry->count + count : count;
+}
+
+static int
+bin_entry_cmp(const void *a, const void *b)
+{
+	H3Index		cellA = ((const BinEntry *) a)->cell;
+	H3Index		cellB = ((const BinEntry *) b)->cell;
+
+	return cellA < cellB ? -1 : cellA > cellB;
+}
+
+/*
+ * Transition function of h3_bin_points_agg.
+ *
+ * Points are indexed and counted right away, so the cell of each row is
+ * never materialized. NULL points are skipped.
+ */
+Datum
+h3_bin_points_transfn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext = agg_context(fcinfo);
+	BinState   *state;
+	Point	   *point;
+	int			resolution;
+	LatLng		location;
+	H3Index		cell;
+
+	state = PG_ARGISNULL(0) ? NULL : (BinState *) PG_GETARG_POINTER(0);
+
+	if (PG_ARGISNULL(1))
+	{
+		if (state == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state);
+	}
+
+	ASSERT(!PG_ARGISNULL(2), ERRCODE_NULL_VALUE_NOT_ALLOWED,
+		   "resolution must not be NULL");
+	resolution = PG_GETARG_INT32(2);
+
+	if (state == NULL)
+	{
+		if (resolution < 0 || resolution > MAX_H3_RES)
+			h3_assert(E_RES_DOMAIN);
+		state = bin_state_create(aggcontext, resolution);
+	}
+	else
+		ASSERT(resolution == state->resolution, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "resolution must be the same for all rows of a group");
+
+	point = PG_GETARG_POINT_P(1);
+	if (h3_guc_strict)
+	{
+		ASSERT(point->x >= -180 && point->x <= 180, ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE,
+			   "Longitude must be between -180 and 180 degrees inclusive, but got %f.",
+			   point->x);
+		ASSERT(point->y >= -90 && point->y <= 90, ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE,
+			   "Latitude must be between -90 and 90 degrees inclusive, but got %f.",
+			   point->y);
+	}
+
+	location.lng = degsToRads(point->x);
+	location.lat = degsToRads(point->y);
+	h3_assert(latLngToCell(&location, resolution, &cell));
+	bin_add(state, cell, 1);
+
+	PG_RETURN_POINTER(state);
+}
+
+/* Combine function of h3_bin_points_agg. */
+Datum
+h3_bin_points_combinefn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext = agg_context(fcinfo);
+	BinState   *state1;
+	BinState   *state2;
+	bin_iterator iterator;
+	BinEntry   *entry;
+
+	state1 = PG_ARGISNULL(0) ? NULL : (BinState *) PG_GETARG_POINTER(0);
+	state2 = PG_ARGISNULL(1) ? NULL : (BinState *) PG_GETARG_POINTER(1);
+
+	if (state2 == NULL)
+	{
+		if (state1 == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state1);
+	}
+
+	if (state1 == NULL)
+		state1 = bin_state_create(aggcontext, state2->resolution);
+
+	bin_start_iterate(state2->cells, &iterator);
+	while ((entry = bin_iterate(state2->cells, &iterator)) != NULL)
+		bin_add(state1, entry->cell, entry->count);
+
+	PG_RETURN_POINTER(state1);
+}
+
+/* Serialization function of h3_bin_points_agg. */
+Datum
+h3_bin_points_serialfn(PG_FUNCTION_ARGS)
+{
+	BinState   *state;
+	StringInfoData buf;
+	bin_iterator iterator;
+	BinEntry   *entry;
+
+	agg_context(fcinfo);
+	state = (BinState *) PG_GETARG_POINTER(0);
+
+	pq_begintypsend(&buf);
+	pq_sendint32(&buf, state->resolution);
+	pq_sendint32(&buf, state->cells->members);
+
+	bin_start_iterate(state->cells, &iterator);
+	while ((entry = bin_iterate(state->cells, &iterator)) != NULL)
+	{
+		pq_sendint64(&buf, entry->cell);
+		pq_sendint64(&buf, entry->count);
+	}
+
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+/* Deserialization function of h3_bin_points_agg. */
+Datum
+h3_bin_points_deserialfn(PG_FUNCTION_ARGS)
+{
+	bytea	   *serialized;
+	BinState   *state;
+	StringInfoData buf;
+	int			resolution;
+	int			count;
+
+	agg_context(fcinfo);
+	serialized = PG_GETARG_BYTEA_PP(0);
+
+	initStringInfo(&buf);
+	appendBinaryStringInfo(&buf, VARDATA_ANY(serialized),
+						   VARSIZE_ANY_EXHDR(serialized));
+
+	resolution = pq_getmsgint(&buf, 4);
+	count = pq_getmsgint(&buf, 4);
+	state = bin_state_create(CurrentMemoryContext, resolution);
+
+	for (int i = 0; i < count; i++)
+	{
+		H3Index		cell = pq_getmsgint64(&buf);
+		int64		cellCount = pq_getmsgint64(&buf);
+
+		bin_add(state, cell, cellCount);
+	}
+	pq_getmsgend(&buf);
+
+	PG_RETURN_POINTER(state);
+}
+
+/* Final function of h3_bin_points_agg: the counts in h3index order. */
+Datum
+h3_bin_points_finalfn(PG_FUNCTION_ARGS)
+{
+	BinState   *state;
+	BinEntry   *bins;
+	int			numBins = 0;
+	bin_iterator iterator;
+	BinEntry   *entry;
+	Oid			elemType;
+	TupleDesc	tupdesc;
+	Datum	   *elems;
+	int16		elemLen;
+	bool		elemByVal;
+	char		elemAlign;
+
+	agg_context(fcinfo);
+	state = (BinState *) PG_GETARG_POINTER(0);
+
+	bins = palloc_extended(sizeof(BinEntry) * state->cells->members, MCXT_ALLOC_HUGE);
+	bin_start_iterate(state->cells, &iterator);
+	while ((entry = bin_iterate(state->cells, &iterator)) != NULL)
+		bins[numBins++] = *entry;
+	qsort(bins, numBins, sizeof(BinEntry), bin_entry_cmp);
+
+	elemType = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+	tupdesc = lookup_rowtype_tupdesc_copy(elemType, -1);
+	get_typlenbyvalalign(elemType, &elemLen, &elemByVal, &elemAlign);
+
+	elems = palloc_extended(sizeof(Datum) * numBins, MCXT_ALLOC_HUGE);
+	for (int i = 0; i < numBins; i++)
+	{
+		Datum		values[BIN_COUNT_NATTS];
+		bool		nulls[BIN_COUNT_NATTS] = {0};
+
+		values[0] = H3IndexGetDatum(bins[i].cell);
+		values[1] = Int64GetDatum(bins[i].count);
+		elems[i] = HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls));
+	}
+
+	PG_RETURN_ARRAYTYPE_P(construct_array(elems, numBins, elemType,
+										  elemLen, elemByVal, elemAlign));
+}
@@ -21,33 +21,7 @@
 
 #include <h3api.h>
 #include "algos.h"
-#include "upstream_macros.h"
-
-/* Low 45 bits holding all 15 encoded H3 index digits. */
-#define H3_INDEX_DIGITS_MASK UINT64_C(0x1fffffffffff)
-
-/*
- * Compare only the index digits that participate in the shared-resolution
- * prefix, ignoring deeper child digits from the finer input.
- */
-static inline uint64
-h3index_prefix_digit_diff(H3Index a, H3Index b, int sharedRes)
-{
-	int			ignoredBits = (MAX_H3_RES - sharedRes) * H3_PER_DIGIT_OFFSET;
-
-	return ((((uint64) (a ^ b)) & H3_INDEX_DIGITS_MASK) >> ignoredBits);
-}
-
-/*
- * Bitwise equivalent of upstream cellToParent for already-validated input.
- * The H3 encoding fills child digits beyond the new resolution with 7.
- */
-static inline H3Index
-h3index_cell_to_parent_fast(H3Index h, int parentRes)
-{
-	H3_SET_RESOLUTION(h, parentRes);
-	return h | (H3_INDEX_DIGITS_MASK >> (parentRes * H3_PER_DIGIT_OFFSET));
-}
+#include "cell_bits.h"
 
 H3Index
 finest_common_ancestor(H3Index a, H3Index b)
@@ -60,12 +34,12 @@ finest_common_ancestor(H3Index a, H3Index b)
 		return a;
 
 	/* do not even share the basecell */
-	if (getBaseCellNumber(a) != getBaseCellNumber(b))
+	if (h3index_base_cell(a) != h3index_base_cell(b))
 		return H3_NULL;
 
 	{
-		int			aRes = getResolution(a);
-		int			bRes = getResolution(b);
+		int			aRes = h3index_res(a);
+		int			bRes = h3index_res(b);
 		int			coarsestRes = (aRes < bRes) ? aRes : bRes;
 		uint64		digitDiff = h3index_prefix_digit_diff(a, b, coarsestRes);
 
@@ -21,9 +21,11 @@
 #include <funcapi.h>	 // SRF_IS_FIRSTCALL
 #include <utils/array.h> // ArrayType
 
+#include "cell_bits.h"
 #include "error.h"
 #include "type.h"
 #include "srf.h"
+#include "stats.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_parent);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_children);
@@ -45,13 +47,12 @@ typedef struct
 Datum
 h3_cell_to_parent(PG_FUNCTION_ARGS)
 {
-	H3Index		parent;
 	H3Index		origin = PG_GETARG_H3INDEX(0);
 	int			resolution = PG_GETARG_OPTIONAL_RES(1, origin, -1);
 
-	h3_assert(cellToParent(origin, resolution, &parent));
+	h3_assert(h3index_cell_to_parent_error(origin, resolution));
 
-	PG_RETURN_H3INDEX(parent);
+	PG_RETURN_H3INDEX(h3index_cell_to_parent_fast(origin, resolution));
 }
 
 /* Returns children indexes at given resolution (or next resolution if none given) */
@@ -107,13 +108,12 @@ h3_cell_to_children(PG_FUNCTION_ARGS)
 Datum
 h3_cell_to_center_child(PG_FUNCTION_ARGS)
 {
-	H3Index		child;
 	H3Index		origin = PG_GETARG_H3INDEX(0);
 	int			resolution = PG_GETARG_OPTIONAL_RES(1, origin, 1);
 
-	h3_assert(cellToCenterChild(origin, resolution, &child));
+	h3_assert(h3index_cell_to_center_child_error(origin, resolution));
 
-	PG_RETURN_H3INDEX(child);
+	PG_RETURN_H3INDEX(h3index_cell_to_center_child_fast(origin, resolution));
 }
 
 Datum
@@ -122,8 +122,14 @@ h3_cell_to_child_pos(PG_FUNCTION_ARGS)
 	H3Index		child = PG_GETARG_H3INDEX(0);
 	int			parentRes = PG_GETARG_INT32(1);
 	int64_t		childPos;
+	H3Error		error;
 
-	h3_assert(cellToChildPos(child, parentRes, &childPos));
+	h3_assert(h3index_cell_to_parent_error(child, parentRes));
+
+	if (h3index_cell_to_child_pos_fast(child, parentRes, &childPos, &error))
+		h3_assert(error);
+	else
+		h3_assert(cellToChildPos(child, parentRes, &childPos));
 
 	PG_RETURN_INT64(childPos);
 }
@@ -159,6 +165,9 @@ h3_compact_cells(PG_FUNCTION_ARGS)
 		ArrayIterator iterator = array_create_iterator(array, 0, NULL);
 		H3Index    *h3set = palloc(max * sizeof(H3Index));
 		H3Index    *compactedSet = palloc0(max * sizeof(H3Index));
+		H3StatTimer timer;
+
+		h3_stats_begin(&timer);
 
 		/* Extract data from array into h3set, and wipe compactedSet memory */
 		while (array_iterate(iterator, &value, &isnull))
@@ -170,6 +179,7 @@ h3_compact_cells(PG_FUNCTION_ARGS)
 
 		if (max > 0)
 			h3_assert(compactCells(h3set, compactedSet, max));
+		h3_stats_end_cells(&timer, H3_STAT_COMPACT_CELLS, compactedSet, max);
 
 		funcctx->user_fctx = compactedSet;
 		funcctx->max_calls = max;
@@ -200,6 +210,9 @@ h3_uncompact_cells(PG_FUNCTION_ARGS)
 		int			numCompacted = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
 		ArrayIterator iterator = array_create_iterator(array, 0, NULL);
 		H3Index    *compactedSet = palloc(numCompacted * sizeof(H3Index));
+		H3StatTimer timer;
+
+		h3_stats_begin(&timer);
 
 		/*
 		 * Extract data from array into compactedSet, and wipe compactedSet
@@ -247,6 +260,7 @@ h3_uncompact_cells(PG_FUNCTION_ARGS)
 
 		if (numCompacted > 0)
 			h3_assert(uncompactCells(compactedSet, numCompacted, uncompactedSet, max, resolution));
+		h3_stats_end(&timer, H3_STAT_UNCOMPACT_CELLS, max);
 
 		funcctx->user_fctx = uncompactedSet;
 		funcctx->max_calls = max;
@@ -26,11 +26,13 @@
 #include <utils/geo_decls.h> // PG_GETARG_POINT_P
 #include <math.h> // fabs
 
+#include "cell_cache.h"
 #include "constants.h"
 #include "error.h"
 #include "polygon.h"
 #include "type.h"
 #include "guc.h"
+#include "stats.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_latlng_to_cell);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_latlng);
@@ -44,6 +46,9 @@ h3_latlng_to_cell(PG_FUNCTION_ARGS)
 	LatLng		location;
 	Point	   *point = PG_GETARG_POINT_P(0);
 	int			resolution = PG_GETARG_INT32(1);
+	H3StatTimer timer;
+
+	h3_stats_begin(&timer);
 
 	if (h3_guc_strict)
 	{
@@ -65,6 +70,7 @@ h3_latlng_to_cell(PG_FUNCTION_ARGS)
 	location.lat = degsToRads(point->y);
 
 	h3_assert(latLngToCell(&location, resolution, &cell));
+	h3_stats_end(&timer, H3_STAT_LATLNG_TO_CELL, 1);
 
 	PG_FREE_IF_COPY(point, 0);
 	PG_RETURN_H3INDEX(cell);
@@ -99,6 +105,7 @@ h3_cell_to_boundary(PG_FUNCTION_ARGS)
 	int			size;
 	POLYGON    *polygon;
 	CellBoundary boundary;
+	H3StatTimer timer;
 
 	/* DEPRECATION BEGIN: Remove next major */
 	bool		extend;
@@ -114,7 +121,9 @@ h3_cell_to_boundary(PG_FUNCTION_ARGS)
 	}
 	/* DEPRECATION END */
 
-	h3_assert(cellToBoundary(cell, &boundary));
+	h3_stats_begin(&timer);
+
+	h3_assert(h3_cell_to_boundary_cached(cell, &boundary));
 
 	size = offsetof(POLYGON, p) +sizeof(polygon->p[0]) * boundary.numVerts;
 	polygon = (POLYGON *) palloc0(size);
@@ -145,5 +154,7 @@ h3_cell_to_boundary(PG_FUNCTION_ARGS)
 	}
 	h3_polygon_init_boundbox(polygon);
 
+	h3_stats_end(&timer, H3_STAT_CELL_TO_BOUNDARY, 1);
+
 	PG_RETURN_POLYGON_P(polygon);
 }
@@ -18,10 +18,12 @@
 #include <h3api.h>
 
 #include <fmgr.h>			 // PG_FUNCTION_ARGS
+#include <access/tupmacs.h>	 // att_isnull
 #include <utils/array.h>	 // ArrayType
 #include <utils/lsyscache.h> // get_typlenbyvalalign
 #include <catalog/pg_type.h> // INT4OID
 
+#include "cell_bits.h"
 #include "error.h"
 #include "type.h"
 
@@ -34,6 +36,8 @@ PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_is_valid_index);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_is_res_class_iii);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_is_pentagon);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_get_icosahedron_faces);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_get_resolutions);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_validate_cells);
 
 /* Returns the resolution of the index */
 Datum
@@ -202,3 +206,106 @@ h3_get_icosahedron_faces(PG_FUNCTION_ARGS)
 	result = construct_array(elements, nelems, elmtype, elmlen, elmbyval, elmalign);
 	PG_RETURN_ARRAYTYPE_P(result);
 }
+
+/*
+ * Allocates an int4 array with the dimensions and null bitmap of the given
+ * h3index array. Its data holds one element per non-NULL input element, in
+ * the same order, so both can be walked with one counter.
+ */
+static ArrayType *
+make_int4_array_like(ArrayType *array, int nitems)
+{
+	int			ndims = ARR_NDIM(array);
+	/* only valid with ARR_HASNULL(), spelled out as ARR_NULLBITMAP() may be NULL */
+	bits8	   *nulls = (bits8 *) array + ARR_OVERHEAD_NONULLS(ndims);
+	int			nstored = nitems;
+	int32		dataoffset = 0;
+	int32		nbytes;
+	ArrayType  *result;
+
+	if (ARR_HASNULL(array))
+	{
+		for (int i = 0; i < nitems; i++)
+		{
+			if (att_isnull(i, nulls))
+				nstored--;
+		}
+		dataoffset = ARR_OVERHEAD_WITHNULLS(ndims, nitems);
+		nbytes = dataoffset + nstored * sizeof(int32);
+	}
+	else
+	{
+		nbytes = ARR_OVERHEAD_NONULLS(ndims) + nstored * sizeof(int32);
+	}
+
+	result = palloc0(nbytes);
+	SET_VARSIZE(result, nbytes);
+	result->ndim = ndims;
+	result->dataoffset = dataoffset;
+	result->elemtype = INT4OID;
+	memcpy(ARR_DIMS(result), ARR_DIMS(array), ndims * sizeof(int));
+	memcpy(ARR_LBOUND(result), ARR_LBOUND(array), ndims * sizeof(int));
+	if (ARR_HASNULL(array))
+		memcpy((bits8 *) result + ARR_OVERHEAD_NONULLS(ndims), nulls, (nitems + 7) / 8);
+
+	return result;
+}
+
+/* Returns the resolution of every index in the array, keeping its shape */
+Datum
+h3_get_resolutions(PG_FUNCTION_ARGS)
+{
+	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+	int			nitems = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+	ArrayType  *result = make_int4_array_like(array, nitems);
+	const H3Index *cells = (const H3Index *) ARR_DATA_PTR(array);
+	int32	   *resolutions = (int32 *) ARR_DATA_PTR(result);
+	int			nstored = (VARSIZE(result) - ARR_DATA_OFFSET(result)) / sizeof(int32);
+
+	for (int i = 0; i < nstored; i++)
+		resolutions[i] = h3index_res(cells[i]);
+
+	PG_RETURN_ARRAYTYPE_P(result);
+}
+
+/* Returns the subscripts of all elements that are not valid H3 cells */
+Datum
+h3_validate_cells(PG_FUNCTION_ARGS)
+{
+	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+	int			ndims = ARR_NDIM(array);
+	int			nitems = ArrayGetNItems(ndims, ARR_DIMS(array));
+	const H3Index *cells = (const H3Index *) ARR_DATA_PTR(array);
+	bits8	   *nulls = ARR_NULLBITMAP(array);
+	int			lbound = ndims > 0 ? ARR_LBOUND(array)[0] : 1;
+	Datum	   *invalid = palloc(nitems * sizeof(Datum));
+	int			ninvalid = 0;
+
+	ASSERT(
+		ndims <= 1,
+		ERRCODE_INVALID_PARAMETER_VALUE,
+		"cells must be a one-dimensional h3index array"
+	);
+
+	if (nulls == NULL)
+	{
+		for (int i = 0; i < nitems; i++)
+		{
+			if (!h3index_is_valid_cell_fast(cells[i]))
+				invalid[ninvalid++] = Int32GetDatum(lbound + i);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < nitems; i++)
+		{
+			if (att_isnull(i, nulls))
+				continue;
+			if (!h3index_is_valid_cell_fast(*cells++))
+				invalid[ninvalid++] = Int32GetDatum(lbound + i);
+		}
+	}
+
+	PG_RETURN_ARRAYTYPE_P(construct_array(invalid, ninvalid, INT4OID,
+										  sizeof(int32), true, TYPALIGN_INT));
+}
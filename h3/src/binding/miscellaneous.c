@@ -22,6 +22,7 @@
 #include <utils/geo_decls.h> // PG_GETARG_POINT_P
 #include <utils/builtins.h>  // text_to_cstring
 
+#include "cell_cache.h"
 #include "error.h"
 #include "type.h"
 #include "srf.h"
@@ -62,11 +63,11 @@ h3_cell_area(PG_FUNCTION_ARGS)
 	double		area;
 
 	if (strcmp(unit, "rads^2") == 0)
-		h3_assert(cellAreaRads2(cell, &area));
+		h3_assert(h3_cell_area_cached(cell, H3_CELL_AREA_RADS2, &area));
 	else if (strcmp(unit, "km^2") == 0)
-		h3_assert(cellAreaKm2(cell, &area));
+		h3_assert(h3_cell_area_cached(cell, H3_CELL_AREA_KM2, &area));
 	else if (strcmp(unit, "m^2") == 0)
-		h3_assert(cellAreaM2(cell, &area));
+		h3_assert(h3_cell_area_cached(cell, H3_CELL_AREA_M2, &area));
 	else
 		ASSERT(0, ERRCODE_INVALID_PARAMETER_VALUE, "Unit must be m^2, km^2 or rads^2.");
 
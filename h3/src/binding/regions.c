@@ -15,25 +15,39 @@
  */
 
 #include <postgres.h>
+
+#if POSTGRESQL_VERSION_MAJOR >= 16
+#include "varatt.h" //VAR_SIZE and friends moved to here from postgres.h
+#endif
+
 #include <h3api.h>
 
+#include <math.h>
+
 #include <fmgr.h>				 // PG_FUNCTION_ARGS
 #include <funcapi.h>			 // SRF_IS_FIRSTCALL
 #include <access/htup_details.h> // HeapTuple
 #include <utils/array.h>		 // ArrayType
 #include <utils/geo_decls.h>	 // PG_GETARG_POLYGON_P
 #include <utils/lsyscache.h>	 // get_typlenbyvalalign
+#include <utils/memutils.h>		 // AllocSizeIsValid
 #include <catalog/pg_type.h>	 // POLYGONOID
 #include <utils/builtins.h>		 // text_to_cstring
 
+#include "cell_bits.h"
 #include "error.h"
 #include "polygon.h"
 #include "type.h"
 #include "srf.h"
+#include "stats.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_polygon_to_cells);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_polygon_to_cells_experimental);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_polygon_to_cells_partition);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_tile_to_cells);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_multi_polygon);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_region_prepare);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_region_contains);
 
 static void
 polygonToGeoLoop(POLYGON *polygon, GeoLoop * geoloop)
@@ -48,6 +62,60 @@ polygonToGeoLoop(POLYGON *polygon, GeoLoop * geoloop)
 	}
 }
 
+/* Builds the polygon from the exterior and holes arguments 0 and 1 */
+static void
+polygonArgsToGeoPolygon(FunctionCallInfo fcinfo, GeoPolygon * polygon)
+{
+	ArrayType  *holes;
+	int			nelems = 0;
+	Datum		value;
+	bool		isnull;
+	POLYGON    *exterior;
+
+	if (PG_ARGISNULL(0))
+		ASSERT(0, ERRCODE_INVALID_PARAMETER_VALUE, "No polygon given to polyfill");
+
+	/* get function arguments */
+	exterior = PG_GETARG_POLYGON_P(0);
+
+	if (!PG_ARGISNULL(1))
+	{
+		holes = PG_GETARG_ARRAYTYPE_P(1);
+		nelems = ArrayGetNItems(ARR_NDIM(holes), ARR_DIMS(holes));
+	}
+
+	/* build polygon */
+	polygonToGeoLoop(exterior, &(polygon->geoloop));
+
+	if (nelems)
+	{
+		int			i = 0;
+		ArrayIterator iterator = array_create_iterator(holes, 0, NULL);
+
+		polygon->numHoles = nelems;
+		polygon->holes = (GeoLoop *) palloc(polygon->numHoles * sizeof(GeoLoop));
+
+		while (array_iterate(iterator, &value, &isnull))
+		{
+			if (isnull)
+			{
+				polygon->numHoles--;
+			}
+			else
+			{
+				POLYGON    *hole = DatumGetPolygonP(value);
+
+				polygonToGeoLoop(hole, &(polygon->holes[i]));
+				i++;
+			}
+		}
+	}
+	else
+	{
+		polygon->numHoles = 0;
+	}
+}
+
 static int
 linkedGeoLoopToNativePolygonSize(LinkedGeoLoop * linkedLoop)
 {
@@ -78,6 +146,212 @@ linkedGeoLoopToNativePolygon(LinkedGeoLoop * linkedLoop, POLYGON *polygon)
 	}
 }
 
+/* Cover cells per part h3_polygon_to_cells_partition aims for */
+#define PARTITION_COVER_CELLS_PER_PART 32
+
+/*
+ * Longitude margin around a part, as a share of its cover cells' widths.
+ * Descendants overhang their ancestor by less than a tenth of its extent.
+ */
+#define PARTITION_CELL_MARGIN 0.25
+
+typedef struct
+{
+	H3Index		cell;
+	double		lng;			/* of the cell center */
+	bool		overlaps;		/* the polygon, or only neighbors a cell that does */
+}	PartitionCell;
+
+static int
+partition_cell_cmp(const void *a, const void *b)
+{
+	const PartitionCell *x = a;
+	const PartitionCell *y = b;
+
+	if (x->lng != y->lng)
+		return x->lng < y->lng ? -1 : 1;
+	return (x->cell > y->cell) - (x->cell < y->cell);
+}
+
+/* qsort and bsearch comparator of H3Index, or structs led by one */
+static int
+h3index_qsort_cmp(const void *a, const void *b)
+{
+	H3Index		x = *(const H3Index *) a;
+	H3Index		y = *(const H3Index *) b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Distinct cells at the resolution overlapping the polygon, and their
+ * neighbors: every cell filled at a finer resolution descends from one.
+ * Sorted by longitude, overlapCount tells how many overlap.
+ */
+static PartitionCell *
+polygonCover(const GeoPolygon * polygon, int res, int64 *count, int64 *overlapCount)
+{
+	int64_t		maxSize;
+	H3Index    *overlapping;
+	H3Index    *disks;
+	PartitionCell *cover;
+	int64		numOverlapping = 0;
+	int64		n = 0;
+	int64		unique = 0;
+
+	h3_assert(maxPolygonToCellsSizeExperimental(polygon, res, CONTAINMENT_OVERLAPPING, &maxSize));
+	overlapping = palloc_extended(maxSize * sizeof(H3Index),
+								  MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
+	h3_assert(polygonToCellsExperimental(polygon, res, CONTAINMENT_OVERLAPPING, maxSize, overlapping));
+
+	disks = palloc_extended(maxSize * 7 * sizeof(H3Index),
+							MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
+	for (int64 i = 0; i < maxSize; i++)
+	{
+		if (overlapping[i] == H3_NULL)
+			continue;
+		overlapping[numOverlapping++] = overlapping[i];
+		h3_assert(gridDisk(overlapping[i], 1, disks + n));
+		n += 7;
+	}
+	qsort(overlapping, numOverlapping, sizeof(H3Index), h3index_qsort_cmp);
+
+	/* pentagons leave an empty slot in their disk */
+	qsort(disks, n, sizeof(H3Index), h3index_qsort_cmp);
+	cover = palloc_extended(Max(n, 1) * sizeof(PartitionCell), MCXT_ALLOC_HUGE);
+	for (int64 i = 0; i < n; i++)
+	{
+		LatLng		center;
+
+		if (disks[i] == H3_NULL || (i > 0 && disks[i] == disks[i - 1]))
+			continue;
+
+		h3_assert(cellToLatLng(disks[i], &center));
+		cover[unique].cell = disks[i];
+		cover[unique].lng = center.lng;
+		cover[unique].overlaps = bsearch(&disks[i], overlapping, numOverlapping,
+										 sizeof(H3Index), h3index_qsort_cmp) != NULL;
+		unique++;
+	}
+	pfree(disks);
+	pfree(overlapping);
+
+	qsort(cover, unique, sizeof(PartitionCell), partition_cell_cmp);
+	*count = unique;
+	*overlapCount = numOverlapping;
+	return cover;
+}
+
+/* Edges crossing the antimeridian, as in upstream bboxFromGeoLoop */
+static bool
+geoLoopIsTransmeridian(const GeoLoop * loop)
+{
+	for (int i = 0; i < loop->numVerts; i++)
+	{
+		const LatLng *a = &loop->verts[i];
+		const LatLng *b = &loop->verts[(i + 1) % loop->numVerts];
+
+		if (fabs(a->lng - b->lng) > M_PI)
+			return true;
+	}
+	return false;
+}
+
+/*
+ * One Sutherland-Hodgman pass keeping the side lng >= bound (keepAbove) or
+ * lng <= bound. Writes at most 2 * n vertices.
+ */
+static int
+clipLoopSide(const LatLng * in, int n, LatLng * out, double bound, bool keepAbove)
+{
+	int			count = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		const LatLng *a = &in[i];
+		const LatLng *b = &in[(i + 1) % n];
+		bool		aInside = keepAbove ? a->lng >= bound : a->lng <= bound;
+		bool		bInside = keepAbove ? b->lng >= bound : b->lng <= bound;
+
+		if (aInside)
+			out[count++] = *a;
+		if (aInside != bInside)
+		{
+			double		t = (bound - a->lng) / (b->lng - a->lng);
+
+			out[count].lat = a->lat + t * (b->lat - a->lat);
+			out[count].lng = bound;
+			count++;
+		}
+	}
+	return count;
+}
+
+/* Clips the loop to the longitudes lo to hi, false if nothing is left */
+static bool
+clipGeoLoop(const GeoLoop * loop, double lo, double hi, GeoLoop * out)
+{
+	LatLng	   *above = palloc(2 * loop->numVerts * sizeof(LatLng));
+	int			count = clipLoopSide(loop->verts, loop->numVerts, above, lo, true);
+
+	out->verts = palloc((2 * count + 1) * sizeof(LatLng));
+	out->numVerts = clipLoopSide(above, count, out->verts, hi, false);
+	pfree(above);
+	return out->numVerts >= 3;
+}
+
+/*
+ * Clips the polygon to the longitudes lo to hi. Longitudes are treated as
+ * planar, as polygonToCells() does. Returns false if the exterior is gone.
+ */
+static bool
+clipGeoPolygon(const GeoPolygon * polygon, double lo, double hi, GeoPolygon * out)
+{
+	if (!clipGeoLoop(&polygon->geoloop, lo, hi, &out->geoloop))
+		return false;
+
+	out->numHoles = 0;
+	out->holes = palloc(Max(polygon->numHoles, 1) * sizeof(GeoLoop));
+	for (int i = 0; i < polygon->numHoles; i++)
+	{
+		if (clipGeoLoop(&polygon->holes[i], lo, hi, &out->holes[out->numHoles]))
+			out->numHoles++;
+	}
+	return true;
+}
+
+/*
+ * Longitude window holding every descendant of the cells, in radians.
+ * Returns false where longitudes wrap and a window would lose cells.
+ */
+static bool
+partitionWindow(const H3Index * cells, int64 count, double *lo, double *hi)
+{
+	*lo = M_PI;
+	*hi = -M_PI;
+	for (int64 i = 0; i < count; i++)
+	{
+		CellBoundary boundary;
+		double		west = M_PI;
+		double		east = -M_PI;
+		double		margin;
+
+		h3_assert(cellToBoundary(cells[i], &boundary));
+		for (int v = 0; v < boundary.numVerts; v++)
+		{
+			west = Min(west, boundary.verts[v].lng);
+			east = Max(east, boundary.verts[v].lng);
+		}
+		if (east - west > M_PI)
+			return false;
+
+		margin = (east - west) * PARTITION_CELL_MARGIN;
+		*lo = Min(*lo, west - margin);
+		*hi = Max(*hi, east + margin);
+	}
+	return *lo >= -M_PI && *hi <= M_PI;
+}
+
 /*
  * H3Error polygonToCells(const GeoPolygon *geoPolygon, int res, uint32_t flags, H3Index *out);
  */
@@ -92,63 +366,21 @@ h3_polygon_to_cells(PG_FUNCTION_ARGS)
 
 		int64_t		maxSize;
 		H3Index    *indices;
-		ArrayType  *holes;
-		int			nelems = 0;
 		int			resolution;
 		GeoPolygon	polygon = {0};
-		Datum		value;
-		bool		isnull;
-		POLYGON    *exterior;
+		H3StatTimer timer;
 
-		if (PG_ARGISNULL(0))
-			ASSERT(0, ERRCODE_INVALID_PARAMETER_VALUE, "No polygon given to polyfill");
+		h3_stats_begin(&timer);
 
-		/* get function arguments */
-		exterior = PG_GETARG_POLYGON_P(0);
-
-		if (!PG_ARGISNULL(1))
-		{
-			holes = PG_GETARG_ARRAYTYPE_P(1);
-			nelems = ArrayGetNItems(ARR_NDIM(holes), ARR_DIMS(holes));
-		}
+		polygonArgsToGeoPolygon(fcinfo, &polygon);
 		resolution = PG_GETARG_INT32(2);
 
-		/* build polygon */
-		polygonToGeoLoop(exterior, &(polygon.geoloop));
-
-		if (nelems)
-		{
-			int			i = 0;
-			ArrayIterator iterator = array_create_iterator(holes, 0, NULL);
-
-			polygon.numHoles = nelems;
-			polygon.holes = (GeoLoop *) palloc(polygon.numHoles * sizeof(GeoLoop));
-
-			while (array_iterate(iterator, &value, &isnull))
-			{
-				if (isnull)
-				{
-					polygon.numHoles--;
-				}
-				else
-				{
-					POLYGON    *hole = DatumGetPolygonP(value);
-
-					polygonToGeoLoop(hole, &(polygon.holes[i]));
-					i++;
-				}
-			}
-		}
-		else
-		{
-			polygon.numHoles = 0;
-		}
-
 		/* produce hexagons into allocated memory */
 		h3_assert(maxPolygonToCellsSize(&polygon, resolution, 0, &maxSize));
 		indices = palloc_extended(maxSize * sizeof(H3Index),
 								  MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
 		h3_assert(polygonToCells(&polygon, resolution, 0, indices));
+		h3_stats_end_cells(&timer, H3_STAT_POLYGON_TO_CELLS, indices, maxSize);
 
 		funcctx->user_fctx = indices;
 		funcctx->max_calls = maxSize;
@@ -173,26 +405,14 @@ h3_polygon_to_cells_experimental(PG_FUNCTION_ARGS)
 		char       *containment_mode;
 		int64_t		maxSize;
 		H3Index    *indices;
-		ArrayType  *holes;
-		int			nelems = 0;
 		uint32_t	flags = 0;
 		int			resolution;
 		GeoPolygon	polygon = {0};
-		Datum		value;
-		bool		isnull;
-		POLYGON    *exterior;
-
-		if (PG_ARGISNULL(0))
-			ASSERT(0, ERRCODE_INVALID_PARAMETER_VALUE, "No polygon given to polyfill");
+		H3StatTimer timer;
 
-		/* get function arguments */
-		exterior = PG_GETARG_POLYGON_P(0);
+		h3_stats_begin(&timer);
 
-		if (!PG_ARGISNULL(1))
-		{
-			holes = PG_GETARG_ARRAYTYPE_P(1);
-			nelems = ArrayGetNItems(ARR_NDIM(holes), ARR_DIMS(holes));
-		}
+		polygonArgsToGeoPolygon(fcinfo, &polygon);
 		resolution = PG_GETARG_INT32(2);
 		if (!PG_ARGISNULL(3))
 		{
@@ -209,42 +429,225 @@ h3_polygon_to_cells_experimental(PG_FUNCTION_ARGS)
 				ASSERT(0, ERRCODE_INVALID_PARAMETER_VALUE, "Containment Mode must be center, full, overlapping, or overlapping_bbox.");
 		}
 
-		/* build polygon */
-		polygonToGeoLoop(exterior, &(polygon.geoloop));
+		/* produce hexagons into allocated memory */
+		h3_assert(maxPolygonToCellsSizeExperimental(&polygon, resolution, flags, &maxSize));
+		indices = palloc_extended(maxSize * sizeof(H3Index),
+								  MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
+		h3_assert(polygonToCellsExperimental(&polygon, resolution, flags, maxSize, indices));
+		h3_stats_end_cells(&timer, H3_STAT_POLYGON_TO_CELLS_EXPERIMENTAL, indices, maxSize);
+
+		funcctx->user_fctx = indices;
+		funcctx->max_calls = maxSize;
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	SRF_RETURN_H3_INDEXES_FROM_USER_FCTX();
+}
+
+/*
+ * Cells of h3_polygon_to_cells() descending from one of nparts groups of
+ * coarse cells covering the polygon. The groups are runs of the cover
+ * sorted by longitude, so each part only fills a strip of the polygon.
+ */
+Datum
+h3_polygon_to_cells_partition(PG_FUNCTION_ARGS)
+{
+	if (SRF_IS_FIRSTCALL())
+	{
+		FuncCallContext *funcctx = SRF_FIRSTCALL_INIT();
+		MemoryContext oldcontext =
+		MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		int64_t		maxSize = 0;
+		H3Index    *indices = NULL;
+		PartitionCell *cover;
+		H3Index    *mine;
+		int64		coverCount;
+		int64		overlapCount;
+		int64		count = 0;
+		int64		kept = 0;
+		int			resolution;
+		int			coverRes;
+		int			part;
+		int			nparts;
+		double		lo;
+		double		hi;
+		GeoPolygon	polygon = {0};
+		GeoPolygon	clipped = {0};
+		GeoPolygon *fill = &polygon;
+		H3StatTimer timer;
+
+		h3_stats_begin(&timer);
+
+		polygonArgsToGeoPolygon(fcinfo, &polygon);
+		ASSERT(!PG_ARGISNULL(2) && !PG_ARGISNULL(3) && !PG_ARGISNULL(4),
+			   ERRCODE_NULL_VALUE_NOT_ALLOWED,
+			   "resolution, part and nparts must not be NULL");
+		resolution = PG_GETARG_INT32(2);
+		part = PG_GETARG_INT32(3);
+		nparts = PG_GETARG_INT32(4);
+
+		if (resolution < 0 || resolution > MAX_H3_RES)
+			h3_assert(E_RES_DOMAIN);
+		ASSERT(nparts > 0, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "nparts must be positive");
+		ASSERT(part >= 0 && part < nparts, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "part must be between 0 and nparts - 1, got %d", part);
+
+		/* coarsest cover with enough cells to balance the parts */
+		for (coverRes = 0;; coverRes++)
+		{
+			cover = polygonCover(&polygon, coverRes, &coverCount, &overlapCount);
+			if (overlapCount >= (int64) PARTITION_COVER_CELLS_PER_PART * nparts
+				|| coverRes == resolution)
+				break;
+			pfree(cover);
+		}
+
+		/*
+		 * Runs in order of longitude with equal numbers of overlapping cells.
+		 * Neighbors join the run of the next overlapping cell.
+		 */
+		mine = palloc_extended(Max(coverCount, 1) * sizeof(H3Index), MCXT_ALLOC_HUGE);
+		for (int64 i = 0, rank = 0; overlapCount > 0 && i < coverCount; i++)
+		{
+			if (Min(rank * nparts / overlapCount, nparts - 1) == part)
+				mine[count++] = cover[i].cell;
+			if (cover[i].overlaps)
+				rank++;
+		}
+		qsort(mine, count, sizeof(H3Index), h3index_qsort_cmp);
+		pfree(cover);
 
-		if (nelems)
+		/* fill only the strip of the polygon where the part's cells are */
+		if (count > 0
+			&& !geoLoopIsTransmeridian(&polygon.geoloop)
+			&& partitionWindow(mine, count, &lo, &hi))
 		{
-			int			i = 0;
-			ArrayIterator iterator = array_create_iterator(holes, 0, NULL);
+			fill = clipGeoPolygon(&polygon, lo, hi, &clipped) ? &clipped : NULL;
+		}
 
-			polygon.numHoles = nelems;
-			polygon.holes = (GeoLoop *) palloc(polygon.numHoles * sizeof(GeoLoop));
+		if (count > 0 && fill != NULL)
+		{
+			h3_assert(maxPolygonToCellsSize(fill, resolution, 0, &maxSize));
+			indices = palloc_extended(maxSize * sizeof(H3Index),
+									  MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
+			h3_assert(polygonToCells(fill, resolution, 0, indices));
 
-			while (array_iterate(iterator, &value, &isnull))
+			for (int64 i = 0; i < maxSize; i++)
 			{
-				if (isnull)
-				{
-					polygon.numHoles--;
-				}
-				else
-				{
-					POLYGON    *hole = DatumGetPolygonP(value);
+				H3Index		ancestor;
 
-					polygonToGeoLoop(hole, &(polygon.holes[i]));
-					i++;
-				}
+				if (indices[i] == H3_NULL)
+					continue;
+				ancestor = h3index_cell_to_parent_fast(indices[i], coverRes);
+				if (bsearch(&ancestor, mine, count, sizeof(H3Index), h3index_qsort_cmp))
+					indices[kept++] = indices[i];
 			}
 		}
-		else
-		{
-			polygon.numHoles = 0;
-		}
+		h3_stats_end_cells(&timer, H3_STAT_POLYGON_TO_CELLS_PARTITION, indices, kept);
 
-		/* produce hexagons into allocated memory */
-		h3_assert(maxPolygonToCellsSizeExperimental(&polygon, resolution, flags, &maxSize));
+		funcctx->user_fctx = indices;
+		funcctx->max_calls = kept;
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	SRF_RETURN_H3_INDEXES_FROM_USER_FCTX();
+}
+
+/*
+ * Longest tile edge in degrees. Longer edges get intermediate vertices, as
+ * ST_Segmentize() does for tile envelopes, so that none of them reads as
+ * crossing the antimeridian.
+ */
+#define TILE_MAX_EDGE_DEGS 90.0
+
+/* Appends the vertices from "from" up to, but not including, "to" */
+static int
+tileAppendEdge(LatLng * verts, int count, LatLng from, LatLng to)
+{
+	double		span = Max(fabs(to.lat - from.lat), fabs(to.lng - from.lng));
+	int			steps = Max(1, (int) ceil(radsToDegs(span) / TILE_MAX_EDGE_DEGS));
+
+	for (int i = 0; i < steps; i++)
+	{
+		verts[count].lat = from.lat + (to.lat - from.lat) * i / steps;
+		verts[count].lng = from.lng + (to.lng - from.lng) * i / steps;
+		count++;
+	}
+	return count;
+}
+
+/*
+ * Cells overlapping the bounding box of Web Mercator tile z/x/y, grown by
+ * margin times the tile size and clamped to the world like ST_TileEnvelope().
+ * Parallels and meridians are straight in longitude and latitude, so the
+ * tile outline is a rectangle there and needs no projection.
+ */
+Datum
+h3_tile_to_cells(PG_FUNCTION_ARGS)
+{
+	if (SRF_IS_FIRSTCALL())
+	{
+		FuncCallContext *funcctx = SRF_FIRSTCALL_INIT();
+		MemoryContext oldcontext =
+		MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		int			z = PG_GETARG_INT32(0);
+		int			x = PG_GETARG_INT32(1);
+		int			y = PG_GETARG_INT32(2);
+		int			resolution = PG_GETARG_INT32(3);
+		double		margin = PG_GETARG_FLOAT8(4);
+
+		LatLng		corners[4];
+		LatLng		verts[4 * 4];
+		GeoPolygon	polygon = {0};
+		double		tiles;
+		double		west;
+		double		east;
+		double		north;
+		double		south;
+		int64_t		maxSize;
+		H3Index    *indices;
+		H3StatTimer timer;
+
+		ASSERT(z >= 0 && z <= 30, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Tile zoom must be between 0 and 30, got %d", z);
+		ASSERT(x >= 0 && x < (1 << z) && y >= 0 && y < (1 << z),
+			   ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Tile %d/%d/%d does not exist", z, x, y);
+		ASSERT(margin > -0.5, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Tile margin must be greater than -0.5, got %g", margin);
+
+		h3_stats_begin(&timer);
+
+		/* tile bounds as fractions of the world, y pointing south */
+		tiles = (double) (1 << z);
+		west = Max(0.0, (x - margin) / tiles);
+		east = Min(1.0, (x + 1 + margin) / tiles);
+		north = Max(0.0, (y - margin) / tiles);
+		south = Min(1.0, (y + 1 + margin) / tiles);
+
+		west = (west - 0.5) * 2 * M_PI;
+		east = (east - 0.5) * 2 * M_PI;
+		north = atan(sinh(M_PI * (1 - 2 * north)));
+		south = atan(sinh(M_PI * (1 - 2 * south)));
+
+		/* counterclockwise from the south-west corner */
+		corners[0] = (LatLng) {.lat = south,.lng = west};
+		corners[1] = (LatLng) {.lat = south,.lng = east};
+		corners[2] = (LatLng) {.lat = north,.lng = east};
+		corners[3] = (LatLng) {.lat = north,.lng = west};
+		for (int i = 0; i < 4; i++)
+			polygon.geoloop.numVerts = tileAppendEdge(verts, polygon.geoloop.numVerts,
+													  corners[i], corners[(i + 1) % 4]);
+		polygon.geoloop.verts = verts;
+
+		h3_assert(maxPolygonToCellsSizeExperimental(&polygon, resolution, CONTAINMENT_OVERLAPPING_BBOX, &maxSize));
 		indices = palloc_extended(maxSize * sizeof(H3Index),
 								  MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
-		h3_assert(polygonToCellsExperimental(&polygon, resolution, flags, maxSize, indices));
+		h3_assert(polygonToCellsExperimental(&polygon, resolution, CONTAINMENT_OVERLAPPING_BBOX, maxSize, indices));
+		h3_stats_end_cells(&timer, H3_STAT_TILE_TO_CELLS, indices, maxSize);
 
 		funcctx->user_fctx = indices;
 		funcctx->max_calls = maxSize;
@@ -280,6 +683,9 @@ h3_cells_to_multi_polygon(PG_FUNCTION_ARGS)
 		int			numHexes = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
 		ArrayIterator iterator = array_create_iterator(array, 0, NULL);
 		H3Index    *h3set = palloc(numHexes * sizeof(H3Index));
+		H3StatTimer timer;
+
+		h3_stats_begin(&timer);
 
 		/* Extract data from array into h3set, and wipe compactedSet memory */
 		while (array_iterate(iterator, &value, &isnull))
@@ -292,6 +698,7 @@ h3_cells_to_multi_polygon(PG_FUNCTION_ARGS)
 		/* produce hexagons into allocated memory */
 		linkedPolygon = palloc0(sizeof(LinkedGeoPolygon));
 		h3_assert(cellsToLinkedMultiPolygon(h3set, numHexes, linkedPolygon));
+		h3_stats_end(&timer, H3_STAT_CELLS_TO_MULTI_POLYGON, numHexes);
 
 		ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
 
@@ -381,6 +788,662 @@ h3_cells_to_multi_polygon(PG_FUNCTION_ARGS)
 	}
 }
 
+/* ---------------------------------------------------------------------------
+ * Prepared regions
+ *
+ * A polygon digested at one resolution for repeated point-in-polygon tests,
+ * stored in a bytea. The cells the boundary crosses, and their neighbors so
+ * that no answer depends on H3 and the planar polygon disagreeing about cell
+ * edges, are boundary cells: they keep the polygon edges within their
+ * bounding box and whether their center is inside. The cells left fully
+ * inside are stored compacted. A point then takes one latLngToCell() and a
+ * few binary searches, and only in a boundary cell crossing tests against
+ * the edges between the point and the cell center.
+ */
+
+#define H3_REGION_MAGIC 0x48335247	/* "H3RG" */
+#define H3_REGION_VERSION 1
+
+/* Share of a boundary cell's extent its bounding box is widened by */
+#define H3_REGION_CELL_MARGIN 0.1
+
+typedef struct
+{
+	int32		vl_len_;		/* varlena header (do not touch directly!) */
+	uint32		magic;
+	uint8		version;
+	uint8		resolution;
+	bool		transmeridian;	/* longitudes are shifted to 0 to 2 pi */
+	uint8		unused;
+	uint32		interiorResolutions;	/* bit set of the interior cells' */
+	uint32		numInterior;
+	uint32		numBoundary;
+	uint32		numVerts;
+	uint32		numEdges;
+
+	/*
+	 * Followed by, each array MAXALIGNed:
+	 *
+	 * H3Index interior[numInterior], compacted and sorted
+	 * H3RegionCell boundary[numBoundary], sorted by cell
+	 * LatLng verts[numVerts], each ring closed and followed by a NaN vertex
+	 * uint32 edges[numEdges], of boundary cells, as index of the first vertex
+	 */
+}	H3Region;
+
+typedef struct
+{
+	H3Index		cell;
+	LatLng		center;
+	LatLng		low;			/* bounding box, widened */
+	LatLng		high;
+	uint32		firstEdge;
+	uint32		numEdges;
+	bool		centerInside;
+}	H3RegionCell;
+
+typedef struct
+{
+	H3Index    *interior;
+	H3RegionCell *boundary;
+	LatLng	   *verts;
+	uint32	   *edges;
+}	H3RegionArrays;
+
+/* Last region detoasted for a call site */
+typedef struct
+{
+	struct varlena *raw;		/* as passed, compressed or a TOAST pointer */
+	H3Region   *region;
+}	H3RegionCache;
+
+/* Points the arrays into the region, returns the size of the whole */
+static Size
+regionLayout(const H3Region * region, H3RegionArrays * arrays)
+{
+	char	   *base = (char *) region;
+	Size		offset = MAXALIGN(sizeof(H3Region));
+
+	arrays->interior = (H3Index *) (base + offset);
+	offset += MAXALIGN((Size) region->numInterior * sizeof(H3Index));
+	arrays->boundary = (H3RegionCell *) (base + offset);
+	offset += MAXALIGN((Size) region->numBoundary * sizeof(H3RegionCell));
+	arrays->verts = (LatLng *) (base + offset);
+	offset += MAXALIGN((Size) region->numVerts * sizeof(LatLng));
+	arrays->edges = (uint32 *) (base + offset);
+	offset += (Size) region->numEdges * sizeof(uint32);
+	return offset;
+}
+
+/* Longitude as stored in a region, see H3Region.transmeridian */
+static double
+regionLng(double lng, bool transmeridian)
+{
+	return transmeridian && lng < 0 ? lng + 2 * M_PI : lng;
+}
+
+/* Whether the ray from the point towards growing longitude crosses the edge */
+static bool
+rayCrossesEdge(const LatLng * point, const LatLng * a, const LatLng * b)
+{
+	if ((a->lat > point->lat) == (b->lat > point->lat))
+		return false;
+	return point->lng < a->lng + (point->lat - a->lat) * (b->lng - a->lng) / (b->lat - a->lat);
+}
+
+static double
+orientation(const LatLng * a, const LatLng * b, const LatLng * c)
+{
+	return (b->lng - a->lng) * (c->lat - a->lat) - (b->lat - a->lat) * (c->lng - a->lng);
+}
+
+/*
+ * Whether the segment from p to q crosses the edge. Vertices on the line
+ * through p and q count as left of it, as ray casting does.
+ */
+static bool
+segmentCrossesEdge(const LatLng * p, const LatLng * q, const LatLng * a, const LatLng * b)
+{
+	if ((orientation(p, q, a) >= 0) == (orientation(p, q, b) >= 0))
+		return false;
+	return (orientation(a, b, p) > 0) != (orientation(a, b, q) > 0);
+}
+
+/* Planar point in polygon test against every edge */
+static bool
+regionContainsSlow(const H3Region * region, const H3RegionArrays * arrays, const LatLng * point)
+{
+	bool		inside = false;
+
+	for (uint32 i = 0; i + 1 < region->numVerts; i++)
+	{
+		if (rayCrossesEdge(point, &arrays->verts[i], &arrays->verts[i + 1]))
+			inside = !inside;
+	}
+	return inside;
+}
+
+static bool
+regionContains(const H3Region * region, H3Index cell, const LatLng * point)
+{
+	H3RegionArrays arrays;
+	H3RegionCell *boundary;
+	bool		inside;
+
+	regionLayout(region, &arrays);
+
+	/* the cell or one of its ancestors lies inside */
+	for (uint32 bits = region->interiorResolutions; bits != 0; bits &= bits - 1)
+	{
+		H3Index		ancestor = h3index_cell_to_parent_fast(cell, pg_rightmost_one_pos32(bits));
+
+		if (bsearch(&ancestor, arrays.interior, region->numInterior,
+					sizeof(H3Index), h3index_qsort_cmp))
+			return true;
+	}
+
+	/* the cell leads its boundary entry */
+	boundary = bsearch(&cell, arrays.boundary, region->numBoundary,
+					   sizeof(H3RegionCell), h3index_qsort_cmp);
+	if (boundary == NULL)
+		return false;
+
+	/* the point may lie beyond the planar outline of its cell */
+	if (point->lat < boundary->low.lat || point->lat > boundary->high.lat
+		|| point->lng < boundary->low.lng || point->lng > boundary->high.lng)
+		return regionContainsSlow(region, &arrays, point);
+
+	ASSERT((uint64) boundary->firstEdge + boundary->numEdges <= region->numEdges,
+		   ERRCODE_DATA_CORRUPTED, "invalid prepared region");
+
+	/* each edge between the point and the center flips the side */
+	inside = boundary->centerInside;
+	for (uint32 i = 0; i < boundary->numEdges; i++)
+	{
+		uint32		edge = arrays.edges[boundary->firstEdge + i];
+
+		ASSERT(edge + 1 < region->numVerts, ERRCODE_DATA_CORRUPTED,
+			   "invalid prepared region");
+		if (segmentCrossesEdge(point, &boundary->center,
+							   &arrays.verts[edge], &arrays.verts[edge + 1]))
+			inside = !inside;
+	}
+	return inside;
+}
+
+static void
+regionCheck(const H3Region * region)
+{
+	H3RegionArrays arrays;
+
+	ASSERT(VARSIZE(region) >= sizeof(H3Region)
+		   && region->magic == H3_REGION_MAGIC
+		   && region->version == H3_REGION_VERSION
+		   && region->resolution <= MAX_H3_RES
+		   && VARSIZE(region) == regionLayout(region, &arrays),
+		   ERRCODE_INVALID_PARAMETER_VALUE,
+		   "invalid prepared region");
+}
+
+/*
+ * The region argument, detoasted and aligned. Compressed and out of line
+ * values are kept for the following calls, which commonly pass the same.
+ */
+static const H3Region *
+regionGetArg(FunctionCallInfo fcinfo, int argno)
+{
+	struct varlena *raw = (struct varlena *) PG_GETARG_POINTER(argno);
+	H3RegionCache *cache = fcinfo->flinfo->fn_extra;
+	Size		rawSize = VARSIZE_ANY(raw);
+	MemoryContext oldcontext;
+	H3Region   *region;
+
+	if (!VARATT_IS_EXTENDED(raw) && (uintptr_t) raw % MAXIMUM_ALIGNOF == 0)
+	{
+		regionCheck((H3Region *) raw);
+		return (H3Region *) raw;
+	}
+
+	if (!VARATT_IS_EXTERNAL_ONDISK(raw) && !VARATT_IS_COMPRESSED(raw))
+	{
+		region = (H3Region *) PG_DETOAST_DATUM_COPY(PointerGetDatum(raw));
+		regionCheck(region);
+		return region;
+	}
+
+	if (cache != NULL && VARSIZE_ANY(cache->raw) == rawSize
+		&& memcmp(cache->raw, raw, rawSize) == 0)
+		return cache->region;
+
+	if (cache == NULL)
+	{
+		cache = MemoryContextAllocZero(fcinfo->flinfo->fn_mcxt, sizeof(H3RegionCache));
+		fcinfo->flinfo->fn_extra = cache;
+	}
+	else
+	{
+		pfree(cache->raw);
+		pfree(cache->region);
+		cache->raw = NULL;
+		cache->region = NULL;
+	}
+
+	oldcontext = MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+	region = (H3Region *) PG_DETOAST_DATUM_COPY(PointerGetDatum(raw));
+	MemoryContextSwitchTo(oldcontext);
+	regionCheck(region);
+
+	cache->raw = MemoryContextAlloc(fcinfo->flinfo->fn_mcxt, rawSize);
+	memcpy(cache->raw, raw, rawSize);
+	cache->region = region;
+	return region;
+}
+
+/* Sorts the cells and drops duplicates and H3_NULL, returns the count left */
+static int64
+sortUniqueCells(H3Index * cells, int64 count)
+{
+	int64		unique = 0;
+
+	qsort(cells, count, sizeof(H3Index), h3index_qsort_cmp);
+	for (int64 i = 0; i < count; i++)
+	{
+		if (cells[i] != H3_NULL && (unique == 0 || cells[i] != cells[unique - 1]))
+			cells[unique++] = cells[i];
+	}
+	return unique;
+}
+
+/* Cells of sorted a not in sorted b, written over a */
+static int64
+subtractCells(H3Index * a, int64 countA, const H3Index * b, int64 countB)
+{
+	int64		count = 0;
+	int64		j = 0;
+
+	for (int64 i = 0; i < countA; i++)
+	{
+		while (j < countB && b[j] < a[i])
+			j++;
+		if (j == countB || b[j] != a[i])
+			a[count++] = a[i];
+	}
+	return count;
+}
+
+static H3Index *
+polygonCells(const GeoPolygon * polygon, int resolution, uint32_t flags, int64 *count)
+{
+	int64_t		maxSize;
+	H3Index    *cells;
+
+	h3_assert(maxPolygonToCellsSizeExperimental(polygon, resolution, flags, &maxSize));
+	cells = palloc_extended(maxSize * sizeof(H3Index), MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
+	h3_assert(polygonToCellsExperimental(polygon, resolution, flags, maxSize, cells));
+	*count = sortUniqueCells(cells, maxSize);
+	return cells;
+}
+
+/*
+ * Uniform grid over the polygon's bounding box, listing the edges whose
+ * bounding box meets each bucket
+ */
+typedef struct
+{
+	int			size;			/* buckets along each axis */
+	LatLng		low;
+	LatLng		high;
+	uint32	   *bucketStart;	/* size * size + 1 offsets into edges */
+	uint32	   *edges;
+	uint32	   *seen;			/* per vertex, last query listing the edge */
+	uint32		query;
+	uint32	   *found;			/* edges listed by the last query */
+}	EdgeGrid;
+
+static int
+edgeGridBucket(double value, double low, double high, int size)
+{
+	double		scaled = high > low ? (value - low) / (high - low) * size : 0;
+
+	if (!(scaled >= 0))
+		return 0;
+	return Min((int) scaled, size - 1);
+}
+
+static void
+edgeBox(const LatLng * verts, uint32 edge, LatLng * low, LatLng * high)
+{
+	low->lat = Min(verts[edge].lat, verts[edge + 1].lat);
+	low->lng = Min(verts[edge].lng, verts[edge + 1].lng);
+	high->lat = Max(verts[edge].lat, verts[edge + 1].lat);
+	high->lng = Max(verts[edge].lng, verts[edge + 1].lng);
+}
+
+static void
+edgeGridBuild(EdgeGrid * grid, const LatLng * verts, uint32 numVerts)
+{
+	uint32		numEdges = 0;
+	uint32	   *fill;
+
+	grid->low.lat = grid->low.lng = INFINITY;
+	grid->high.lat = grid->high.lng = -INFINITY;
+	for (uint32 i = 0; i < numVerts; i++)
+	{
+		if (isnan(verts[i].lat))
+			continue;
+		grid->low.lat = Min(grid->low.lat, verts[i].lat);
+		grid->low.lng = Min(grid->low.lng, verts[i].lng);
+		grid->high.lat = Max(grid->high.lat, verts[i].lat);
+		grid->high.lng = Max(grid->high.lng, verts[i].lng);
+		numEdges++;
+	}
+	grid->size = Max(1, Min((int) sqrt(numEdges), 1024));
+	grid->bucketStart = palloc0(((Size) grid->size * grid->size + 1) * sizeof(uint32));
+	fill = palloc0(((Size) grid->size * grid->size + 1) * sizeof(uint32));
+	grid->seen = palloc0(numVerts * sizeof(uint32));
+	grid->found = palloc(numVerts * sizeof(uint32));
+	grid->query = 0;
+
+	/* count, then place each edge in the buckets of its bounding box */
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (uint32 edge = 0; edge + 1 < numVerts; edge++)
+		{
+			LatLng		low;
+			LatLng		high;
+
+			if (isnan(verts[edge].lat) || isnan(verts[edge + 1].lat))
+				continue;
+
+			edgeBox(verts, edge, &low, &high);
+			for (int row = edgeGridBucket(low.lat, grid->low.lat, grid->high.lat, grid->size);
+				 row <= edgeGridBucket(high.lat, grid->low.lat, grid->high.lat, grid->size); row++)
+			{
+				for (int col = edgeGridBucket(low.lng, grid->low.lng, grid->high.lng, grid->size);
+					 col <= edgeGridBucket(high.lng, grid->low.lng, grid->high.lng, grid->size); col++)
+				{
+					int			bucket = row * grid->size + col;
+
+					if (pass == 0)
+						grid->bucketStart[bucket + 1]++;
+					else
+						grid->edges[grid->bucketStart[bucket] + fill[bucket]++] = edge;
+				}
+			}
+		}
+
+		if (pass == 0)
+		{
+			for (int bucket = 0; bucket < grid->size * grid->size; bucket++)
+				grid->bucketStart[bucket + 1] += grid->bucketStart[bucket];
+			grid->edges = palloc_extended(Max(grid->bucketStart[grid->size * grid->size], 1) * sizeof(uint32),
+										  MCXT_ALLOC_HUGE);
+		}
+	}
+	pfree(fill);
+}
+
+/*
+ * Lists the edges in the buckets the box meets, each once, into the
+ * scratch array. Returns their count.
+ */
+static uint32
+edgeGridCollect(EdgeGrid * grid, const LatLng * low, const LatLng * high)
+{
+	uint32		count = 0;
+	int			rowEnd = edgeGridBucket(high->lat, grid->low.lat, grid->high.lat, grid->size);
+	int			colStart = edgeGridBucket(low->lng, grid->low.lng, grid->high.lng, grid->size);
+	int			colEnd = edgeGridBucket(high->lng, grid->low.lng, grid->high.lng, grid->size);
+
+	grid->query++;
+	for (int row = edgeGridBucket(low->lat, grid->low.lat, grid->high.lat, grid->size); row <= rowEnd; row++)
+	{
+		for (int col = colStart; col <= colEnd; col++)
+		{
+			int			bucket = row * grid->size + col;
+
+			for (uint32 i = grid->bucketStart[bucket]; i < grid->bucketStart[bucket + 1]; i++)
+			{
+				uint32		edge = grid->edges[i];
+
+				if (grid->seen[edge] == grid->query)
+					continue;
+				grid->seen[edge] = grid->query;
+				grid->found[count++] = edge;
+			}
+		}
+	}
+	return count;
+}
+
+/* Appends the polygon's rings, closed and separated by NaN vertices */
+static uint32
+regionAppendRing(LatLng * verts, uint32 count, const GeoLoop * loop, bool transmeridian)
+{
+	if (loop->numVerts < 3)
+		return count;
+
+	for (int i = 0; i <= loop->numVerts; i++)
+	{
+		verts[count] = loop->verts[i % loop->numVerts];
+		verts[count].lng = regionLng(verts[count].lng, transmeridian);
+		count++;
+	}
+	verts[count].lat = verts[count].lng = NAN;
+	return count + 1;
+}
+
+/*
+ * Prepares the polygon for h3_region_contains() at the resolution
+ */
+Datum
+h3_region_prepare(PG_FUNCTION_ARGS)
+{
+	GeoPolygon	polygon = {0};
+	int			resolution;
+	H3Index    *full;
+	H3Index    *partial;
+	H3Index    *boundary;
+	H3Index    *interior;
+	H3Index    *compacted = NULL;
+	int64		numFull;
+	int64		numPartial;
+	int64		numBoundary = 0;
+	int64		numInterior;
+	int64		numCompacted = 0;
+	int64		maxVerts;
+	uint32		numVerts = 0;
+	uint32		numEdges = 0;
+	uint32		maxEdges;
+	LatLng	   *verts;
+	uint32	   *edges;
+	H3RegionCell *cells;
+	EdgeGrid	grid;
+	H3Region   *region;
+	H3RegionArrays arrays;
+	Size		size;
+	bool		transmeridian;
+	H3StatTimer timer;
+
+	h3_stats_begin(&timer);
+
+	polygonArgsToGeoPolygon(fcinfo, &polygon);
+	ASSERT(!PG_ARGISNULL(2), ERRCODE_NULL_VALUE_NOT_ALLOWED,
+		   "resolution must not be NULL");
+	resolution = PG_GETARG_INT32(2);
+	if (resolution < 0 || resolution > MAX_H3_RES)
+		h3_assert(E_RES_DOMAIN);
+
+	/* boundary cells: those partly inside and their neighbors */
+	partial = polygonCells(&polygon, resolution, CONTAINMENT_OVERLAPPING, &numPartial);
+	full = polygonCells(&polygon, resolution, CONTAINMENT_FULL, &numFull);
+	numPartial = subtractCells(partial, numPartial, full, numFull);
+	boundary = palloc_extended(Max(numPartial, 1) * 7 * sizeof(H3Index),
+							   MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
+	for (int64 i = 0; i < numPartial; i++)
+		h3_assert(gridDisk(partial[i], 1, boundary + i * 7));
+	numBoundary = sortUniqueCells(boundary, numPartial * 7);
+	pfree(partial);
+
+	/* the rest of the cells inside, compacted */
+	interior = full;
+	numInterior = subtractCells(interior, numFull, boundary, numBoundary);
+	if (numInterior > 0)
+	{
+		compacted = palloc_extended(numInterior * sizeof(H3Index),
+									MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
+		h3_assert(compactCells(interior, compacted, numInterior));
+		numCompacted = sortUniqueCells(compacted, numInterior);
+	}
+	pfree(interior);
+
+	/* rings */
+	transmeridian = geoLoopIsTransmeridian(&polygon.geoloop);
+	maxVerts = polygon.geoloop.numVerts + 2;
+	for (int i = 0; i < polygon.numHoles; i++)
+		maxVerts += polygon.holes[i].numVerts + 2;
+	ASSERT(maxVerts < PG_INT32_MAX && numBoundary < PG_INT32_MAX,
+		   ERRCODE_PROGRAM_LIMIT_EXCEEDED, "polygon is too large to prepare");
+	verts = palloc_extended(maxVerts * sizeof(LatLng), MCXT_ALLOC_HUGE);
+	numVerts = regionAppendRing(verts, numVerts, &polygon.geoloop, transmeridian);
+	for (int i = 0; i < polygon.numHoles; i++)
+		numVerts = regionAppendRing(verts, numVerts, &polygon.holes[i], transmeridian);
+	edgeGridBuild(&grid, verts, numVerts);
+
+	/* center and nearby edges of each boundary cell */
+	cells = palloc_extended(Max(numBoundary, 1) * sizeof(H3RegionCell),
+							MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
+	maxEdges = Max(numVerts, 16);
+	edges = palloc_extended(maxEdges * sizeof(uint32), MCXT_ALLOC_HUGE);
+	for (int64 i = 0; i < numBoundary; i++)
+	{
+		H3RegionCell *cell = &cells[i];
+		CellBoundary cellBoundary;
+		double		marginLat;
+		double		marginLng;
+		uint32		found;
+
+		cell->cell = boundary[i];
+		h3_assert(cellToLatLng(boundary[i], &cell->center));
+		h3_assert(cellToBoundary(boundary[i], &cellBoundary));
+		cell->center.lng = regionLng(cell->center.lng, transmeridian);
+
+		cell->low = cell->high = cell->center;
+		for (int v = 0; v < cellBoundary.numVerts; v++)
+		{
+			LatLng		vert = cellBoundary.verts[v];
+
+			vert.lng = regionLng(vert.lng, transmeridian);
+			cell->low.lat = Min(cell->low.lat, vert.lat);
+			cell->low.lng = Min(cell->low.lng, vert.lng);
+			cell->high.lat = Max(cell->high.lat, vert.lat);
+			cell->high.lng = Max(cell->high.lng, vert.lng);
+		}
+		marginLat = (cell->high.lat - cell->low.lat) * H3_REGION_CELL_MARGIN;
+		marginLng = (cell->high.lng - cell->low.lng) * H3_REGION_CELL_MARGIN;
+		cell->low.lat -= marginLat;
+		cell->low.lng -= marginLng;
+		cell->high.lat += marginLat;
+		cell->high.lng += marginLng;
+
+		/* ray cast from the center through the buckets of its row */
+		cell->centerInside = false;
+		if (cell->center.lat >= grid.low.lat && cell->center.lat <= grid.high.lat)
+		{
+			LatLng		rayEnd = {cell->center.lat, grid.high.lng};
+
+			found = edgeGridCollect(&grid, &cell->center, &rayEnd);
+			for (uint32 j = 0; j < found; j++)
+			{
+				uint32		edge = grid.found[j];
+
+				if (rayCrossesEdge(&cell->center, &verts[edge], &verts[edge + 1]))
+					cell->centerInside = !cell->centerInside;
+			}
+		}
+
+		cell->firstEdge = numEdges;
+		found = edgeGridCollect(&grid, &cell->low, &cell->high);
+		for (uint32 j = 0; j < found; j++)
+		{
+			uint32		edge = grid.found[j];
+			LatLng		low;
+			LatLng		high;
+
+			edgeBox(verts, edge, &low, &high);
+			if (high.lat < cell->low.lat || low.lat > cell->high.lat
+				|| high.lng < cell->low.lng || low.lng > cell->high.lng)
+				continue;
+
+			if (numEdges == maxEdges)
+			{
+				ASSERT(maxEdges < PG_INT32_MAX / 2, ERRCODE_PROGRAM_LIMIT_EXCEEDED,
+					   "polygon is too large to prepare");
+				maxEdges *= 2;
+				edges = repalloc_huge(edges, maxEdges * sizeof(uint32));
+			}
+			edges[numEdges++] = edge;
+		}
+		cell->numEdges = numEdges - cell->firstEdge;
+	}
+
+	/* serialize */
+	region = palloc0(sizeof(H3Region));
+	region->numInterior = numCompacted;
+	region->numBoundary = numBoundary;
+	region->numVerts = numVerts;
+	region->numEdges = numEdges;
+	size = regionLayout(region, &arrays);
+	ASSERT(AllocSizeIsValid(size), ERRCODE_PROGRAM_LIMIT_EXCEEDED,
+		   "polygon is too large to prepare");
+
+	region = palloc0(size);
+	SET_VARSIZE(region, size);
+	region->magic = H3_REGION_MAGIC;
+	region->version = H3_REGION_VERSION;
+	region->resolution = resolution;
+	region->transmeridian = transmeridian;
+	region->numInterior = numCompacted;
+	region->numBoundary = numBoundary;
+	region->numVerts = numVerts;
+	region->numEdges = numEdges;
+	regionLayout(region, &arrays);
+
+	for (int64 i = 0; i < numCompacted; i++)
+	{
+		arrays.interior[i] = compacted[i];
+		region->interiorResolutions |= 1 << h3index_res(compacted[i]);
+	}
+	if (numBoundary > 0)
+		memcpy(arrays.boundary, cells, numBoundary * sizeof(H3RegionCell));
+	if (numVerts > 0)
+		memcpy(arrays.verts, verts, numVerts * sizeof(LatLng));
+	if (numEdges > 0)
+		memcpy(arrays.edges, edges, numEdges * sizeof(uint32));
+
+	h3_stats_end(&timer, H3_STAT_REGION_PREPARE, numCompacted + numBoundary);
+	PG_RETURN_BYTEA_P(region);
+}
+
+/*
+ * Whether the prepared region contains the point
+ */
+Datum
+h3_region_contains(PG_FUNCTION_ARGS)
+{
+	const H3Region *region = regionGetArg(fcinfo, 0);
+	Point	   *point = PG_GETARG_POINT_P(1);
+	LatLng		location;
+	H3Index		cell;
+
+	location.lng = degsToRads(point->x);
+	location.lat = degsToRads(point->y);
+	h3_assert(latLngToCell(&location, region->resolution, &cell));
+	location.lng = regionLng(location.lng, region->transmeridian);
+
+	PG_RETURN_BOOL(regionContains(region, cell, &location));
+}
+
 /* ---------------------------------------------------------------------------
  * The GeoPolygon, LinkedLatLng, LinkedLatLng,
  * LinkedGeoLoop, and LinkedGeoPolygon
@@ -25,6 +25,7 @@
 #include "error.h"
 #include "type.h"
 #include "srf.h"
+#include "stats.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_grid_disk);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_grid_disk_distances);
@@ -80,16 +81,20 @@ h3_grid_disk(PG_FUNCTION_ARGS)
 
 		int64_t		max;
 		H3Index    *indices;
+		H3StatTimer timer;
 
 		/* get function arguments */
 		H3Index		origin = PG_GETARG_H3INDEX(0);
 		int			k = ensure_nonnegative_k(PG_GETARG_INT32(1));
 
+		h3_stats_begin(&timer);
+
 		h3_assert(maxGridDiskSize(k, &max));
 
 		indices = palloc_h3_array_checked(max, sizeof(H3Index), true);
 
 		h3_assert(gridDisk(origin, k, indices));
+		h3_stats_end_cells(&timer, H3_STAT_GRID_DISK, indices, max);
 
 		funcctx->user_fctx = indices;
 		funcctx->max_calls = max;
@@ -130,6 +135,9 @@ h3_grid_disk_distances(PG_FUNCTION_ARGS)
 		/* returning */
 		int64_t		maxSize;
 		hexDistanceTuple *user_fctx;
+		H3StatTimer timer;
+
+		h3_stats_begin(&timer);
 
 		h3_assert(maxGridDiskSize(k, &maxSize));
 
@@ -139,6 +147,7 @@ h3_grid_disk_distances(PG_FUNCTION_ARGS)
 		user_fctx->distances = palloc_h3_array_checked(maxSize, sizeof(int), true);
 
 		h3_assert(gridDiskDistances(origin, k, user_fctx->indices, user_fctx->distances));
+		h3_stats_end_cells(&timer, H3_STAT_GRID_DISK_DISTANCES, user_fctx->indices, maxSize);
 
 		ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
 
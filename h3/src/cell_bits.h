@@ -0,0 +1,241 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_CELL_BITS_H
+#define H3_CELL_BITS_H
+
+/*
+ * Inline equivalents of the H3 hierarchy functions, working directly on the
+ * index bits. They skip the library call and its per-call checks, so callers
+ * validate their input once with the matching *_error() function, or know
+ * it to be valid (e.g. keys already stored in an index).
+ */
+
+#include <h3api.h>
+#include <common/hashfn.h>	  // murmurhash32
+#include <port/pg_bitutils.h> // pg_leftmost_one_pos64
+
+#include "upstream_macros.h"
+
+/* Low 45 bits holding all 15 encoded H3 index digits. */
+#define H3_INDEX_DIGITS_MASK UINT64_C(0x1fffffffffff)
+
+/* Lowest bit of each of the 15 digits */
+#define H3_INDEX_DIGITS_LOW_BITS UINT64_C(0x49249249249)
+
+#define H3_BASE_CELL_OFFSET 45
+#define H3_BASE_CELL_MASK UINT64_C(127)
+#define H3_NUM_BASE_CELLS 122
+
+/* Reserved high bit, mode and mode-dependent bits of a cell: mode 1 only */
+#define H3_HEADER_OFFSET 56
+#define H3_CELL_HEADER UINT64_C(0x08)
+
+/* Bit set of the 12 pentagon base cells */
+#define H3_PENTAGON_BASE_CELLS_LO \
+	((UINT64_C(1) << 4) | (UINT64_C(1) << 14) | (UINT64_C(1) << 24) | \
+	 (UINT64_C(1) << 38) | (UINT64_C(1) << 49) | (UINT64_C(1) << 58) | \
+	 (UINT64_C(1) << 63))
+#define H3_PENTAGON_BASE_CELLS_HI \
+	((UINT64_C(1) << (72 - 64)) | (UINT64_C(1) << (83 - 64)) | \
+	 (UINT64_C(1) << (97 - 64)) | (UINT64_C(1) << (107 - 64)) | \
+	 (UINT64_C(1) << (117 - 64)))
+
+static inline int
+h3index_res(H3Index h)
+{
+	return (int) ((h & H3_RES_MASK) >> H3_RES_OFFSET);
+}
+
+static inline int
+h3index_base_cell(H3Index h)
+{
+	return (int) ((h >> H3_BASE_CELL_OFFSET) & H3_BASE_CELL_MASK);
+}
+
+/* Digits finer than the given resolution */
+static inline uint64
+h3index_digits_below(int res)
+{
+	return H3_INDEX_DIGITS_MASK >> (res * H3_PER_DIGIT_OFFSET);
+}
+
+/* Digits of resolutions fromRes + 1 to toRes */
+static inline uint64
+h3index_digits_between(int fromRes, int toRes)
+{
+	return h3index_digits_below(fromRes) & ~h3index_digits_below(toRes);
+}
+
+/*
+ * Compare only the index digits that participate in the shared-resolution
+ * prefix, ignoring deeper child digits from the finer input.
+ */
+static inline uint64
+h3index_prefix_digit_diff(H3Index a, H3Index b, int sharedRes)
+{
+	int			ignoredBits = (MAX_H3_RES - sharedRes) * H3_PER_DIGIT_OFFSET;
+
+	return ((((uint64) (a ^ b)) & H3_INDEX_DIGITS_MASK) >> ignoredBits);
+}
+
+static inline bool
+h3index_is_pentagon_base_cell(int baseCell)
+{
+	uint64		bits = baseCell < 64 ? H3_PENTAGON_BASE_CELLS_LO : H3_PENTAGON_BASE_CELLS_HI;
+
+	return (bits >> (baseCell & 63)) & 1;
+}
+
+static inline bool
+h3index_is_pentagon_fast(H3Index h)
+{
+	return h3index_is_pentagon_base_cell(h3index_base_cell(h)) &&
+		(h & h3index_digits_between(0, h3index_res(h))) == 0;
+}
+
+/*
+ * Bitwise equivalent of upstream isValidCell. Apart from the leading digit
+ * check of pentagons it has no data-dependent branches, so loops over arrays
+ * of cells vectorize.
+ */
+static inline bool
+h3index_is_valid_cell_fast(H3Index h)
+{
+	int			res = h3index_res(h);
+	uint64		unused = h3index_digits_below(res);
+	uint64		digits = h & H3_INDEX_DIGITS_MASK & ~unused;
+	uint64		sevens = digits & (digits >> 1) & (digits >> 2) & H3_INDEX_DIGITS_LOW_BITS;
+	bool		valid = ((h >> H3_HEADER_OFFSET) == H3_CELL_HEADER) &
+		(h3index_base_cell(h) < H3_NUM_BASE_CELLS) &
+		((h & unused) == unused) &
+		(sevens == 0);
+
+	/* pentagons have no children in the deleted K axes direction */
+	if (valid && digits != 0 && h3index_is_pentagon_base_cell(h3index_base_cell(h)))
+	{
+		int			leading = pg_leftmost_one_pos64(digits);
+
+		leading -= leading % H3_PER_DIGIT_OFFSET;
+		valid = ((digits >> leading) & H3_DIGIT_MASK) != K_AXES_DIGIT;
+	}
+	return valid;
+}
+
+/* Errors of cellToParent() */
+static inline H3Error
+h3index_cell_to_parent_error(H3Index h, int parentRes)
+{
+	if (parentRes < 0 || parentRes > MAX_H3_RES)
+		return E_RES_DOMAIN;
+	if (parentRes > h3index_res(h))
+		return E_RES_MISMATCH;
+	return E_SUCCESS;
+}
+
+/*
+ * Bitwise equivalent of upstream cellToParent for already-validated input.
+ * The H3 encoding fills child digits beyond the new resolution with 7.
+ */
+static inline H3Index
+h3index_cell_to_parent_fast(H3Index h, int parentRes)
+{
+	H3_SET_RESOLUTION(h, parentRes);
+	return h | h3index_digits_below(parentRes);
+}
+
+/* Errors of cellToCenterChild() */
+static inline H3Error
+h3index_cell_to_center_child_error(H3Index h, int childRes)
+{
+	if (childRes < h3index_res(h) || childRes > MAX_H3_RES)
+		return E_RES_DOMAIN;
+	return E_SUCCESS;
+}
+
+/* Bitwise equivalent of upstream cellToCenterChild: new digits are 0. */
+static inline H3Index
+h3index_cell_to_center_child_fast(H3Index h, int childRes)
+{
+	uint64		digits = h3index_digits_between(h3index_res(h), childRes);
+
+	H3_SET_RESOLUTION(h, childRes);
+	return h & ~digits;
+}
+
+/* Returns true if a equals b or is one of its ancestors */
+static inline bool
+h3index_is_ancestor_fast(H3Index a, H3Index b)
+{
+	int			aRes = h3index_res(a);
+
+	return aRes <= h3index_res(b) && h3index_cell_to_parent_fast(b, aRes) == a;
+}
+
+/*
+ * First and last descendant of a cell at the given resolution in h3index
+ * order, i.e. its center child and the child with all new digits 6. Every
+ * descendant at that resolution lies between the two.
+ */
+static inline void
+h3index_descendant_range(H3Index h, int res, H3Index *first, H3Index *last)
+{
+	uint64		digits = h3index_digits_between(h3index_res(h), res);
+
+	*first = h3index_cell_to_center_child_fast(h, res);
+	*last = *first | (digits & (UINT64_C(0x0db6db6db6db6db6) & H3_INDEX_DIGITS_MASK));
+}
+
+/*
+ * Position of a cell among the descendants of its parent at parentRes, in
+ * the order of cellToChildPos(). Returns false for pentagon parents, whose
+ * deleted subsequence makes positions irregular: those go to the library.
+ * Input resolutions must have been checked with
+ * h3index_cell_to_parent_error().
+ */
+static inline bool
+h3index_cell_to_child_pos_fast(H3Index child, int parentRes, int64_t *pos, H3Error *error)
+{
+	int			childRes = h3index_res(child);
+	int64_t		out = 0;
+
+	if (h3index_is_pentagon_fast(h3index_cell_to_parent_fast(child, parentRes)))
+		return false;
+
+	*error = E_SUCCESS;
+	for (int res = parentRes + 1; res <= childRes; res++)
+	{
+		int			digit = H3_GET_INDEX_DIGIT(child, res);
+
+		if (digit == INVALID_DIGIT)
+		{
+			*error = E_CELL_INVALID;
+			return true;
+		}
+		out = out * 7 + digit;
+	}
+	*pos = out;
+	return true;
+}
+
+/* Hash of a cell: murmurhash64 needs PostgreSQL 17, so fold it in half */
+static inline uint32
+h3index_hash32(H3Index h)
+{
+	return murmurhash32((uint32) (h ^ (h >> 32)));
+}
+
+#endif /* H3_CELL_BITS_H */
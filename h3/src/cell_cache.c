@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+
+#include <access/htup_details.h> // heap_form_tuple
+#include <fmgr.h>				 // PG_FUNCTION_INFO_V1
+#include <funcapi.h>			 // get_call_result_type
+
+#include "cell_cache.h"
+#include "error.h"
+#include "guc.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_cache_stats);
+
+static H3CellCacheState state;
+
+void
+_cell_cache_init(void)
+{
+	state.capacity = &h3_guc_cell_cache_size;
+	dlist_init(&state.lru);
+	*find_rendezvous_variable(H3_CELL_CACHE_RENDEZVOUS) = &state;
+}
+
+/* Reports the size and counters of the cell cache of this backend */
+Datum
+h3_cell_cache_stats(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tuple_desc;
+	Datum		values[5];
+	bool		nulls[5] = {false};
+
+	ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
+	tuple_desc = BlessTupleDesc(tuple_desc);
+
+	values[0] = Int64GetDatum(h3_cell_cache_entries(&state));
+	values[1] = Int32GetDatum(h3_guc_cell_cache_size);
+	values[2] = Int64GetDatum(state.hits);
+	values[3] = Int64GetDatum(state.misses);
+	values[4] = Int64GetDatum(state.evictions);
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tuple_desc, values, nulls)));
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <access/htup_details.h> // heap_form_tuple
+#include <fmgr.h>				 // PG_FUNCTION_ARGS
+#include <funcapi.h>			 // SRF_IS_FIRSTCALL
+#include <utils/array.h>		 // ArrayType
+#include <utils/builtins.h>		 // text_to_cstring
+
+#include "cell_bits.h"
+#include "error.h"
+#include "type.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_grid_disk_convolve);
+
+/* Weighted sum of the input values around one cell */
+typedef struct
+{
+	H3Index		cell;
+	char		status;			/* used by simplehash */
+	double		value;
+}			ConvolveEntry;
+
+#define SH_PREFIX convolve
+#define SH_ELEMENT_TYPE ConvolveEntry
+#define SH_KEY_TYPE H3Index
+#define SH_KEY cell
+#define SH_HASH_KEY(tb, key) h3index_hash32(key)
+#define SH_EQUAL(tb, a, b) ((a) == (b))
+#define SH_SCOPE static inline
+#define SH_DECLARE
+#define SH_DEFINE
+#include <lib/simplehash.h>
+
+static int
+convolve_entry_cmp(const void *a, const void *b)
+{
+	H3Index		cellA = ((const ConvolveEntry *) a)->cell;
+	H3Index		cellB = ((const ConvolveEntry *) b)->cell;
+
+	return cellA < cellB ? -1 : cellA > cellB;
+}
+
+/* Fills the weight of each grid distance from 0 to k */
+static void
+kernel_weights(const char *kernel, int k, double *weights)
+{
+	if (strcmp(kernel, "uniform") == 0)
+	{
+		for (int d = 0; d <= k; d++)
+			weights[d] = 1;
+	}
+	else if (strcmp(kernel, "linear") == 0)
+	{
+		for (int d = 0; d <= k; d++)
+			weights[d] = 1 - (double) d / (k + 1);
+	}
+	else
+		ASSERT(0, ERRCODE_INVALID_PARAMETER_VALUE, "Kernel must be uniform or linear.");
+}
+
+/*
+ * Sums the values of the cells within k grid steps of every cell reached,
+ * weighted by the kernel of their grid distance.
+ *
+ * Each input cell adds its weighted value to the cells of its disk in one
+ * hash table, instead of producing a row per disk cell to aggregate.
+ */
+Datum
+h3_grid_disk_convolve(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	ConvolveEntry *results;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		ArrayType  *cellsArray = PG_GETARG_ARRAYTYPE_P(0);
+		ArrayType  *valuesArray = PG_GETARG_ARRAYTYPE_P(1);
+		int			k = PG_GETARG_INT32(2);
+		char	   *kernel = text_to_cstring(PG_GETARG_TEXT_PP(3));
+		int			numCells = ArrayGetNItems(ARR_NDIM(cellsArray), ARR_DIMS(cellsArray));
+		const H3Index *cells = (const H3Index *) ARR_DATA_PTR(cellsArray);
+		const double *values = (const double *) ARR_DATA_PTR(valuesArray);
+		double	   *weights;
+		int64_t		diskSize;
+		H3Index    *disk;
+		int		   *distances;
+		convolve_hash *sums;
+		convolve_iterator iterator;
+		ConvolveEntry *entry;
+		int			numResults = 0;
+		TupleDesc	tupdesc;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		ASSERT(!array_contains_nulls(cellsArray) && !array_contains_nulls(valuesArray),
+			   ERRCODE_NULL_VALUE_NOT_ALLOWED,
+			   "cells and values arrays must not contain NULL values");
+		ASSERT(ArrayGetNItems(ARR_NDIM(valuesArray), ARR_DIMS(valuesArray)) == numCells,
+			   ERRCODE_ARRAY_SUBSCRIPT_ERROR,
+			   "cells and values arrays must have the same length");
+		ASSERT(k >= 0, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "grid traversal distance k must be non-negative");
+
+		weights = palloc(sizeof(double) * (k + 1));
+		kernel_weights(kernel, k, weights);
+
+		h3_assert(maxGridDiskSize(k, &diskSize));
+		ASSERT((uint64) diskSize <= MaxAllocSize / sizeof(H3Index),
+			   ERRCODE_PROGRAM_LIMIT_EXCEEDED, "too many grid traversal cells");
+		disk = palloc(sizeof(H3Index) * diskSize);
+		distances = palloc(sizeof(int) * diskSize);
+
+		sums = convolve_create(CurrentMemoryContext, Max(numCells, 16), NULL);
+		for (int i = 0; i < numCells; i++)
+		{
+			memset(disk, 0, sizeof(H3Index) * diskSize);
+			h3_assert(gridDiskDistances(cells[i], k, disk, distances));
+
+			for (int64_t j = 0; j < diskSize; j++)
+			{
+				bool		found;
+
+				/* pentagons leave holes in the output */
+				if (disk[j] == H3_NULL)
+					continue;
+
+				entry = convolve_insert(sums, disk[j], &found);
+				if (!found)
+					entry->value = 0;
+				entry->value += weights[distances[j]] * values[i];
+			}
+		}
+
+		results = palloc_extended(sizeof(ConvolveEntry) * Max(sums->members, 1),
+								  MCXT_ALLOC_HUGE);
+		convolve_start_iterate(sums, &iterator);
+		while ((entry = convolve_iterate(sums, &iterator)) != NULL)
+			results[numResults++] = *entry;
+		qsort(results, numResults, sizeof(ConvolveEntry), convolve_entry_cmp);
+		convolve_destroy(sums);
+
+		ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tupdesc));
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+		funcctx->user_fctx = results;
+		funcctx->max_calls = numResults;
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	results = (ConvolveEntry *) funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		const ConvolveEntry *result = &results[funcctx->call_cntr];
+		Datum		values[2];
+		bool		nulls[2] = {0};
+
+		values[0] = H3IndexGetDatum(result->cell);
+		values[1] = Float8GetDatum(result->value);
+		SRF_RETURN_NEXT(funcctx,
+						HeapTupleGetDatum(heap_form_tuple(funcctx->tuple_desc, values, nulls)));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
@@ -21,6 +21,8 @@
 
 bool		h3_guc_strict = false;
 bool		h3_guc_extend_antimeridian = false;
+bool		h3_guc_track_stats = false;
+int			h3_guc_cell_cache_size = 0;
 
 void
 _guc_init(void)
@@ -75,4 +77,60 @@ _guc_init(void)
 							 NULL,
 							 NULL,
 							 NULL);
+
+	/*
+	 * @guc-doc h3.track_stats
+	 * Recommended: false, enable while investigating performance.
+	 *
+	 * true: collect call counts, timings, cells produced and memory growth of
+	 * the heavier h3 and h3_postgis functions, and call counts of the GiST and
+	 * SP-GiST support functions, reported by the h3_stat_functions view.
+	 * Statistics are shared between sessions only when h3 is listed in
+	 * shared_preload_libraries, otherwise each session sees its own.
+	 *
+	 * false: do not collect statistics.
+	 *
+	 * Example:
+	 *   SET h3.track_stats TO true;
+	 *   SELECT * FROM h3_stat_functions WHERE calls > 0;
+	 */
+	DefineCustomBoolVariable("h3.track_stats",
+							 "Collect execution statistics of h3 functions.",
+							 "Statistics are reported by the h3_stat_functions view.",
+							 &h3_guc_track_stats,
+							 false,
+							 PGC_SUSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	/*
+	 * @guc-doc h3.cell_cache_size
+	 * Recommended: the default (off), set it for dashboards rendering the
+	 * same cells over and over.
+	 *
+	 * Number of cells whose boundary and area are kept in a per-session LRU
+	 * cache shared by h3_cell_to_boundary, h3_cell_to_boundary_wkb and
+	 * h3_cell_area. Each cell takes about 250 bytes, so the maximum of
+	 * 1048576 cells is about 250 MB per backend.
+	 *
+	 * 0 (default): disable the cache and free its memory.
+	 *
+	 * Example:
+	 *   SET h3.cell_cache_size TO 100000;
+	 *   SELECT * FROM h3_cell_cache_stats();
+	 */
+	DefineCustomIntVariable("h3.cell_cache_size",
+							"Number of cells kept in the cell geometry cache.",
+							"Caches boundaries and areas of recently used cells.",
+							&h3_guc_cell_cache_size,
+							0,
+							0,
+							1024 * 1024,
+							PGC_USERSET,
+							0,
+							NULL,
+							NULL,
+							NULL);
 }
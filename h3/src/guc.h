@@ -19,6 +19,8 @@
 
 extern bool h3_guc_strict;
 extern bool h3_guc_extend_antimeridian;
+extern bool h3_guc_track_stats;
+extern int	h3_guc_cell_cache_size;
 
 void _guc_init(void);
 
@@ -0,0 +1,344 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <fmgr.h>			   // PG_FUNCTION_ARGS
+#include <access/hash.h>	   // hash_any
+#include <libpq/pqformat.h>	   // pq_sendint64
+#include <utils/sortsupport.h> // SortSupport
+
+#include "cell_bits.h"
+#include "error.h"
+#include "type.h"
+
+/*
+ * h3cell stores a cell of resolution 0 to 10 in 5 bytes instead of 8.
+ *
+ * The mode bits and the trailing unused digits of an h3index are constant,
+ * so only the resolution, base cell and used digits are kept. The 40-bit key
+ * holds res * 122 + base cell in its top 11 bits and the used digits as a
+ * base 7 number in the low 29 bits (7^10 < 2^29). Keys of valid cells sort
+ * exactly like the cells themselves, and are stored big-endian so that
+ * memcmp() gives that order too.
+ */
+
+#define H3CELL_SIZE 5
+#define H3CELL_MAX_RES 10
+#define H3CELL_DIGITS_BITS 29
+#define H3CELL_DIGITS_MASK ((UINT64_C(1) << H3CELL_DIGITS_BITS) - 1)
+
+typedef struct
+{
+	uint8		key[H3CELL_SIZE];
+}			H3Cell;
+
+#define PG_GETARG_H3CELL_P(n) ((H3Cell *) PG_GETARG_POINTER(n))
+
+/* conversion */
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3cell_in);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3cell_out);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3cell_recv);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3cell_send);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3cell_to_h3index);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_to_h3cell);
+
+/* b-tree and hash support */
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3cell_cmp);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3cell_h3index_cmp);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_h3cell_cmp);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3cell_sortsupport);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3cell_hash);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3cell_hash_extended);
+
+static uint64
+h3cell_get_key(const H3Cell * cell)
+{
+	uint64		key = 0;
+
+	for (int i = 0; i < H3CELL_SIZE; i++)
+		key = (key << 8) | cell->key[i];
+	return key;
+}
+
+static H3Cell *
+h3cell_from_key(uint64 key)
+{
+	H3Cell	   *cell = palloc(sizeof(H3Cell));
+
+	for (int i = H3CELL_SIZE - 1; i >= 0; i--)
+	{
+		cell->key[i] = (uint8) key;
+		key >>= 8;
+	}
+	return cell;
+}
+
+/* Key of a valid cell of resolution up to H3CELL_MAX_RES */
+static uint64
+h3cell_key_of(H3Index index)
+{
+	int			res = h3index_res(index);
+	uint64		digits = 0;
+
+	for (int r = 1; r <= res; r++)
+		digits = digits * 7 + H3_GET_INDEX_DIGIT(index, r);
+
+	return ((uint64) (res * H3_NUM_BASE_CELLS + h3index_base_cell(index)) << H3CELL_DIGITS_BITS) | digits;
+}
+
+/* Inverse of h3cell_key_of, without any checks */
+static H3Index
+h3cell_index_of(uint64 key)
+{
+	int			header = (int) (key >> H3CELL_DIGITS_BITS);
+	int			res = header / H3_NUM_BASE_CELLS;
+	uint64		digits = key & H3CELL_DIGITS_MASK;
+	H3Index		index = (H3_CELL_HEADER << H3_HEADER_OFFSET) |
+		((uint64) res << H3_RES_OFFSET) |
+		((uint64) (header % H3_NUM_BASE_CELLS) << H3_BASE_CELL_OFFSET) |
+		h3index_digits_below(res);
+
+	for (int r = res; r > 0; r--)
+	{
+		index |= (digits % 7) << ((MAX_H3_RES - r) * H3_PER_DIGIT_OFFSET);
+		digits /= 7;
+	}
+	return index;
+}
+
+static H3Index
+h3cell_get_index(const H3Cell * cell)
+{
+	return h3cell_index_of(h3cell_get_key(cell));
+}
+
+static H3Cell *
+h3cell_from_index(H3Index index)
+{
+	if (!h3index_is_valid_cell_fast(index))
+		h3_assert(E_CELL_INVALID);
+
+	if (h3index_res(index) > H3CELL_MAX_RES)
+		ereport(ERROR,
+				(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+				 errmsg("h3cell holds cells up to resolution %d, got resolution %d",
+						H3CELL_MAX_RES, h3index_res(index)),
+				 errhint("Use h3index for finer cells.")));
+
+	return h3cell_from_key(h3cell_key_of(index));
+}
+
+static int
+h3cell_compare(const H3Cell * a, const H3Cell * b)
+{
+	return memcmp(a->key, b->key, H3CELL_SIZE);
+}
+
+/* textual input/output functions, same format as h3index */
+Datum
+h3cell_in(PG_FUNCTION_ARGS)
+{
+	char	   *string = PG_GETARG_CSTRING(0);
+	H3Index		index;
+
+	h3_assert(stringToH3(string, &index));
+
+	PG_RETURN_POINTER(h3cell_from_index(index));
+}
+
+Datum
+h3cell_out(PG_FUNCTION_ARGS)
+{
+	H3Cell	   *cell = PG_GETARG_H3CELL_P(0);
+	char	   *string = palloc(17 * sizeof(char));
+
+	h3_assert(h3ToString(h3cell_get_index(cell), string, 17));
+
+	PG_RETURN_CSTRING(string);
+}
+
+/* binary input/output functions, same wire format as h3index */
+Datum
+h3cell_recv(PG_FUNCTION_ARGS)
+{
+	StringInfo	buf = (StringInfo) PG_GETARG_POINTER(0);
+
+	PG_RETURN_POINTER(h3cell_from_index(pq_getmsgint64(buf)));
+}
+
+Datum
+h3cell_send(PG_FUNCTION_ARGS)
+{
+	H3Cell	   *cell = PG_GETARG_H3CELL_P(0);
+	StringInfoData buf;
+
+	pq_begintypsend(&buf);
+	pq_sendint64(&buf, h3cell_get_index(cell));
+
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+/* h3index conversion functions */
+Datum
+h3cell_to_h3index(PG_FUNCTION_ARGS)
+{
+	H3Cell	   *cell = PG_GETARG_H3CELL_P(0);
+
+	PG_RETURN_H3INDEX(h3cell_get_index(cell));
+}
+
+Datum
+h3index_to_h3cell(PG_FUNCTION_ARGS)
+{
+	H3Index		index = PG_GETARG_H3INDEX(0);
+
+	PG_RETURN_POINTER(h3cell_from_index(index));
+}
+
+/*
+ * Comparisons. Cells compare by their keys, which sort like the h3index
+ * values, so cross-type comparisons decode the h3cell side.
+ */
+#define H3CELL_CMP_A_B h3cell_compare(PG_GETARG_H3CELL_P(0), PG_GETARG_H3CELL_P(1))
+#define H3CELL_CMP_A_I h3index_compare(h3cell_get_index(PG_GETARG_H3CELL_P(0)), PG_GETARG_H3INDEX(1))
+#define H3CELL_CMP_I_A h3index_compare(PG_GETARG_H3INDEX(0), h3cell_get_index(PG_GETARG_H3CELL_P(1)))
+
+static int
+h3index_compare(H3Index a, H3Index b)
+{
+	return (a > b) - (a < b);
+}
+
+#define H3CELL_OPERATOR(name, cmp, test) \
+	PGDLLEXPORT PG_FUNCTION_INFO_V1(name); \
+	Datum \
+	name(PG_FUNCTION_ARGS) \
+	{ \
+		PG_RETURN_BOOL(cmp test 0); \
+	}
+
+H3CELL_OPERATOR(h3cell_eq, H3CELL_CMP_A_B, ==)
+H3CELL_OPERATOR(h3cell_ne, H3CELL_CMP_A_B, !=)
+H3CELL_OPERATOR(h3cell_lt, H3CELL_CMP_A_B, <)
+H3CELL_OPERATOR(h3cell_le, H3CELL_CMP_A_B, <=)
+H3CELL_OPERATOR(h3cell_gt, H3CELL_CMP_A_B, >)
+H3CELL_OPERATOR(h3cell_ge, H3CELL_CMP_A_B, >=)
+
+H3CELL_OPERATOR(h3cell_h3index_eq, H3CELL_CMP_A_I, ==)
+H3CELL_OPERATOR(h3cell_h3index_ne, H3CELL_CMP_A_I, !=)
+H3CELL_OPERATOR(h3cell_h3index_lt, H3CELL_CMP_A_I, <)
+H3CELL_OPERATOR(h3cell_h3index_le, H3CELL_CMP_A_I, <=)
+H3CELL_OPERATOR(h3cell_h3index_gt, H3CELL_CMP_A_I, >)
+H3CELL_OPERATOR(h3cell_h3index_ge, H3CELL_CMP_A_I, >=)
+
+H3CELL_OPERATOR(h3index_h3cell_eq, H3CELL_CMP_I_A, ==)
+H3CELL_OPERATOR(h3index_h3cell_ne, H3CELL_CMP_I_A, !=)
+H3CELL_OPERATOR(h3index_h3cell_lt, H3CELL_CMP_I_A, <)
+H3CELL_OPERATOR(h3index_h3cell_le, H3CELL_CMP_I_A, <=)
+H3CELL_OPERATOR(h3index_h3cell_gt, H3CELL_CMP_I_A, >)
+H3CELL_OPERATOR(h3index_h3cell_ge, H3CELL_CMP_I_A, >=)
+
+Datum
+h3cell_cmp(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_INT32(H3CELL_CMP_A_B);
+}
+
+Datum
+h3cell_h3index_cmp(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_INT32(H3CELL_CMP_A_I);
+}
+
+Datum
+h3index_h3cell_cmp(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_INT32(H3CELL_CMP_I_A);
+}
+
+static int
+h3cell_cmp_full(Datum x, Datum y, SortSupport ssup)
+{
+	return h3cell_compare((H3Cell *) DatumGetPointer(x), (H3Cell *) DatumGetPointer(y));
+}
+
+static int
+h3cell_cmp_abbrev(Datum x, Datum y, SortSupport ssup)
+{
+	if (x == y)
+		return 0;
+	else if (x < y)
+		return -1;
+	else
+		return 1;
+}
+
+static bool
+h3cell_abbrev_abort(int memtupcount, SortSupport ssup)
+{
+	return false;
+}
+
+/* The whole key fits into the abbreviation */
+static Datum
+h3cell_abbrev_convert(Datum original, SortSupport ssup)
+{
+	return (Datum) h3cell_get_key((H3Cell *) DatumGetPointer(original));
+}
+
+/*
+ * Sort support strategy routine
+ */
+Datum
+h3cell_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+
+	ssup->comparator = h3cell_cmp_full;
+	ssup->ssup_extra = NULL;
+	/* Enable sortsupport only on 64 bit Datum */
+	if (ssup->abbreviate && sizeof(Datum) == 8)
+	{
+		ssup->comparator = h3cell_cmp_abbrev;
+		ssup->abbrev_converter = h3cell_abbrev_convert;
+		ssup->abbrev_abort = h3cell_abbrev_abort;
+		ssup->abbrev_full_comparator = h3cell_cmp_full;
+	}
+
+	PG_RETURN_VOID();
+}
+
+/* Hashes like the h3index, so that both types share a hash family */
+Datum
+h3cell_hash(PG_FUNCTION_ARGS)
+{
+	H3Index		index = h3cell_get_index(PG_GETARG_H3CELL_P(0));
+	Datum		hash = hash_any((unsigned char *) &index, sizeof(index));
+
+	PG_RETURN_DATUM(hash);
+}
+
+Datum
+h3cell_hash_extended(PG_FUNCTION_ARGS)
+{
+	H3Index		index = h3cell_get_index(PG_GETARG_H3CELL_P(0));
+	int64_t		seed = PG_GETARG_INT64(1);
+	Datum		hash = hash_any_extended((unsigned char *) &index, sizeof(index), seed);
+
+	PG_RETURN_DATUM(hash);
+}
@@ -21,8 +21,10 @@
 
 #include <fmgr.h> // PG_MODULE_MAGIC
 
+#include "cell_cache.h"
 #include "config.h"
 #include "guc.h"
+#include "stats.h"
 
 /* see https://www.postgresql.org/docs/current/xfunc-c.html#XFUNC-C-DYNLOAD */
 #if POSTGRESQL_VERSION_MAJOR >= 18
@@ -38,4 +40,6 @@ _PG_init(void)
 	/* we could make version number assertion here */
 
 	_guc_init();
+	_stats_init();
+	_cell_cache_init();
 }
@@ -27,9 +27,10 @@
 
 #include <h3api.h>
 #include "algos.h"
+#include "cell_bits.h"
 #include "operators.h"
+#include "stats.h"
 #include "type.h"
-#include "upstream_macros.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_gist_consistent);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_gist_union);
@@ -50,96 +51,42 @@ PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_gist_sortsupport);
  */
 #define GIST_INDEX_TUPLES_PER_PAGE 407
 
-/*
- * Maximum grid distance from a cell's center child to any descendant at the
- * given additional depth. This was verified empirically for both hexagons and
- * pentagons and follows the exact recurrence r(d) = 7 * r(d - 2) + 4.
- */
-static const int64_t gist_descendant_radius[MAX_H3_RES + 1] = {
-	0, 1, 4, 11, 32, 81, 228, 571,
-	1600, 4001, 11204, 28011, 78432, 196081, 549028, 1372571
-};
-
 /* Entry for sorting in picksplit */
 typedef struct
 {
 	OffsetNumber offset;
 	H3Index		key;
+	uint64		sortkey;
 } SortEntry;
 
-/* Candidate next assignment while the greedy split grows inward. */
-typedef struct
-{
-	bool		to_left;
-	H3Index		unionL;
-	H3Index		unionR;
-	float		widen;
-	int			nleft;
-	int			nright;
-} PickSplitMove;
-
-/* Return index itself or its center child at the requested resolution. */
-static inline bool
-h3index_center_child_at(H3Index index, int resolution, H3Index *out)
-{
-	int			index_res = getResolution(index);
-
-	if (index_res == resolution)
-	{
-		*out = index;
-		return true;
-	}
-
-	if (index_res > resolution)
-		return false;
-
-	return cellToCenterChild(index, resolution, out) == E_SUCCESS;
-}
-
 /*
- * Bound the nearest possible descendant distance by comparing center-child
- * representatives across candidate resolutions and subtracting the maximum
- * descendant radius for the indexed subtree at each resolution.
+ * Sort key placing every cell right before its descendants, so that any
+ * subtree is a contiguous range: base cell and digits with the unused digits
+ * cleared, followed by the resolution. The raw h3index order groups by
+ * resolution first and scatters subtrees of mixed-resolution data.
+ * H3_NULL (mixed-base unions) sorts last.
  */
-static double
-h3index_gist_distance_lower_bound(H3Index key, H3Index query)
+static inline uint64
+h3index_gist_sort_key(H3Index key)
 {
-	int			key_res = getResolution(key);
-	int			min_res = Max(key_res, getResolution(query));
-	int64_t		best = INT64_MAX;
-
-	for (int resolution = min_res; resolution <= MAX_H3_RES; resolution++)
-	{
-		H3Index		key_at_resolution;
-		H3Index		query_at_resolution;
-		int64_t		distance;
-
-		if (!h3index_center_child_at(key, resolution, &key_at_resolution) ||
-			!h3index_center_child_at(query, resolution, &query_at_resolution))
-			continue;
-
-		if (gridDistance(key_at_resolution, query_at_resolution, &distance))
-			continue;
-
-		distance = Max(distance - gist_descendant_radius[resolution - key_res], 0);
-		best = Min(best, distance);
-
-		if (best == 0)
-			break;
-	}
+	int			res;
+	uint64		digits;
 
-	if (best == INT64_MAX)
-		return 0.0;
+	if (key == H3_NULL)
+		return PG_UINT64_MAX;
 
-	return (double) best;
+	res = h3index_res(key);
+	digits = key & ((UINT64_C(1) << H3_RES_OFFSET) - 1);
+	digits &= ~h3index_digits_below(res);
+	return (digits << 4) | (uint64) res;
 }
 
 /* qsort comparator for the picksplit input array. */
 static int
 sort_entry_cmp(const void *a, const void *b)
 {
-	H3Index		ka = ((const SortEntry *) a)->key;
-	H3Index		kb = ((const SortEntry *) b)->key;
+	uint64		ka = ((const SortEntry *) a)->sortkey;
+	uint64		kb = ((const SortEntry *) b)->sortkey;
 
 	if (ka < kb)
 		return -1;
@@ -148,7 +95,7 @@ sort_entry_cmp(const void *a, const void *b)
 	return 0;
 }
 
-/* Compare abbreviated H3 datums during sortsupport-driven sorts. */
+/* Compare abbreviated sort keys during sortsupport-driven sorts. */
 static int
 h3index_gist_cmp_abbrev(Datum x, Datum y, SortSupport ssup)
 {
@@ -163,8 +110,8 @@ h3index_gist_cmp_abbrev(Datum x, Datum y, SortSupport ssup)
 static int
 h3index_gist_cmp_full(Datum x, Datum y, SortSupport ssup)
 {
-	H3Index		a = DatumGetH3Index(x);
-	H3Index		b = DatumGetH3Index(y);
+	uint64		a = h3index_gist_sort_key(DatumGetH3Index(x));
+	uint64		b = h3index_gist_sort_key(DatumGetH3Index(y));
 
 	if (a == b)
 		return 0;
@@ -173,48 +120,25 @@ h3index_gist_cmp_full(Datum x, Datum y, SortSupport ssup)
 	return 1;
 }
 
-/* Keep abbreviation enabled; H3 keys already fit cleanly in a Datum. */
+/* Keep abbreviation enabled; the sort key is exact and fits in a Datum. */
 static bool
 h3index_gist_abbrev_abort(int memtupcount, SortSupport ssup)
 {
 	return false;
 }
 
-/* Reuse the pass-by-value h3index datum itself as the abbreviated key. */
+/* Use the hierarchical sort key as the abbreviated key. */
 static Datum
 h3index_gist_abbrev_convert(Datum original, SortSupport ssup)
 {
-	return DatumGetH3Index(original);
-}
-
-/* Measure how much coarser a union becomes after adding a key. */
-static inline float
-h3index_union_widening(H3Index current, H3Index next_union)
-{
-	if (current == H3_NULL || current == next_union)
-		return 0.0f;
-	if (next_union == H3_NULL)
-		return GIST_CROSS_BASE_PENALTY;
-	return (float) (getResolution(current) - getResolution(next_union));
+	return (Datum) h3index_gist_sort_key(DatumGetH3Index(original));
 }
 
-/* Score how well two candidate unions stay separated from one another. */
-static int
-h3index_union_separation_score(H3Index unionL, H3Index unionR)
-{
-	if (unionL == H3_NULL || unionR == H3_NULL)
-		return INT_MAX;
-	if (getBaseCellNumber(unionL) != getBaseCellNumber(unionR))
-		return -1;
-
-	H3Index ancestor = finest_common_ancestor(unionL, unionR);
-
-	if (ancestor == H3_NULL)
-		return -1;
-	return getResolution(ancestor);
-}
-
-/* Match the natural H3 key order used by picksplit and buffered GiST build. */
+/*
+ * Sorted GiST build (PostgreSQL 14+) packs leaf pages bottom-up in this
+ * order, so it matches the hierarchical order used by picksplit: each page
+ * then holds a run of neighbouring subtrees and gets a tight union.
+ */
 Datum
 h3index_gist_sortsupport(PG_FUNCTION_ARGS)
 {
@@ -244,20 +168,37 @@ Datum
 h3index_gist_consistent(PG_FUNCTION_ARGS)
 {
 	GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
-	H3Index		query = PG_GETARG_H3INDEX(1);
 	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
 
 	/* Oid subtype = PG_GETARG_OID(3); */
 	bool	   *recheck = (bool *) PG_GETARG_POINTER(4);
 	H3Index		key = DatumGetH3Index(entry->key);
+	H3Index		query;
+
+	h3_stats_count(H3_STAT_GIST_CONSISTENT);
 
 	/* H3_NULL key means union of entries from different base cells */
 	if (key == H3_NULL)
 	{
 		*recheck = true;
+		h3_stats_count(H3_STAT_GIST_RECHECK);
 		PG_RETURN_BOOL(true);
 	}
 
+	/* the query is an h3_grid_radius: prune subtrees farther than k */
+	if (strategy == H3_GRID_RADIUS_STRATEGY)
+	{
+		int			k;
+
+		h3_grid_radius_from_datum(PG_GETARG_DATUM(1), &query, &k);
+		*recheck = false;
+		if (GIST_LEAF(entry))
+			PG_RETURN_BOOL(h3index_within_grid_radius(key, query, k));
+		PG_RETURN_BOOL(h3index_grid_distance_lower_bound(key, query, k) <= k);
+	}
+
+	query = PG_GETARG_H3INDEX(1);
+
 	/*
 	 * For equality, we only need key == query. Skip the more expensive
 	 * containment() call since it is not needed for this strategy.
@@ -294,6 +235,7 @@ h3index_gist_consistent(PG_FUNCTION_ARGS)
 	{
 		/* internal node checks need recheck */
 		*recheck = true;
+		h3_stats_count(H3_STAT_GIST_RECHECK);
 
 		switch (strategy)
 		{
@@ -379,18 +321,62 @@ h3index_gist_penalty(PG_FUNCTION_ARGS)
 	}
 	else
 	{
-		*penalty = (float) (getResolution(orig) - getResolution(ancestor));
+		*penalty = (float) (h3index_res(orig) - h3index_res(ancestor));
 	}
 
 	PG_RETURN_POINTER(penalty);
 }
 
+/* Union of a run of sorted entries. */
+static H3Index
+h3index_gist_union_range(const SortEntry *sorted, int from, int to)
+{
+	H3Index		out = sorted[from].key;
+
+	for (int i = from + 1; i < to && out != H3_NULL; i++)
+		out = finest_common_ancestor(out, sorted[i].key);
+
+	return out;
+}
+
+/*
+ * Pages a split costs beyond the minimum needed for all entries. Sorted
+ * builds hand several pages worth of entries to picksplit at once, so an
+ * unlucky split there leaves partly filled pages behind.
+ */
+static inline int
+h3index_gist_split_waste(int nentries, int nleft)
+{
+	int			pages = (nentries + GIST_INDEX_TUPLES_PER_PAGE - 1) / GIST_INDEX_TUPLES_PER_PAGE;
+	int			left = (nleft + GIST_INDEX_TUPLES_PER_PAGE - 1) / GIST_INDEX_TUPLES_PER_PAGE;
+	int			right = (nentries - nleft + GIST_INDEX_TUPLES_PER_PAGE - 1) / GIST_INDEX_TUPLES_PER_PAGE;
+
+	return left + right - pages;
+}
+
+/*
+ * Resolution of the first base cell or digit where two neighbouring sorted
+ * entries differ, -1 when their base cells differ. A split between them at
+ * a coarse radix keeps both sides in separate subtrees.
+ */
+static inline int
+h3index_gist_radix_depth(H3Index a, H3Index b)
+{
+	H3Index		ancestor = finest_common_ancestor(a, b);
+
+	if (ancestor == H3_NULL)
+		return -1;
+	return h3index_res(ancestor);
+}
+
 /**
  * The GiST PickSplit method for H3 indexes.
  *
- * Sorts entries by H3 index value, seeds both sides from the extremes, and
- * greedily grows inward. H3's natural ordering groups by base cell then
- * hierarchical digits, providing good spatial locality.
+ * Sorts entries so that every subtree is a contiguous run and cuts the run
+ * where neighbours differ at the coarsest base cell or digit, so the two
+ * sides partition the page into disjoint subtrees where the data allows.
+ * Only cuts leaving both sides minfill entries and costing no extra page
+ * are considered, ties go to the most balanced cut.
  */
 Datum
 h3index_gist_picksplit(PG_FUNCTION_ARGS)
@@ -400,128 +386,66 @@ h3index_gist_picksplit(PG_FUNCTION_ARGS)
 	OffsetNumber maxoff = entryvec->n - 1;
 	GISTENTRY  *ent = entryvec->vector;
 	int			nentries = maxoff;
-	OffsetNumber *left,
-			   *right;
 	SortEntry  *sorted;
+	int			cut = -1;
+	int			bestWaste = INT_MAX;
+	int			bestDepth = INT_MAX;
+	int			bestImbalance = INT_MAX;
 
 	v->spl_left = (OffsetNumber *) palloc((maxoff + 1) * sizeof(OffsetNumber));
-	left = v->spl_left;
 	v->spl_nleft = 0;
 
 	v->spl_right = (OffsetNumber *) palloc((maxoff + 1) * sizeof(OffsetNumber));
-	right = v->spl_right;
 	v->spl_nright = 0;
 
-	/* Sort entries by H3 index value for spatial locality */
 	sorted = (SortEntry *) palloc(nentries * sizeof(SortEntry));
 	for (OffsetNumber i = FirstOffsetNumber; i <= maxoff; i = OffsetNumberNext(i))
 	{
+		H3Index		key = DatumGetH3Index(ent[i].key);
+
 		sorted[i - FirstOffsetNumber].offset = i;
-		sorted[i - FirstOffsetNumber].key = DatumGetH3Index(ent[i].key);
+		sorted[i - FirstOffsetNumber].key = key;
+		sorted[i - FirstOffsetNumber].sortkey = h3index_gist_sort_key(key);
 	}
 	qsort(sorted, nentries, sizeof(SortEntry), sort_entry_cmp);
 
-	/* Seed both sides from the extremes, then greedily grow inward. */
-	H3Index unionL = sorted[0].key;
-	*left++ = sorted[0].offset;
-	++(v->spl_nleft);
-
-	H3Index unionR = sorted[nentries - 1].key;
-	*right++ = sorted[nentries - 1].offset;
-	++(v->spl_nright);
-
 	int minfill = (int) ceil(GIST_LIMIT_RATIO * (double) nentries);
 	if (nentries > GIST_INDEX_TUPLES_PER_PAGE &&
 		nentries <= 2 * GIST_INDEX_TUPLES_PER_PAGE)
 		minfill = Max(minfill, nentries - GIST_INDEX_TUPLES_PER_PAGE);
 	minfill = Max(minfill, 1);
 
-	int lo = 1;
-	int hi = nentries - 2;
-
-	while (lo <= hi)
+	for (int i = minfill; i <= nentries - minfill; i++)
 	{
-		int remaining = hi - lo + 1;
-
-		if (v->spl_nleft + remaining <= minfill)
+		int			waste = h3index_gist_split_waste(nentries, i);
+		int			depth = h3index_gist_radix_depth(sorted[i - 1].key, sorted[i].key);
+		int			imbalance = abs(nentries - 2 * i);
+
+		if (waste < bestWaste ||
+			(waste == bestWaste &&
+			 (depth < bestDepth ||
+			  (depth == bestDepth && imbalance < bestImbalance))))
 		{
-			unionL = finest_common_ancestor(unionL, sorted[lo].key);
-			*left++ = sorted[lo++].offset;
-			++(v->spl_nleft);
-			continue;
+			cut = i;
+			bestWaste = waste;
+			bestDepth = depth;
+			bestImbalance = imbalance;
 		}
+	}
 
-		if (v->spl_nright + remaining <= minfill)
-		{
-			unionR = finest_common_ancestor(unionR, sorted[hi].key);
-			*right++ = sorted[hi--].offset;
-			++(v->spl_nright);
-			continue;
-		}
+	/* minfill never exceeds half of the entries, but stay safe */
+	if (cut < 0)
+		cut = nentries / 2;
 
-		{
-			PickSplitMove leftMove = {
-				.to_left = true,
-				.unionL = finest_common_ancestor(unionL, sorted[lo].key),
-				.unionR = unionR,
-				.nleft = v->spl_nleft + 1,
-				.nright = v->spl_nright
-			};
-			PickSplitMove rightMove = {
-				.to_left = false,
-				.unionL = unionL,
-				.unionR = finest_common_ancestor(unionR, sorted[hi].key),
-				.nleft = v->spl_nleft,
-				.nright = v->spl_nright + 1
-			};
-			int			leftConcrete;
-			int			rightConcrete;
-			int			leftSeparation;
-			int			rightSeparation;
-			int			leftBalance;
-			int			rightBalance;
-
-			leftMove.widen = h3index_union_widening(unionL, leftMove.unionL);
-			rightMove.widen = h3index_union_widening(unionR, rightMove.unionR);
-
-			leftConcrete = (leftMove.unionL != H3_NULL) +
-				(leftMove.unionR != H3_NULL);
-			rightConcrete = (rightMove.unionL != H3_NULL) +
-				(rightMove.unionR != H3_NULL);
-			leftSeparation = h3index_union_separation_score(
-				leftMove.unionL, leftMove.unionR);
-			rightSeparation = h3index_union_separation_score(
-				rightMove.unionL, rightMove.unionR);
-			leftBalance = abs(leftMove.nleft - leftMove.nright);
-			rightBalance = abs(rightMove.nleft - rightMove.nright);
-
-			if (leftConcrete > rightConcrete ||
-				(leftConcrete == rightConcrete &&
-				 (leftSeparation < rightSeparation ||
-				  (leftSeparation == rightSeparation &&
-				   (leftMove.widen < rightMove.widen ||
-					(leftMove.widen == rightMove.widen &&
-					 (leftBalance < rightBalance ||
-					  (leftBalance == rightBalance &&
-					   leftMove.to_left && !rightMove.to_left))))))))
-			{
-				unionL = leftMove.unionL;
-				*left++ = sorted[lo++].offset;
-				++(v->spl_nleft);
-			}
-			else
-			{
-				unionR = rightMove.unionR;
-				*right++ = sorted[hi--].offset;
-				++(v->spl_nright);
-			}
-		}
-	}
+	for (int i = 0; i < cut; i++)
+		v->spl_left[v->spl_nleft++] = sorted[i].offset;
+	for (int i = cut; i < nentries; i++)
+		v->spl_right[v->spl_nright++] = sorted[i].offset;
 
-	pfree(sorted);
+	v->spl_ldatum = H3IndexGetDatum(h3index_gist_union_range(sorted, 0, cut));
+	v->spl_rdatum = H3IndexGetDatum(h3index_gist_union_range(sorted, cut, nentries));
 
-	v->spl_ldatum = H3IndexGetDatum(unionL);
-	v->spl_rdatum = H3IndexGetDatum(unionR);
+	pfree(sorted);
 
 	PG_RETURN_POINTER(v);
 }
@@ -556,6 +480,8 @@ h3index_gist_distance(PG_FUNCTION_ARGS)
 	bool	   *recheck = (bool *) PG_GETARG_POINTER(4);
 	H3Index		key = DatumGetH3Index(entry->key);
 
+	h3_stats_count(H3_STAT_GIST_DISTANCE);
+
 	/* internal node distances are lower bounds; leaf distances are exact */
 	*recheck = !GIST_LEAF(entry);
 
@@ -569,7 +495,7 @@ h3index_gist_distance(PG_FUNCTION_ARGS)
 				PG_RETURN_FLOAT8(GIST_LEAF(entry) ? INFINITY : 0.0);
 
 			if (!GIST_LEAF(entry))
-				PG_RETURN_FLOAT8(h3index_gist_distance_lower_bound(key, query));
+				PG_RETURN_FLOAT8((double) h3index_grid_distance_lower_bound(key, query, 0));
 
 			if (h3index_grid_distance(key, query, &distance))
 				PG_RETURN_FLOAT8(INFINITY);
@@ -22,8 +22,11 @@
 
 #include <h3api.h> // Main H3 include
 #include "algos.h"
+#include "cell_bits.h"
+#include "operators.h"
 #include "type.h"
 #include "error.h"
+#include "stats.h"
 
 #include "inttypes.h"
 
@@ -49,12 +52,22 @@ static int
 h3_spgist_node(H3Index cell, int level)
 {
 	if (level == 0)
-		return getBaseCellNumber(cell);
-	if (level <= getResolution(cell))
+		return h3index_base_cell(cell);
+	if (level <= h3index_res(cell))
 		return H3_GET_INDEX_DIGIT(cell, level);
 	return 0;
 }
 
+/* Resolution 0 cell of a base cell */
+static H3Index
+spgist_base_cell_index(int baseCell)
+{
+	/* all 15 digits are unused at resolution 0 */
+	return (H3_CELL_HEADER << H3_HEADER_OFFSET) |
+		((H3Index) baseCell << H3_BASE_CELL_OFFSET) |
+		H3_INDEX_DIGITS_MASK;
+}
+
 /*
  * Compare two H3 indexes for containment.
  * Returns 1 if a contains b (including equality), -1 if b contains a,
@@ -68,26 +81,10 @@ spgist_cmp(H3Index a, H3Index b)
 		return 1;
 	if (b == H3_ROOT_INDEX)
 		return -1;
-	if (a == b)
+	if (h3index_is_ancestor_fast(a, b))
 		return 1;
-
-	int aRes = getResolution(a);
-	int bRes = getResolution(b);
-
-	if (aRes <= bRes)
-	{
-		H3Index bParent;
-
-		if (cellToParent(b, aRes, &bParent) == 0 && a == bParent)
-			return 1;
-	}
-	else
-	{
-		H3Index aParent;
-
-		if (cellToParent(a, bRes, &aParent) == 0 && b == aParent)
-			return -1;
-	}
+	if (h3index_is_ancestor_fast(b, a))
+		return -1;
 
 	/* no overlap */
 	return 0;
@@ -220,7 +217,7 @@ h3index_spgist_choose(PG_FUNCTION_ARGS)
 	 */
 	node = in->hasPrefix
 		? h3_spgist_node(insert, resolution)
-		: getBaseCellNumber(insert);
+		: h3index_base_cell(insert);
 	out->result.matchNode.nodeN = node;
 
 	PG_RETURN_VOID();
@@ -289,8 +286,8 @@ h3index_spgist_picksplit(PG_FUNCTION_ARGS)
 		 * then fold in every other tuple via FCA.
 		 */
 		H3Index prefix;
-		if (resolution <= getResolution(first))
-			h3_assert(cellToParent(first, resolution, &prefix));
+		if (resolution <= h3index_res(first))
+			prefix = h3index_cell_to_parent_fast(first, resolution);
 		else
 			prefix = first;
 
@@ -298,11 +295,8 @@ h3index_spgist_picksplit(PG_FUNCTION_ARGS)
 		{
 			H3Index cell = DatumGetH3Index(in->datums[i]);
 			H3Index ancestor;
-			if (resolution <= getResolution(cell))
-			{
-				if (cellToParent(cell, resolution, &ancestor) != 0)
-					ancestor = cell;
-			}
+			if (resolution <= h3index_res(cell))
+				ancestor = h3index_cell_to_parent_fast(cell, resolution);
 			else
 				ancestor = cell;
 
@@ -334,7 +328,7 @@ h3index_spgist_picksplit(PG_FUNCTION_ARGS)
 		out->leafTupleDatums[i] = H3IndexGetDatum(insert);
 		out->mapTuplesToNodes[i] = out->hasPrefix
 			? h3_spgist_node(insert, resolution)
-			: getBaseCellNumber(insert);
+			: h3index_base_cell(insert);
 	}
 
 	PG_RETURN_VOID();
@@ -354,6 +348,9 @@ h3index_spgist_inner_consistent(PG_FUNCTION_ARGS)
 	spgInnerConsistentOut *out = (spgInnerConsistentOut *) PG_GETARG_POINTER(1);
 	H3Index     parent = H3_NULL;
 	int			innerNodes = in->nNodes;
+	bool	   *visit;
+
+	h3_stats_count(H3_STAT_SPGIST_INNER_CONSISTENT);
 
 	if (in->hasPrefix)
 	{
@@ -378,65 +375,77 @@ h3index_spgist_inner_consistent(PG_FUNCTION_ARGS)
 	for (int i = 0; i < innerNodes; ++i)
 		out->levelAdds[i] = 1;
 
-	/* We must descend into the quadrant(s) identified by which */
-	out->nodeNumbers = (int *) palloc(sizeof(int) * innerNodes);
-	out->nNodes = 0;
-
-	/* "which" is a bitmask of child nodes that satisfy all constraints */
-	int bc = -1;
-	bool stop = false;
+	/* child nodes that satisfy all constraints so far */
+	visit = palloc(sizeof(bool) * innerNodes);
+	for (int i = 0; i < innerNodes; ++i)
+		visit[i] = true;
 
 	for (int i = 0; i < in->nkeys; i++)
 	{
 		/* each scankey is a constraint to be checked against */
 		StrategyNumber strategy = in->scankeys[i].sk_strategy;
-		H3Index    query = DatumGetH3Index(in->scankeys[i].sk_argument);
+		Datum		argument = in->scankeys[i].sk_argument;
 
-		if (parent == H3_NULL)
+		if (strategy == H3_GRID_RADIUS_STRATEGY)
 		{
-			if (bc > -1)
+			H3Index		origin;
+			int			k;
+
+			h3_grid_radius_from_datum(argument, &origin, &k);
+			if (parent != H3_NULL)
 			{
-				stop = true;
+				if (h3index_grid_distance_lower_bound(parent, origin, k) > k)
+				{
+					for (int node = 0; node < innerNodes; node++)
+						visit[node] = false;
+				}
 			}
-			bc = getBaseCellNumber(query);
-		}
-		else
-		{
-			int cmp = spgist_cmp(parent, query);
-
-			switch (strategy)
+			else
 			{
-				case RTSameStrategyNumber:
-				case RTContainsStrategyNumber:
-				case RTContainedByStrategyNumber:
-					if (cmp == 0)
-						stop = true;
-					break;
-				default:
-					elog(ERROR, "unrecognized strategy number: %d", strategy);
-					break;
+				/* nodes are base cells, bound each of them */
+				for (int node = 0; node < innerNodes; node++)
+					visit[node] = visit[node] &&
+						h3index_grid_distance_lower_bound(spgist_base_cell_index(node),
+														  origin, k) <= k;
 			}
+			continue;
 		}
 
-		if (stop)
-			break;				/* no need to consider remaining conditions */
-	}
-
-	if (!stop)
-	{
-		if (bc > -1)
+		switch (strategy)
 		{
-			out->nodeNumbers[out->nNodes] = bc;
-			out->nNodes++;
+			case RTSameStrategyNumber:
+			case RTContainsStrategyNumber:
+			case RTContainedByStrategyNumber:
+				break;
+			default:
+				elog(ERROR, "unrecognized strategy number: %d", strategy);
+				break;
 		}
-		else
+
+		if (parent != H3_NULL)
 		{
-			for (int i = 0; i < innerNodes; i++)
+			if (spgist_cmp(parent, DatumGetH3Index(argument)) == 0)
 			{
-				out->nodeNumbers[out->nNodes] = i;
-				out->nNodes++;
+				for (int node = 0; node < innerNodes; node++)
+					visit[node] = false;
 			}
 		}
+		else
+		{
+			/* only the base cell of the query can overlap it */
+			int			bc = h3index_base_cell(DatumGetH3Index(argument));
+
+			for (int node = 0; node < innerNodes; node++)
+				visit[node] = visit[node] && node == bc;
+		}
+	}
+
+	out->nodeNumbers = (int *) palloc(sizeof(int) * innerNodes);
+	out->nNodes = 0;
+	for (int i = 0; i < innerNodes; i++)
+	{
+		if (visit[i])
+			out->nodeNumbers[out->nNodes++] = i;
 	}
 
 	PG_RETURN_VOID();
@@ -456,6 +465,8 @@ h3index_spgist_leaf_consistent(PG_FUNCTION_ARGS)
 	H3Index     leaf = DatumGetH3Index(in->leafDatum);
 	bool		retval = true;
 
+	h3_stats_count(H3_STAT_SPGIST_LEAF_CONSISTENT);
+
 	out->leafValue = in->leafDatum;
 	/* leafDatum is what it is... */
 	out->recheck = false;
@@ -465,8 +476,19 @@ h3index_spgist_leaf_consistent(PG_FUNCTION_ARGS)
 	for (int i = 0; i < in->nkeys; i++)
 	{
 		StrategyNumber strategy = in->scankeys[i].sk_strategy;
-		H3Index    query = DatumGetH3Index(in->scankeys[i].sk_argument);
+		H3Index    query;
+		int			k;
+
+		if (strategy == H3_GRID_RADIUS_STRATEGY)
+		{
+			h3_grid_radius_from_datum(in->scankeys[i].sk_argument, &query, &k);
+			retval = h3index_within_grid_radius(leaf, query, k);
+			if (!retval)
+				break;
+			continue;
+		}
 
+		query = DatumGetH3Index(in->scankeys[i].sk_argument);
 		switch (strategy)
 		{
 			case RTSameStrategyNumber:
@@ -0,0 +1,515 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <access/genam.h>		 // index_open
+#include <access/gist_private.h>	 // GIST_ROOT_BLKNO
+#include <access/htup_details.h> // heap_form_tuple
+#include <access/spgist_private.h> // SpGistInnerTuple
+#include <catalog/pg_am.h>		 // GIST_AM_OID
+#include <catalog/pg_type.h>	 // INT8OID
+#include <fmgr.h>				 // PG_FUNCTION_INFO_V1
+#include <funcapi.h>			 // SRF_IS_FIRSTCALL
+#include <miscadmin.h>			 // GetUserId
+#include <nodes/bitmapset.h>	 // Bitmapset
+#include <nodes/pg_list.h>		 // List
+#include <storage/bufmgr.h>		 // ReadBufferExtended
+#include <utils/acl.h>			 // pg_class_aclcheck
+#include <utils/array.h>		 // construct_array
+#include <utils/lsyscache.h>	 // get_func_name
+#include <utils/rel.h>			 // RelationGetDescr
+
+#include "algos.h"
+#include "error.h"
+#include "type.h"
+#include "upstream_macros.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_gist_index_stats);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_spgist_index_stats);
+
+/* Statistics of one level of an index, level 0 being the root */
+typedef struct
+{
+	Bitmapset  *pages;
+	int64		npages;
+	double		fill;			/* sum over pages */
+	int64		tuples;			/* GiST: index tuples, SP-GiST: inner tuples */
+	int64		leafTuples;		/* SP-GiST only */
+	int64		downlinks;
+	int64		nullKeys;
+	int64		overlappingPairs;	/* GiST only */
+	int64		siblingPairs;	/* GiST only */
+	int64		resolutions[MAX_H3_RES + 1];
+}	IndexLevelStats;
+
+typedef struct
+{
+	IndexLevelStats *levels;
+	int			nlevels;
+}	IndexStats;
+
+/* Returns stats of the given level, growing the array as needed */
+static IndexLevelStats *
+index_stats_level(IndexStats * stats, int level)
+{
+	if (level >= stats->nlevels)
+	{
+		int			nlevels = level + 1;
+
+		if (stats->levels == NULL)
+			stats->levels = palloc0(nlevels * sizeof(IndexLevelStats));
+		else
+		{
+			stats->levels = repalloc(stats->levels, nlevels * sizeof(IndexLevelStats));
+			memset(&stats->levels[stats->nlevels], 0,
+				   (nlevels - stats->nlevels) * sizeof(IndexLevelStats));
+		}
+		stats->nlevels = nlevels;
+	}
+	return &stats->levels[level];
+}
+
+/* Fraction of the usable page space taken by tuples */
+static double
+page_fill(Page page)
+{
+	double		usable = ((PageHeader) page)->pd_special - SizeOfPageHeaderData;
+
+	return 1.0 - PageGetExactFreeSpace(page) / usable;
+}
+
+/* Counts a page once per level */
+static void
+index_stats_add_page(IndexLevelStats * level, BlockNumber blkno, Page page)
+{
+	if (bms_is_member(blkno, level->pages))
+		return;
+	level->pages = bms_add_member(level->pages, blkno);
+	level->npages++;
+	level->fill += page_fill(page);
+}
+
+static void
+index_stats_add_key(IndexLevelStats * level, H3Index key)
+{
+	if (key == H3_NULL)
+		level->nullKeys++;
+	else
+		level->resolutions[getResolution(key)]++;
+}
+
+/*
+ * Opens an index for inspection, after checking that it is an index of the
+ * expected access method whose first column uses our operator class.
+ */
+static Relation
+index_stats_open(Oid indexoid, Oid amoid, uint16 procnum, const char *procname)
+{
+	Relation	rel = index_open(indexoid, AccessShareLock);
+	Oid			procid;
+	AclResult	aclresult;
+
+	ASSERT(
+		   rel->rd_rel->relkind == RELKIND_INDEX && rel->rd_rel->relam == amoid,
+		   ERRCODE_WRONG_OBJECT_TYPE,
+		   "\"%s\" is not %s index",
+		   RelationGetRelationName(rel),
+		   amoid == GIST_AM_OID ? "a GiST" : "an SP-GiST");
+	ASSERT(
+		   !RELATION_IS_OTHER_TEMP(rel),
+		   ERRCODE_FEATURE_NOT_SUPPORTED,
+		   "cannot access temporary indexes of other sessions");
+
+	procid = index_getprocid(rel, 1, procnum);
+	ASSERT(
+		   OidIsValid(procid) && strcmp(get_func_name(procid), procname) == 0,
+		   ERRCODE_WRONG_OBJECT_TYPE,
+		   "\"%s\" does not use an h3index operator class",
+		   RelationGetRelationName(rel));
+
+	aclresult = pg_class_aclcheck(rel->rd_index->indrelid, GetUserId(), ACL_SELECT);
+	if (aclresult != ACLCHECK_OK)
+		aclcheck_error(aclresult, OBJECT_TABLE, get_rel_name(rel->rd_index->indrelid));
+
+	return rel;
+}
+
+/* Walks a GiST index level by level, starting at the root */
+static void
+gist_index_stats(Relation rel, IndexStats * stats)
+{
+	BufferAccessStrategy strategy = GetAccessStrategy(BAS_BULKREAD);
+	TupleDesc	tupdesc = RelationGetDescr(rel);
+	List	   *current = list_make1_int(GIST_ROOT_BLKNO);
+	H3Index    *keys = palloc(MaxIndexTuplesPerPage * sizeof(H3Index));
+
+	for (int depth = 0; current != NIL; depth++)
+	{
+		IndexLevelStats *level = index_stats_level(stats, depth);
+		List	   *next = NIL;
+		ListCell   *lc;
+
+		foreach(lc, current)
+		{
+			BlockNumber blkno = lfirst_int(lc);
+			Buffer		buffer;
+			Page		page;
+			OffsetNumber maxoff;
+			int			nkeys = 0;
+			bool		leaf;
+
+			CHECK_FOR_INTERRUPTS();
+
+			buffer = ReadBufferExtended(rel, MAIN_FORKNUM, blkno, RBM_NORMAL, strategy);
+			LockBuffer(buffer, BUFFER_LOCK_SHARE);
+			page = BufferGetPage(buffer);
+
+			if (PageIsNew(page) || GistPageIsDeleted(page))
+			{
+				UnlockReleaseBuffer(buffer);
+				continue;
+			}
+
+			leaf = GistPageIsLeaf(page);
+			maxoff = PageGetMaxOffsetNumber(page);
+			index_stats_add_page(level, blkno, page);
+
+			for (OffsetNumber off = FirstOffsetNumber; off <= maxoff; off = OffsetNumberNext(off))
+			{
+				ItemId		iid = PageGetItemId(page, off);
+				IndexTuple	itup;
+				bool		isnull;
+				H3Index		key;
+
+				if (!ItemIdIsUsed(iid) || ItemIdIsDead(iid))
+					continue;
+
+				itup = (IndexTuple) PageGetItem(page, iid);
+				key = DatumGetH3Index(index_getattr(itup, 1, tupdesc, &isnull));
+				if (isnull)
+					key = H3_NULL;
+
+				level->tuples++;
+				index_stats_add_key(level, key);
+
+				if (!leaf)
+				{
+					level->downlinks++;
+					next = lappend_int(next, ItemPointerGetBlockNumber(&itup->t_tid));
+					if (key != H3_NULL)
+						keys[nkeys++] = key;
+				}
+			}
+			UnlockReleaseBuffer(buffer);
+
+			/* sibling keys overlap when one contains the other */
+			for (int i = 0; i < nkeys; i++)
+			{
+				for (int j = i + 1; j < nkeys; j++)
+				{
+					level->siblingPairs++;
+					if (containment(keys[i], keys[j]) != 0)
+						level->overlappingPairs++;
+				}
+			}
+		}
+
+		list_free(current);
+		current = next;
+	}
+
+	FreeAccessStrategy(strategy);
+}
+
+/* Tuple to visit while walking an SP-GiST index */
+typedef struct
+{
+	BlockNumber blkno;
+	OffsetNumber offset;
+	int			level;
+	bool		wholePage;		/* all tuples of a leaf root page */
+}	SpGistStackItem;
+
+static void
+spgist_push(List **stack, BlockNumber blkno, OffsetNumber offset, int level, bool wholePage)
+{
+	SpGistStackItem *item = palloc(sizeof(SpGistStackItem));
+
+	item->blkno = blkno;
+	item->offset = offset;
+	item->level = level;
+	item->wholePage = wholePage;
+	*stack = lappend(*stack, item);
+}
+
+static OffsetNumber
+spgist_leaf_next(SpGistLeafTuple leafTuple)
+{
+#if POSTGRESQL_VERSION_MAJOR >= 14
+	return SGLT_GET_NEXTOFFSET(leafTuple);
+#else
+	return leafTuple->nextOffset;
+#endif
+}
+
+/*
+ * Walks an SP-GiST index from the root tuple. Inner tuples and leaf chains of
+ * different levels share pages, so a page is counted for each level it holds
+ * tuples of.
+ */
+static void
+spgist_index_stats(Relation rel, IndexStats * stats)
+{
+	BufferAccessStrategy strategy = GetAccessStrategy(BAS_BULKREAD);
+	SpGistState state;
+	List	   *stack = NIL;
+
+	initSpGistState(&state, rel);
+	spgist_push(&stack, SPGIST_ROOT_BLKNO, FirstOffsetNumber, 0, true);
+
+	while (stack != NIL)
+	{
+		SpGistStackItem *item = llast(stack);
+		IndexLevelStats *level = index_stats_level(stats, item->level);
+		Buffer		buffer;
+		Page		page;
+
+		stack = list_delete_last(stack);
+		CHECK_FOR_INTERRUPTS();
+
+		buffer = ReadBufferExtended(rel, MAIN_FORKNUM, item->blkno, RBM_NORMAL, strategy);
+		LockBuffer(buffer, BUFFER_LOCK_SHARE);
+		page = BufferGetPage(buffer);
+
+		if (PageIsNew(page) || SpGistPageIsDeleted(page))
+		{
+			UnlockReleaseBuffer(buffer);
+			pfree(item);
+			continue;
+		}
+
+		if (SpGistPageIsLeaf(page))
+		{
+			OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+			OffsetNumber offset = item->offset;
+
+			/* the root page of a small index holds unchained leaf tuples */
+			while (offset != InvalidOffsetNumber && offset <= maxoff)
+			{
+				SpGistLeafTuple leafTuple =
+				(SpGistLeafTuple) PageGetItem(page, PageGetItemId(page, offset));
+
+				if (leafTuple->tupstate == SPGIST_LIVE)
+				{
+					index_stats_add_page(level, item->blkno, page);
+					level->leafTuples++;
+				}
+				else if (leafTuple->tupstate == SPGIST_REDIRECT)
+				{
+					ItemPointer pointer = &((SpGistDeadTuple) leafTuple)->pointer;
+
+					spgist_push(&stack, ItemPointerGetBlockNumber(pointer),
+								ItemPointerGetOffsetNumber(pointer), item->level, false);
+				}
+
+				if (item->wholePage)
+					offset = OffsetNumberNext(offset);
+				else if (leafTuple->tupstate == SPGIST_LIVE)
+					offset = spgist_leaf_next(leafTuple);
+				else
+					offset = InvalidOffsetNumber;
+			}
+		}
+		else if (item->offset <= PageGetMaxOffsetNumber(page))
+		{
+			SpGistInnerTuple innerTuple =
+			(SpGistInnerTuple) PageGetItem(page, PageGetItemId(page, item->offset));
+
+			if (innerTuple->tupstate == SPGIST_LIVE)
+			{
+				SpGistNodeTuple node;
+				int			i;
+
+				index_stats_add_page(level, item->blkno, page);
+				level->tuples++;
+				index_stats_add_key(level, innerTuple->prefixSize
+									? DatumGetH3Index(SGITDATUM(innerTuple, &state))
+									: H3_NULL);
+
+				SGITITERATE(innerTuple, i, node)
+				{
+					if (!ItemPointerIsValid(&node->t_tid))
+						continue;
+					level->downlinks++;
+					spgist_push(&stack, ItemPointerGetBlockNumber(&node->t_tid),
+								ItemPointerGetOffsetNumber(&node->t_tid),
+								item->level + 1, false);
+				}
+			}
+			else if (innerTuple->tupstate == SPGIST_REDIRECT)
+			{
+				ItemPointer pointer = &((SpGistDeadTuple) innerTuple)->pointer;
+
+				spgist_push(&stack, ItemPointerGetBlockNumber(pointer),
+							ItemPointerGetOffsetNumber(pointer), item->level, false);
+			}
+		}
+
+		UnlockReleaseBuffer(buffer);
+		pfree(item);
+	}
+
+	FreeAccessStrategy(strategy);
+}
+
+static Datum
+resolutions_to_array(const int64 *resolutions)
+{
+	Datum		elems[MAX_H3_RES + 1];
+
+	for (int i = 0; i <= MAX_H3_RES; i++)
+		elems[i] = Int64GetDatum(resolutions[i]);
+
+	return PointerGetDatum(construct_array(elems, MAX_H3_RES + 1, INT8OID,
+										   sizeof(int64), FLOAT8PASSBYVAL,
+										   TYPALIGN_DOUBLE));
+}
+
+/*
+ * Reports the structure of a GiST index using h3index_gist_ops_experimental,
+ * one row per tree level.
+ */
+Datum
+h3_gist_index_stats(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	IndexStats *stats;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		TupleDesc	tuple_desc;
+		Relation	rel;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
+		funcctx->tuple_desc = BlessTupleDesc(tuple_desc);
+
+		rel = index_stats_open(PG_GETARG_OID(0), GIST_AM_OID,
+							   GIST_CONSISTENT_PROC, "h3index_gist_consistent");
+		stats = palloc0(sizeof(IndexStats));
+		gist_index_stats(rel, stats);
+		index_close(rel, AccessShareLock);
+
+		funcctx->user_fctx = stats;
+		funcctx->max_calls = stats->nlevels;
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	stats = funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		IndexLevelStats *level = &stats->levels[funcctx->call_cntr];
+		bool		leaf = funcctx->call_cntr == funcctx->max_calls - 1;
+		Datum		values[8];
+		bool		nulls[8] = {false};
+		HeapTuple	tuple;
+
+		values[0] = Int32GetDatum(funcctx->call_cntr);
+		values[1] = Int64GetDatum(level->npages);
+		values[2] = Int64GetDatum(level->tuples);
+		values[3] = Float8GetDatum(level->npages ? (double) level->tuples / level->npages : 0);
+		values[4] = Float8GetDatum(level->npages ? level->fill / level->npages : 0);
+		values[5] = Float8GetDatum(level->tuples ? (double) level->nullKeys / level->tuples : 0);
+		values[6] = Float8GetDatum(level->siblingPairs
+							  ? (double) level->overlappingPairs / level->siblingPairs : 0);
+		values[7] = resolutions_to_array(level->resolutions);
+
+		/* leaf keys have no siblings to compare */
+		nulls[6] = leaf;
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
+
+/*
+ * Reports the structure of an SP-GiST index using h3index_ops_experimental,
+ * one row per tree level.
+ */
+Datum
+h3_spgist_index_stats(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	IndexStats *stats;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		TupleDesc	tuple_desc;
+		Relation	rel;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
+		funcctx->tuple_desc = BlessTupleDesc(tuple_desc);
+
+		rel = index_stats_open(PG_GETARG_OID(0), SPGIST_AM_OID,
+							   SPGIST_INNER_CONSISTENT_PROC,
+							   "h3index_spgist_inner_consistent");
+		stats = palloc0(sizeof(IndexStats));
+		spgist_index_stats(rel, stats);
+		index_close(rel, AccessShareLock);
+
+		funcctx->user_fctx = stats;
+		funcctx->max_calls = stats->nlevels;
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	stats = funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		IndexLevelStats *level = &stats->levels[funcctx->call_cntr];
+		Datum		values[8];
+		bool		nulls[8] = {false};
+		HeapTuple	tuple;
+
+		values[0] = Int32GetDatum(funcctx->call_cntr);
+		values[1] = Int64GetDatum(level->npages);
+		values[2] = Int64GetDatum(level->tuples);
+		values[3] = Int64GetDatum(level->leafTuples);
+		values[4] = Float8GetDatum(level->tuples ? (double) level->downlinks / level->tuples : 0);
+		values[5] = Float8GetDatum(level->npages ? level->fill / level->npages : 0);
+		values[6] = Float8GetDatum(level->tuples ? (double) level->nullKeys / level->tuples : 0);
+		values[7] = resolutions_to_array(level->resolutions);
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
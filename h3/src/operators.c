@@ -18,13 +18,18 @@
 #include <postgres.h>
 #include <h3api.h>
 
-#include <fmgr.h> // PG_FUNCTION_ARGS
+#include <fmgr.h>				 // PG_FUNCTION_ARGS
+#include <executor/executor.h> // GetAttributeByNum
 
 #include "algos.h"
+#include "cell_bits.h"
+#include "error.h"
 #include "operators.h"
 #include "type.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_distance);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_within_radius);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_grid_radius_contains);
 
 /* b-tree */
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_eq);
@@ -46,25 +51,101 @@ PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_contained_by);
 H3Error
 h3index_grid_distance(H3Index a, H3Index b, int64_t *distance)
 {
-	int			resA = getResolution(a);
-	int			resB = getResolution(b);
+	int			resA = h3index_res(a);
+	int			resB = h3index_res(b);
 
 	if (resA < resB)
-	{
-		H3Error error = cellToCenterChild(a, resB, &a);
-
-		if (error)
-			return error;
-	}
+		a = h3index_cell_to_center_child_fast(a, resB);
 	else if (resB < resA)
+		b = h3index_cell_to_center_child_fast(b, resA);
+
+	return gridDistance(a, b, distance);
+}
+
+/*
+ * Maximum grid distance from a cell's center child to any descendant at the
+ * given additional depth. Two resolutions down, IJK coordinates scale by
+ * exactly 7 (the class II and class III rotations cancel), so a descendant at
+ * depth d is at most 7 * r(d - 2) from the center child of its depth d - 2
+ * ancestor, plus r(2) = 4 from there: r(d) = 7 * r(d - 2) + 4, with r(0) = 0
+ * and r(1) = 1.
+ */
+static const int64_t descendant_radius[MAX_H3_RES + 1] = {
+	0, 1, 4, 11, 32, 81, 228, 571,
+	1600, 4001, 11204, 28011, 78432, 196081, 549028, 1372571
+};
+
+/*
+ * Lower bound of h3index_grid_distance() from the query to any descendant of
+ * the ancestor, including itself, for which that distance exists. A
+ * descendant is measured at some resolution res, where it lies within
+ * descendant_radius of the ancestor's center child, so the distance between
+ * the two center children less that radius bounds it. The bound returned is
+ * the smallest over all candidate resolutions, and is 0 once the distance
+ * fails at any of them, as the descendants measured there are not bounded.
+ * Stops early once the bound is at most stopAt, as callers only need to know
+ * it is not larger.
+ */
+int64_t
+h3index_grid_distance_lower_bound(H3Index ancestor, H3Index query, int64_t stopAt)
+{
+	int			ancestorRes = h3index_res(ancestor);
+	int			minRes = Max(ancestorRes, h3index_res(query));
+	H3Index		ancestorBase = h3index_cell_to_parent_fast(ancestor, 0);
+	H3Index		queryBase = h3index_cell_to_parent_fast(query, 0);
+	int			neighbors = 0;
+	int64_t		best = INT64_MAX;
+
+	/* grid distances only exist within a base cell and its neighbors */
+	if (ancestorBase != queryBase
+		&& (areNeighborCells(ancestorBase, queryBase, &neighbors) || !neighbors))
+		return INT64_MAX;
+
+	for (int res = minRes; res <= MAX_H3_RES; res++)
 	{
-		H3Error error = cellToCenterChild(b, resA, &b);
+		H3Index		ancestorAtRes = h3index_cell_to_center_child_fast(ancestor, res);
+		H3Index		queryAtRes = h3index_cell_to_center_child_fast(query, res);
+		int64_t		distance;
+
+		if (gridDistance(ancestorAtRes, queryAtRes, &distance))
+			return 0;
 
-		if (error)
-			return error;
+		distance = Max(distance - descendant_radius[res - ancestorRes], 0);
+		best = Min(best, distance);
+
+		if (best <= stopAt)
+			break;
 	}
 
-	return gridDistance(a, b, distance);
+	return best;
+}
+
+/* Reads the origin and k of an h3_grid_radius */
+void
+h3_grid_radius_from_datum(Datum radius, H3Index *origin, int *k)
+{
+	HeapTupleHeader tuple = DatumGetHeapTupleHeader(radius);
+	bool		originNull;
+	bool		kNull;
+	Datum		originDatum = GetAttributeByNum(tuple, 1, &originNull);
+	Datum		kDatum = GetAttributeByNum(tuple, 2, &kNull);
+
+	ASSERT(!originNull && !kNull, ERRCODE_NULL_VALUE_NOT_ALLOWED,
+		   "grid radius origin and k must not be NULL");
+
+	*origin = DatumGetH3Index(originDatum);
+	*k = DatumGetInt32(kDatum);
+}
+
+/* True if the cell is at most k grid steps from origin, as measured by <-> */
+bool
+h3index_within_grid_radius(H3Index cell, H3Index origin, int k)
+{
+	int64_t		distance;
+
+	if (h3index_grid_distance(cell, origin, &distance))
+		return false;
+	return distance <= k;
 }
 
 /*
@@ -87,6 +168,30 @@ h3index_distance(PG_FUNCTION_ARGS)
 	PG_RETURN_INT64(distance);
 }
 
+/* Cell within the grid radius */
+Datum
+h3index_within_radius(PG_FUNCTION_ARGS)
+{
+	H3Index		cell = PG_GETARG_H3INDEX(0);
+	H3Index		origin;
+	int			k;
+
+	h3_grid_radius_from_datum(PG_GETARG_DATUM(1), &origin, &k);
+	PG_RETURN_BOOL(h3index_within_grid_radius(cell, origin, k));
+}
+
+/* Commutator of h3index_within_radius */
+Datum
+h3_grid_radius_contains(PG_FUNCTION_ARGS)
+{
+	H3Index		cell = PG_GETARG_H3INDEX(1);
+	H3Index		origin;
+	int			k;
+
+	h3_grid_radius_from_datum(PG_GETARG_DATUM(0), &origin, &k);
+	PG_RETURN_BOOL(h3index_within_grid_radius(cell, origin, k));
+}
+
 /* b-tree operators */
 Datum
 h3index_eq(PG_FUNCTION_ARGS)
@@ -0,0 +1,297 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+
+#include <access/htup_details.h> // heap_form_tuple
+#include <access/xact.h>		 // RegisterXactCallback
+#include <fmgr.h>				 // PG_FUNCTION_INFO_V1
+#include <funcapi.h>			 // SRF_IS_FIRSTCALL
+#include <miscadmin.h>			 // process_shared_preload_libraries_in_progress
+#include <port/atomics.h>		 // pg_atomic_uint64
+#include <storage/ipc.h>		 // shmem_startup_hook
+#include <storage/lwlock.h>		 // AddinShmemInitLock
+#include <storage/shmem.h>		 // ShmemInitStruct
+#include <utils/builtins.h>		 // CStringGetTextDatum
+#include <utils/memutils.h>		 // TopMemoryContext
+
+#include "error.h"
+#include "guc.h"
+#include "stats.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_stat_functions);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_stat_reset);
+
+typedef enum
+{
+	H3_STAT_KIND_CALL,			/* timed, with cells and memory */
+	H3_STAT_KIND_INDEX			/* index support function, only calls are counted */
+}	H3StatKind;
+
+typedef struct
+{
+	const char *name;
+	H3StatKind	kind;
+}	H3StatDesc;
+
+static const H3StatDesc stat_descs[H3_STAT_COUNT] = {
+	[H3_STAT_LATLNG_TO_CELL] = {"h3_latlng_to_cell", H3_STAT_KIND_CALL},
+	[H3_STAT_CELL_TO_BOUNDARY] = {"h3_cell_to_boundary", H3_STAT_KIND_CALL},
+	[H3_STAT_CELL_TO_BOUNDARY_WKB] = {"h3_cell_to_boundary_wkb", H3_STAT_KIND_CALL},
+	[H3_STAT_CELL_TO_BOUNDARY_TWKB] = {"h3_cell_to_boundary_twkb", H3_STAT_KIND_CALL},
+	[H3_STAT_CELL_TO_TILE_WKB] = {"h3_cell_to_tile_wkb", H3_STAT_KIND_CALL},
+	[H3_STAT_POLYGON_TO_CELLS] = {"h3_polygon_to_cells", H3_STAT_KIND_CALL},
+	[H3_STAT_POLYGON_TO_CELLS_EXPERIMENTAL] = {"h3_polygon_to_cells_experimental", H3_STAT_KIND_CALL},
+	[H3_STAT_POLYGON_TO_CELLS_PARTITION] = {"h3_polygon_to_cells_partition", H3_STAT_KIND_CALL},
+	[H3_STAT_REGION_PREPARE] = {"h3_region_prepare", H3_STAT_KIND_CALL},
+	[H3_STAT_TILE_TO_CELLS] = {"h3_tile_to_cells", H3_STAT_KIND_CALL},
+	[H3_STAT_CELLS_TO_MULTI_POLYGON] = {"h3_cells_to_multi_polygon", H3_STAT_KIND_CALL},
+	[H3_STAT_CELLS_TO_MULTI_POLYGON_WKB] = {"h3_cells_to_multi_polygon_wkb", H3_STAT_KIND_CALL},
+	[H3_STAT_CELLS_TO_MULTI_POLYGON_TWKB] = {"h3_cells_to_multi_polygon_twkb", H3_STAT_KIND_CALL},
+	[H3_STAT_GRID_DISK] = {"h3_grid_disk", H3_STAT_KIND_CALL},
+	[H3_STAT_GRID_DISK_DISTANCES] = {"h3_grid_disk_distances", H3_STAT_KIND_CALL},
+	[H3_STAT_COMPACT_CELLS] = {"h3_compact_cells", H3_STAT_KIND_CALL},
+	[H3_STAT_UNCOMPACT_CELLS] = {"h3_uncompact_cells", H3_STAT_KIND_CALL},
+	[H3_STAT_GIST_CONSISTENT] = {"h3index_gist_consistent", H3_STAT_KIND_INDEX},
+	[H3_STAT_GIST_RECHECK] = {"h3index_gist_recheck", H3_STAT_KIND_INDEX},
+	[H3_STAT_GIST_DISTANCE] = {"h3index_gist_distance", H3_STAT_KIND_INDEX},
+	[H3_STAT_SPGIST_INNER_CONSISTENT] = {"h3index_spgist_inner_consistent", H3_STAT_KIND_INDEX},
+	[H3_STAT_SPGIST_LEAF_CONSISTENT] = {"h3index_spgist_leaf_consistent", H3_STAT_KIND_INDEX},
+};
+
+/* Totals visible to every backend, mirrors H3StatEntry */
+typedef struct
+{
+	pg_atomic_uint64 calls;
+	pg_atomic_uint64 total_time;
+	pg_atomic_uint64 max_time;
+	pg_atomic_uint64 cells;
+	pg_atomic_uint64 max_mem_growth_bytes;
+}	H3StatCounters;
+
+typedef struct
+{
+	H3StatCounters counters[H3_STAT_COUNT];
+}	H3StatsShared;
+
+static H3StatsState state;
+static H3StatsShared *shared = NULL;
+
+#if POSTGRESQL_VERSION_MAJOR >= 15
+static shmem_request_hook_type prev_shmem_request_hook = NULL;
+#endif
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+
+static void
+shared_init(H3StatsShared * area)
+{
+	for (int i = 0; i < H3_STAT_COUNT; i++)
+	{
+		H3StatCounters *counters = &area->counters[i];
+
+		pg_atomic_init_u64(&counters->calls, 0);
+		pg_atomic_init_u64(&counters->total_time, 0);
+		pg_atomic_init_u64(&counters->max_time, 0);
+		pg_atomic_init_u64(&counters->cells, 0);
+		pg_atomic_init_u64(&counters->max_mem_growth_bytes, 0);
+	}
+}
+
+#if POSTGRESQL_VERSION_MAJOR >= 15
+static void
+stats_shmem_request(void)
+{
+	if (prev_shmem_request_hook)
+		prev_shmem_request_hook();
+
+	RequestAddinShmemSpace(sizeof(H3StatsShared));
+}
+#endif
+
+static void
+stats_shmem_startup(void)
+{
+	bool		found;
+
+	if (prev_shmem_startup_hook)
+		prev_shmem_startup_hook();
+
+	LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+	shared = ShmemInitStruct("h3 stats", sizeof(H3StatsShared), &found);
+	if (!found)
+		shared_init(shared);
+	LWLockRelease(AddinShmemInitLock);
+}
+
+/*
+ * Without shared_preload_libraries there is no shared memory to attach to,
+ * so the totals only cover the current backend.
+ */
+static H3StatsShared *
+stats_shared(void)
+{
+	if (shared == NULL)
+	{
+		shared = MemoryContextAlloc(TopMemoryContext, sizeof(H3StatsShared));
+		shared_init(shared);
+	}
+	return shared;
+}
+
+static void
+atomic_max_u64(pg_atomic_uint64 *ptr, uint64 value)
+{
+	uint64		current = pg_atomic_read_u64(ptr);
+
+	while (current < value && !pg_atomic_compare_exchange_u64(ptr, &current, value))
+		;
+}
+
+/* Moves the pending counters of this backend to the totals */
+static void
+stats_flush(void)
+{
+	H3StatsShared *area;
+
+	if (!state.dirty)
+		return;
+
+	area = stats_shared();
+	for (int i = 0; i < H3_STAT_COUNT; i++)
+	{
+		H3StatEntry *entry = &state.pending[i];
+		H3StatCounters *counters = &area->counters[i];
+
+		if (entry->calls == 0)
+			continue;
+
+		pg_atomic_fetch_add_u64(&counters->calls, entry->calls);
+		pg_atomic_fetch_add_u64(&counters->total_time, entry->total_time);
+		pg_atomic_fetch_add_u64(&counters->cells, entry->cells);
+		atomic_max_u64(&counters->max_time, entry->max_time);
+		atomic_max_u64(&counters->max_mem_growth_bytes, entry->max_mem_growth_bytes);
+	}
+	memset(state.pending, 0, sizeof(state.pending));
+	state.dirty = false;
+}
+
+static void
+stats_xact_callback(XactEvent event, void *arg)
+{
+	switch (event)
+	{
+		case XACT_EVENT_COMMIT:
+		case XACT_EVENT_PARALLEL_COMMIT:
+		case XACT_EVENT_ABORT:
+		case XACT_EVENT_PARALLEL_ABORT:
+			stats_flush();
+			break;
+		default:
+			break;
+	}
+}
+
+void
+_stats_init(void)
+{
+	state.track = &h3_guc_track_stats;
+	*find_rendezvous_variable(H3_STATS_RENDEZVOUS) = &state;
+	RegisterXactCallback(stats_xact_callback, NULL);
+
+	if (!process_shared_preload_libraries_in_progress)
+		return;
+
+#if POSTGRESQL_VERSION_MAJOR >= 15
+	prev_shmem_request_hook = shmem_request_hook;
+	shmem_request_hook = stats_shmem_request;
+#else
+	RequestAddinShmemSpace(sizeof(H3StatsShared));
+#endif
+	prev_shmem_startup_hook = shmem_startup_hook;
+	shmem_startup_hook = stats_shmem_startup;
+}
+
+/* Returns the collected statistics, one row per tracked function */
+Datum
+h3_stat_functions(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		TupleDesc	tuple_desc;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
+		funcctx->tuple_desc = BlessTupleDesc(tuple_desc);
+		funcctx->max_calls = H3_STAT_COUNT;
+
+		MemoryContextSwitchTo(oldcontext);
+
+		stats_flush();
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		H3StatCounters *counters = &stats_shared()->counters[funcctx->call_cntr];
+		const H3StatDesc *desc = &stat_descs[funcctx->call_cntr];
+		Datum		values[6];
+		bool		nulls[6] = {false};
+		HeapTuple	tuple;
+
+		values[0] = CStringGetTextDatum(desc->name);
+		values[1] = Int64GetDatum(pg_atomic_read_u64(&counters->calls));
+		values[2] = Float8GetDatum(pg_atomic_read_u64(&counters->total_time) / 1e6);
+		values[3] = Float8GetDatum(pg_atomic_read_u64(&counters->max_time) / 1e6);
+		values[4] = Int64GetDatum(pg_atomic_read_u64(&counters->cells));
+		values[5] = Int64GetDatum(pg_atomic_read_u64(&counters->max_mem_growth_bytes));
+
+		nulls[2] = nulls[3] = nulls[4] = nulls[5] = desc->kind == H3_STAT_KIND_INDEX;
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
+
+/* Discards all collected statistics */
+Datum
+h3_stat_reset(PG_FUNCTION_ARGS)
+{
+	H3StatsShared *area = stats_shared();
+
+	memset(state.pending, 0, sizeof(state.pending));
+	state.dirty = false;
+
+	for (int i = 0; i < H3_STAT_COUNT; i++)
+	{
+		H3StatCounters *counters = &area->counters[i];
+
+		pg_atomic_write_u64(&counters->calls, 0);
+		pg_atomic_write_u64(&counters->total_time, 0);
+		pg_atomic_write_u64(&counters->max_time, 0);
+		pg_atomic_write_u64(&counters->cells, 0);
+		pg_atomic_write_u64(&counters->max_mem_growth_bytes, 0);
+	}
+
+	PG_RETURN_VOID();
+}
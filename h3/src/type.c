@@ -19,6 +19,10 @@
 
 #include <fmgr.h> // PG_FUNCTION_ARGS
 #include <libpq/pqformat.h> // needed for send/recv functions
+#include <port/pg_bswap.h> // pg_bswap64
+#include <utils/array.h> // ArrayType
+#include <utils/lsyscache.h> // get_element_type
+#include <utils/memutils.h> // MaxAllocSize
 
 #include "error.h"
 #include "type.h"
@@ -30,6 +34,11 @@ PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_send);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_recv);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_to_bigint);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(bigint_to_h3index);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_packed);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_from_packed);
+
+/* Longest LEB128 encoding of a 64-bit value */
+#define VARINT_MAX_BYTES 10
 
 /* textual input/output functions */
 Datum
@@ -90,3 +99,190 @@ bigint_to_h3index(PG_FUNCTION_ARGS)
 
 	PG_RETURN_H3INDEX(bigint);
 }
+
+/*
+ * Packed cell arrays
+ *
+ * The plain form is the array data itself, one little-endian uint64 per
+ * cell, so on little-endian hosts both directions are a single memcpy. The
+ * delta form stores the first cell and then the difference to the previous
+ * cell (modulo 2^64) as LEB128 varints, which takes 2-4 bytes per cell for
+ * sorted cells that are close to each other.
+ */
+
+/* Converts between host and little-endian byte order */
+#ifdef WORDS_BIGENDIAN
+#define h3index_le(x) pg_bswap64(x)
+#else
+#define h3index_le(x) (x)
+#endif
+
+static inline uint8 *
+varint_write(uint8 *out, uint64 value)
+{
+	while (value >= 0x80)
+	{
+		*out++ = (uint8) (value | 0x80);
+		value >>= 7;
+	}
+	*out++ = (uint8) value;
+	return out;
+}
+
+/* Allocates a one-dimensional h3index array with room for count cells */
+static ArrayType *
+make_h3index_array(FunctionCallInfo fcinfo, int64 count)
+{
+	Oid			elemtype = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+	int32		nbytes;
+	ArrayType  *result;
+
+	ASSERT(
+		count <= (int64) ((MaxAllocSize - ARR_OVERHEAD_NONULLS(1)) / sizeof(H3Index)),
+		ERRCODE_PROGRAM_LIMIT_EXCEEDED,
+		"packed cells hold more than the maximum of %zu cells",
+		(MaxAllocSize - ARR_OVERHEAD_NONULLS(1)) / sizeof(H3Index)
+	);
+
+	if (count == 0)
+		return construct_empty_array(elemtype);
+
+	nbytes = ARR_OVERHEAD_NONULLS(1) + count * sizeof(H3Index);
+	result = palloc(nbytes);
+	SET_VARSIZE(result, nbytes);
+	result->ndim = 1;
+	result->dataoffset = 0;
+	result->elemtype = elemtype;
+	ARR_DIMS(result)[0] = count;
+	ARR_LBOUND(result)[0] = 1;
+
+	return result;
+}
+
+/* Packs the cells into a bytea of little-endian uint64, optionally delta encoded */
+Datum
+h3_cells_to_packed(PG_FUNCTION_ARGS)
+{
+	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+	bool		delta = PG_GETARG_BOOL(1);
+	int			count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+	const H3Index *cells = (const H3Index *) ARR_DATA_PTR(array);
+	bytea	   *result;
+
+	ASSERT(
+		!array_contains_nulls(array),
+		ERRCODE_NULL_VALUE_NOT_ALLOWED,
+		"cells array must not contain NULL values"
+	);
+
+	if (!delta)
+	{
+		result = palloc(VARHDRSZ + count * sizeof(H3Index));
+		SET_VARSIZE(result, VARHDRSZ + count * sizeof(H3Index));
+#ifdef WORDS_BIGENDIAN
+		for (int i = 0; i < count; i++)
+			((H3Index *) VARDATA(result))[i] = h3index_le(cells[i]);
+#else
+		memcpy(VARDATA(result), cells, count * sizeof(H3Index));
+#endif
+	}
+	else
+	{
+		Size		maxBytes = VARHDRSZ + (Size) count * VARINT_MAX_BYTES;
+		uint8	   *out;
+		H3Index		previous = 0;
+
+		result = palloc(Min(maxBytes, MaxAllocSize));
+		out = (uint8 *) VARDATA(result);
+		for (int i = 0; i < count; i++)
+		{
+			if ((char *) out - (char *) result > MaxAllocSize - VARINT_MAX_BYTES)
+				ereport(ERROR,
+						(errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+						 errmsg("packed cells exceed the maximum bytea size")));
+			out = varint_write(out, cells[i] - previous);
+			previous = cells[i];
+		}
+		SET_VARSIZE(result, (char *) out - (char *) result);
+	}
+
+	PG_RETURN_BYTEA_P(result);
+}
+
+/* Unpacks cells written by h3_cells_to_packed */
+Datum
+h3_cells_from_packed(PG_FUNCTION_ARGS)
+{
+	bytea	   *packed = PG_GETARG_BYTEA_PP(0);
+	bool		delta = PG_GETARG_BOOL(1);
+	const uint8 *data = (const uint8 *) VARDATA_ANY(packed);
+	Size		size = VARSIZE_ANY_EXHDR(packed);
+	ArrayType  *result;
+	H3Index    *cells;
+
+	if (!delta)
+	{
+		ASSERT(
+			size % sizeof(H3Index) == 0,
+			ERRCODE_INVALID_BINARY_REPRESENTATION,
+			"packed cells length %zu is not a multiple of %zu bytes",
+			size, sizeof(H3Index)
+		);
+
+		result = make_h3index_array(fcinfo, size / sizeof(H3Index));
+		cells = (H3Index *) ARR_DATA_PTR(result);
+#ifdef WORDS_BIGENDIAN
+		for (Size i = 0; i < size / sizeof(H3Index); i++)
+		{
+			H3Index		value;
+
+			memcpy(&value, data + i * sizeof(H3Index), sizeof(H3Index));
+			cells[i] = h3index_le(value);
+		}
+#else
+		if (size > 0)
+			memcpy(cells, data, size);
+#endif
+	}
+	else
+	{
+		int64		count = 0;
+		H3Index		value = 0;
+		int			shift = 0;
+
+		/* every value ends with the first byte that has no continuation bit */
+		for (Size i = 0; i < size; i++)
+			count += (data[i] & 0x80) == 0;
+
+		ASSERT(
+			size == 0 || (data[size - 1] & 0x80) == 0,
+			ERRCODE_INVALID_BINARY_REPRESENTATION,
+			"packed cells end in the middle of a value"
+		);
+
+		/*
+		 * value is not reset between cells: adding the 7-bit groups of a
+		 * delta to the previous cell yields the next one.
+		 */
+		result = make_h3index_array(fcinfo, count);
+		cells = count > 0 ? (H3Index *) ARR_DATA_PTR(result) : NULL;
+		for (Size i = 0; i < size; i++)
+		{
+			ASSERT(
+				shift < 64,
+				ERRCODE_INVALID_BINARY_REPRESENTATION,
+				"packed cells contain a value longer than %d bytes",
+				VARINT_MAX_BYTES
+			);
+			value += (H3Index) (data[i] & 0x7f) << shift;
+			shift += 7;
+			if ((data[i] & 0x80) == 0)
+			{
+				*cells++ = value;
+				shift = 0;
+			}
+		}
+	}
+
+	PG_RETURN_ARRAYTYPE_P(result);
+}
@@ -0,0 +1,73 @@
+\pset tuples_only on
+\set hexagon '\'8a1fb46622dffff\''
+\set pentagon '\'8a0800000007fff\''
+
+--
+-- TEST input and output
+--
+SELECT :hexagon::h3cell, :pentagon::h3cell, pg_column_size(:hexagon::h3cell);
+
+-- finer than resolution 10
+SELECT '8f1fb46622d8591'::h3cell;
+
+-- not a valid cell
+SELECT '0'::h3cell;
+
+--
+-- TEST casts
+--
+SELECT h3_cell_to_parent(:hexagon::h3cell) = h3_cell_to_parent(:hexagon::h3index);
+
+CREATE TABLE h3_test_h3cell (cell h3cell, value integer);
+INSERT INTO h3_test_h3cell SELECT h3_cell_to_children('841fb47ffffffff', 7), 1;
+INSERT INTO h3_test_h3cell SELECT h3_cell_to_children('8009fffffffffff', 5), 2;
+INSERT INTO h3_test_h3cell SELECT h3_get_res_0_cells(), 3;
+
+SELECT bool_and(cell::h3index::h3cell = cell) FROM h3_test_h3cell;
+
+-- binary io uses the h3index format
+\copy h3_test_h3cell TO 'h3_test_h3cell.bin' (FORMAT binary)
+CREATE TEMPORARY TABLE h3_test_h3cell_recv (cell h3index, value integer);
+\copy h3_test_h3cell_recv FROM 'h3_test_h3cell.bin' (FORMAT binary)
+SELECT COUNT(*) = (SELECT COUNT(*) FROM h3_test_h3cell) FROM h3_test_h3cell_recv JOIN h3_test_h3cell USING (cell, value);
+
+--
+-- TEST ordering matches h3index
+--
+SELECT bool_and(a = b) FROM (
+    SELECT row_number() OVER (ORDER BY cell) r, cell::h3index a FROM h3_test_h3cell
+) x JOIN (
+    SELECT row_number() OVER (ORDER BY cell::h3index) r, cell::h3index b FROM h3_test_h3cell
+) y USING (r);
+
+SELECT :hexagon::h3cell < :hexagon::h3index, :hexagon::h3cell <= :hexagon::h3index,
+    :hexagon::h3index = :hexagon::h3cell, :pentagon::h3index < :hexagon::h3cell;
+
+--
+-- TEST operator classes
+--
+CREATE INDEX h3_test_h3cell_btree ON h3_test_h3cell (cell);
+CREATE INDEX h3_test_h3cell_hash ON h3_test_h3cell USING hash (cell);
+CREATE INDEX h3_test_h3cell_brin ON h3_test_h3cell USING brin (cell);
+SET enable_seqscan TO false;
+
+SELECT COUNT(*) = 343 FROM h3_test_h3cell
+WHERE cell BETWEEN '871fb4000ffffff'::h3index AND '871fb47ffffffff'::h3index;
+
+DROP INDEX h3_test_h3cell_btree;
+SELECT COUNT(*) = 1 FROM h3_test_h3cell WHERE cell = '871fb4600ffffff'::h3index;
+
+DROP INDEX h3_test_h3cell_hash;
+SELECT COUNT(*) = 1 FROM h3_test_h3cell WHERE cell = '871fb4600ffffff'::h3index;
+
+RESET enable_seqscan;
+
+-- hash join with h3index
+SET enable_mergejoin TO false;
+SET enable_nestloop TO false;
+SELECT COUNT(*) = (SELECT COUNT(*) FROM h3_test_h3cell)
+FROM h3_test_h3cell JOIN h3_test_h3cell_recv ON h3_test_h3cell.cell = h3_test_h3cell_recv.cell;
+RESET enable_mergejoin;
+RESET enable_nestloop;
+
+DROP TABLE h3_test_h3cell;
@@ -71,6 +71,16 @@ SELECT bool_and(expected_pos = actual_pos) FROM (
 	FROM h3_cell_to_children(:hexagon, :resolution + 1) child
 ) q;
 
+-- positions skip the deleted subsequence under pentagons
+SELECT bool_and(expected_pos = actual_pos) FROM (
+	SELECT row_number() OVER () - 1 AS expected_pos,
+		h3_cell_to_child_pos(child, :resolution) AS actual_pos
+	FROM h3_cell_to_children(:pentagon, :resolution + 2) child
+) q;
+
+SELECT bool_and(h3_child_pos_to_cell(h3_cell_to_child_pos(child, :resolution - 1), h3_cell_to_parent(:hexagon), :resolution + 2) = child)
+FROM h3_cell_to_children(:hexagon, :resolution + 2) child;
+
 --
 -- TEST h3_compact_cells and h3_uncompact_cells
 --
@@ -115,3 +125,48 @@ SELECT array_agg(result) is null FROM (
 	SELECT h3_cell_to_children_slow(:hexagon, :resolution + 3) result
 	EXCEPT SELECT h3_cell_to_children(:hexagon, :resolution + 3) result
 ) q;
+
+--
+-- TEST h3_rollup
+--
+
+CREATE TABLE rollup_input AS
+SELECT c AS cell, (c::bigint % 97)::double precision AS value
+FROM (
+	SELECT h3_cell_to_children(:hexagon, :resolution + 3) c
+	UNION ALL SELECT h3_cell_to_children(:pentagon, :resolution + 2)
+	UNION ALL SELECT :hexagon
+) q;
+
+-- every level equals grouping by the parent at that resolution
+SELECT COUNT(*) = 0 FROM (
+	(
+		SELECT (unnest(h3_rollup(cell, value, :resolution - 2, :resolution + 2))).*
+		FROM rollup_input
+		EXCEPT ALL
+		SELECT r, h3_cell_to_parent(cell, r), COUNT(*), SUM(value), MIN(value), MAX(value)
+		FROM rollup_input, generate_series(:resolution - 2, :resolution + 2) r
+		WHERE h3_get_resolution(cell) >= r
+		GROUP BY 1, 2
+	) UNION ALL (
+		SELECT r, h3_cell_to_parent(cell, r), COUNT(*), SUM(value), MIN(value), MAX(value)
+		FROM rollup_input, generate_series(:resolution - 2, :resolution + 2) r
+		WHERE h3_get_resolution(cell) >= r
+		GROUP BY 1, 2
+		EXCEPT ALL
+		SELECT (unnest(h3_rollup(cell, value, :resolution - 2, :resolution + 2))).*
+		FROM rollup_input
+	)
+) q;
+
+-- cells coarser than min_res and NULLs are skipped
+SELECT (unnest(h3_rollup(cell, value, :resolution, :resolution))).*
+FROM (VALUES (:hexagon, 1), (h3_cell_to_parent(:hexagon), 2), (NULL, 3), (:hexagon, NULL)) v(cell, value);
+
+SELECT h3_rollup(cell, 1, 0, 15) IS NULL FROM (VALUES (NULL::h3index)) v(cell);
+
+-- fails on invalid resolutions
+SELECT h3_rollup(:hexagon, 1, 5, 4);
+SELECT h3_rollup(:hexagon, 1, 0, 16);
+
+DROP TABLE rollup_input;
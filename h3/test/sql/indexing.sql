@@ -60,3 +60,30 @@ CREATE FUNCTION h3_fail_indexing_cell_to_parent() RETURNS boolean LANGUAGE PLPGS
     $$;
 SELECT h3_fail_indexing_cell_to_parent();
 DROP FUNCTION h3_fail_indexing_cell_to_parent;
+
+--
+-- TEST h3_bin_points_agg
+--
+
+-- same counts as grouping by the indexed cell, NULL points skipped
+WITH points AS (
+	SELECT point(i % 40 * 0.37 - 7, i % 23 * 0.41 + 40) p FROM generate_series(1, 1000) i
+	UNION ALL SELECT NULL
+)
+SELECT COUNT(*) = 0 FROM (
+	(
+		SELECT (unnest(h3_bin_points_agg(p, 5))).* FROM points
+		EXCEPT ALL
+		SELECT h3_latlng_to_cell(p, 5), COUNT(*) FROM points WHERE p IS NOT NULL GROUP BY 1
+	) UNION ALL (
+		SELECT h3_latlng_to_cell(p, 5), COUNT(*) FROM points WHERE p IS NOT NULL GROUP BY 1
+		EXCEPT ALL
+		SELECT (unnest(h3_bin_points_agg(p, 5))).* FROM points
+	)
+) q;
+
+SELECT (unnest(h3_bin_points_agg(p, :resolution))).*
+FROM (VALUES (:geo), (:geo), (NULL)) v(p);
+
+-- fails on invalid resolution
+SELECT h3_bin_points_agg(:geo, 16);
@@ -110,3 +110,16 @@ SELECT h3_is_pentagon(:pentagon) AND NOT h3_is_pentagon(:hexagon);
 --
 SELECT h3_get_icosahedron_faces('851c0047fffffff') = ARRAY[11,6];
 SELECT h3_get_icosahedron_faces('851c004bfffffff') = ARRAY[6];
+
+--
+-- TEST h3_get_resolutions and h3_validate_cells
+--
+
+SELECT h3_get_resolutions(ARRAY[[:hexagon, NULL], [h3_cell_to_parent(:pentagon), :invalid]]);
+
+-- skips NULLs, rejects a pentagon child in the deleted K axes direction and edges
+SELECT h3_validate_cells(ARRAY[:hexagon, NULL, :invalid, :pentagon, '831c01fffffffff', h3_cells_to_directed_edge(:hexagon, :pentagon)]);
+SELECT h3_validate_cells('[0:1]={831c02fffffffff,0}'::h3index[]);
+SELECT h3_validate_cells(ARRAY[]::h3index[]);
+
+SELECT h3_validate_cells(ARRAY(SELECT h3_cell_to_children(:pentagon, 6))) = '{}';
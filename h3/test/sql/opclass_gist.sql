@@ -402,5 +402,116 @@ SELECT hex = :hexagon FROM h3_test_dist ORDER BY hex <-> :hexagon LIMIT 1;
 RESET enable_seqscan;
 DROP TABLE h3_test_dist;
 
+--
+-- TEST h3_gist_index_stats
+--
+CREATE TABLE h3_test_gist_stats (hex h3index);
+INSERT INTO h3_test_gist_stats SELECT h3_cell_to_children(:hexagon, 8);
+INSERT INTO h3_test_gist_stats SELECT h3_get_res_0_cells();
+CREATE INDEX h3_test_gist_stats_idx ON h3_test_gist_stats USING gist(hex h3index_gist_ops_experimental);
+
+-- single root page, leaf level holds every row by resolution
+SELECT pages = 1 FROM h3_gist_index_stats('h3_test_gist_stats_idx') WHERE level = 0;
+SELECT tuples = 16929 AND resolutions[1] = 122 AND resolutions[9] = 16807 AND overlap IS NULL
+FROM h3_gist_index_stats('h3_test_gist_stats_idx')
+ORDER BY level DESC LIMIT 1;
+SELECT bool_and(avg_fill > 0 AND avg_fill <= 1 AND null_keys BETWEEN 0 AND 1)
+FROM h3_gist_index_stats('h3_test_gist_stats_idx');
+
+-- internal levels have one downlink per key on the level below
+SELECT bool_and(s.tuples = c.pages)
+FROM h3_gist_index_stats('h3_test_gist_stats_idx') s
+JOIN h3_gist_index_stats('h3_test_gist_stats_idx') c ON c.level = s.level + 1;
+
+-- only GiST indexes using the h3index opclass are accepted
+CREATE INDEX h3_test_gist_stats_btree ON h3_test_gist_stats (hex);
+SELECT h3_gist_index_stats('h3_test_gist_stats_btree');
+SELECT h3_gist_index_stats('h3_test_gist_stats');
+DROP TABLE h3_test_gist_stats;
+
+--
+-- TEST picksplit and sorted build keep mixed resolutions of one base cell
+-- in concrete subtrees, and index scans agree with sequential scans
+--
+CREATE TABLE h3_test_gist_split (hex h3index);
+INSERT INTO h3_test_gist_split
+  SELECT h3_cell_to_children(:hexagon, r) FROM generate_series(4, 7) r;
+-- sorted build
+CREATE INDEX h3_test_gist_split_idx ON h3_test_gist_split USING gist(hex h3index_gist_ops_experimental);
+SELECT bool_and(null_keys = 0) FROM h3_gist_index_stats('h3_test_gist_split_idx');
+-- page splits on insert
+INSERT INTO h3_test_gist_split
+  SELECT h3_cell_to_children(h3_cell_to_center_child(:hexagon, 4), 8);
+SELECT bool_and(null_keys = 0) FROM h3_gist_index_stats('h3_test_gist_split_idx');
+
+SET enable_seqscan = off;
+SELECT array_agg(c ORDER BY p) AS idx INTO TEMP gist_split_idx FROM (
+  SELECT p, (SELECT COUNT(*) FROM h3_test_gist_split WHERE hex <@ p) c
+  FROM h3_cell_to_children(:hexagon, 5) p
+) q;
+RESET enable_seqscan;
+SET enable_indexscan = off;
+SET enable_bitmapscan = off;
+SELECT array_agg(c ORDER BY p) AS seq INTO TEMP gist_split_seq FROM (
+  SELECT p, (SELECT COUNT(*) FROM h3_test_gist_split WHERE hex <@ p) c
+  FROM h3_cell_to_children(:hexagon, 5) p
+) q;
+RESET enable_indexscan;
+RESET enable_bitmapscan;
+SELECT idx = seq FROM gist_split_idx, gist_split_seq;
+DROP TABLE gist_split_idx, gist_split_seq, h3_test_gist_split;
+
+--
+-- TEST grid radius (<@ h3_grid_radius)
+--
+-- GiST and SP-GiST scans find the same rows as a sequential scan, around
+-- random origins, every pentagon and origins spanning icosahedron faces
+SELECT setseed(0.25);
+CREATE TEMP TABLE h3_test_radius_origins AS
+  SELECT h3_latlng_to_cell(point(random() * 360 - 180, random() * 180 - 90), 3) AS origin
+  FROM generate_series(1, 24)
+  UNION SELECT h3_get_pentagons(3)
+  UNION (
+    SELECT c FROM h3_cell_to_children('8003fffffffffff'::h3index, 3) c
+    WHERE array_length(h3_get_icosahedron_faces(c), 1) > 1
+    ORDER BY c LIMIT 6
+  );
+CREATE TABLE h3_test_radius AS
+  SELECT DISTINCT hex FROM (
+    SELECT h3_grid_disk(origin, 3) AS hex FROM h3_test_radius_origins
+    UNION ALL SELECT h3_cell_to_children(h3_grid_disk(origin, 1), 5) FROM h3_test_radius_origins
+    UNION ALL SELECT h3_cell_to_parent(origin, 1) FROM h3_test_radius_origins
+  ) q;
+CREATE TEMP TABLE h3_test_radius_queries AS
+  SELECT (q, floor(random() * 16)::int)::h3_grid_radius AS radius
+  FROM h3_test_radius_origins,
+    LATERAL (VALUES (origin), (h3_cell_to_center_child(origin, 5)), (h3_cell_to_parent(origin, 2))) v(q);
+
+CREATE TEMP TABLE h3_test_radius_seq AS
+  SELECT radius, (SELECT COUNT(*) FROM h3_test_radius WHERE h3index_distance(hex, (radius).origin) <= (radius).k) AS n
+  FROM h3_test_radius_queries;
+
+SET enable_seqscan = off;
+CREATE INDEX h3_test_radius_idx ON h3_test_radius USING gist(hex h3index_gist_ops_experimental);
+CREATE TEMP TABLE h3_test_radius_gist AS
+  SELECT radius, (SELECT COUNT(*) FROM h3_test_radius WHERE hex <@ radius) AS n
+  FROM h3_test_radius_queries;
+-- the commutator finds the same rows
+SELECT COUNT(*) = (SELECT COUNT(*) FROM h3_test_radius WHERE hex <@ (:hexagon, 1)::h3_grid_radius)
+FROM h3_test_radius WHERE (:hexagon, 1)::h3_grid_radius @> hex;
+DROP INDEX h3_test_radius_idx;
+CREATE INDEX h3_test_radius_idx ON h3_test_radius USING spgist(hex h3index_ops_experimental);
+CREATE TEMP TABLE h3_test_radius_spgist AS
+  SELECT radius, (SELECT COUNT(*) FROM h3_test_radius WHERE hex <@ radius) AS n
+  FROM h3_test_radius_queries;
+RESET enable_seqscan;
+
+SELECT COUNT(*) = (SELECT COUNT(*) FROM h3_test_radius_queries) AND bool_and(s.n = g.n AND s.n = p.n)
+FROM h3_test_radius_seq s
+JOIN h3_test_radius_gist g USING (radius)
+JOIN h3_test_radius_spgist p USING (radius);
+DROP TABLE h3_test_radius_origins, h3_test_radius_queries, h3_test_radius_seq,
+  h3_test_radius_gist, h3_test_radius_spgist, h3_test_radius;
+
 -- cleanup
 DROP TABLE h3_test_gist;
@@ -1,5 +1,6 @@
 \pset tuples_only on
 \set hexagon '\'831c02fffffffff\'::h3index'
+\set pentagon '\'831c00fffffffff\'::h3index'
 
 CREATE TABLE h3_test_spgist (hex h3index);
 CREATE INDEX SPGIST_IDX ON h3_test_spgist USING spgist(hex h3index_ops_experimental);
@@ -175,4 +176,25 @@ JOIN spgist_cross_base_cells q ON t.hex <@ q.bc;
 RESET enable_seqscan;
 
 DROP TABLE spgist_cross_base_cells;
+
+--
+-- TEST h3_spgist_index_stats
+--
+-- every row is reachable through the tree
+SELECT SUM(leaf_tuples) = (SELECT COUNT(*) FROM h3_test_spgist)
+FROM h3_spgist_index_stats('SPGIST_IDX');
+-- the root is a single inner tuple routing by base cell
+SELECT pages = 1 AND inner_tuples = 1 AND null_prefixes = 1
+FROM h3_spgist_index_stats('SPGIST_IDX') WHERE level = 0;
+SELECT bool_and(avg_fill > 0 AND avg_fill <= 1)
+FROM h3_spgist_index_stats('SPGIST_IDX');
+
+-- a small index is a single leaf page
+CREATE TABLE h3_test_spgist_stats (hex h3index);
+CREATE INDEX SPGIST_STATS_IDX ON h3_test_spgist_stats USING spgist(hex h3index_ops_experimental);
+INSERT INTO h3_test_spgist_stats VALUES (:hexagon), (h3_cell_to_parent(:hexagon));
+SELECT level, pages, inner_tuples, leaf_tuples FROM h3_spgist_index_stats('SPGIST_STATS_IDX');
+SELECT h3_spgist_index_stats('h3_test_spgist_stats');
+DROP TABLE h3_test_spgist_stats;
+
 DROP TABLE h3_test_spgist;
@@ -102,3 +102,104 @@ SELECT array_agg(result) is null FROM (
     ) qq
     EXCEPT SELECT h3_grid_disk(h3_cell_to_center_child(:res0index), 2) result
 ) q;
+
+--
+-- TEST h3_polygon_to_cells_partition
+--
+
+-- parts are disjoint and together give h3_polygon_to_cells, with holes
+WITH poly AS (
+    SELECT exterior, holes FROM h3_cells_to_multi_polygon(:hollow)
+), parts AS (
+    SELECT nparts, h3_polygon_to_cells_partition(exterior, holes, 4, p, nparts) cell
+    FROM poly, (VALUES (1), (3), (7), (40)) n(nparts), generate_series(0, nparts - 1) p
+)
+SELECT bool_and(total = expected AND dist = expected)
+    AND NOT EXISTS (SELECT cell FROM parts EXCEPT SELECT h3_polygon_to_cells(exterior, holes, 4) FROM poly)
+FROM (SELECT nparts, count(*) total, count(DISTINCT cell) dist FROM parts GROUP BY nparts) q,
+    (SELECT count(*) expected FROM poly, h3_polygon_to_cells(exterior, holes, 4)) f;
+
+-- polygons crossing the antimeridian are filled unclipped
+SELECT count(*) = (SELECT count(*) FROM h3_polygon_to_cells(polygon '((170,-10),(-170,-10),(-170,10),(170,10))', null, 3))
+    AND count(DISTINCT cell) = count(*)
+FROM generate_series(0, 3) p,
+    h3_polygon_to_cells_partition(polygon '((170,-10),(-170,-10),(-170,10),(170,10))', null, 3, p, 4) cell;
+
+-- part must be within nparts
+CREATE FUNCTION h3_test_polygon_to_cells_partition_bad(part integer, nparts integer) RETURNS boolean LANGUAGE PLPGSQL
+    AS $$
+        BEGIN
+            PERFORM h3_polygon_to_cells_partition(polygon '((0,0),(1,0),(1,1),(0,1))', null, 5, part, nparts);
+            RETURN false;
+        EXCEPTION WHEN OTHERS THEN
+            RETURN true;
+        END;
+    $$;
+SELECT h3_test_polygon_to_cells_partition_bad(3, 3);
+SELECT h3_test_polygon_to_cells_partition_bad(-1, 3);
+SELECT h3_test_polygon_to_cells_partition_bad(0, 0);
+DROP FUNCTION h3_test_polygon_to_cells_partition_bad;
+
+--
+-- TEST h3_region_prepare and h3_region_contains
+--
+
+-- prepared regions agree with planar point in polygon, with holes
+WITH region AS MATERIALIZED (
+    SELECT exterior, holes, res, h3_region_prepare(exterior, holes, res) prepared
+    FROM h3_cells_to_multi_polygon(:hollow), (VALUES (1), (3), (5)) r(res)
+), points AS (
+    SELECT point(-6.013 + x * 0.1271, 3.007 + y * 0.1181) p
+    FROM generate_series(0, 199) x, generate_series(0, 199) y
+)
+SELECT res, count(*) FILTER (WHERE h3_region_contains(prepared, p)) > 0,
+    count(*) FILTER (WHERE h3_region_contains(prepared, p) <> (
+        exterior @> p AND NOT coalesce((SELECT bool_or(hole @> p) FROM unnest(holes) hole), false)
+    ))
+FROM region, points GROUP BY res ORDER BY res;
+
+-- polygons crossing the antimeridian
+SELECT count(*) FILTER (WHERE
+    h3_region_contains(h3_region_prepare(polygon '((170,-10),(-170,-10),(-175,10),(170,10))', null, 3), point(x, y))
+    <> (polygon '((170,-10),(190,-10),(185,10),(170,10))' @> point(CASE WHEN x < 0 THEN x + 360 ELSE x END, y)))
+FROM generate_series(-179.9713, 179, 0.731) x, generate_series(-19.9871, 20, 0.613) y;
+
+-- rejects what h3_region_prepare did not produce
+CREATE FUNCTION h3_test_region_contains_bad() RETURNS boolean LANGUAGE PLPGSQL
+    AS $$
+        BEGIN
+            PERFORM h3_region_contains('\x0102'::bytea, point(0, 0));
+            RETURN false;
+        EXCEPTION WHEN OTHERS THEN
+            RETURN true;
+        END;
+    $$;
+SELECT h3_test_region_contains_bad();
+DROP FUNCTION h3_test_region_contains_bad;
+
+--
+-- TEST h3_tile_to_cells
+--
+
+-- the world tile holds every base cell
+SELECT count(*) = 122 FROM h3_tile_to_cells(0, 0, 0, 0);
+
+-- same as filling the outline of the tile
+WITH bounds AS (
+    SELECT (134 / 256.0 - 0.5) * 360 w, (135 / 256.0 - 0.5) * 360 e,
+        degrees(atan(sinh(pi() * (1 - 2 * 87 / 256.0)))) n,
+        degrees(atan(sinh(pi() * (1 - 2 * 88 / 256.0)))) s
+), tile AS (
+    SELECT format('((%s,%s),(%s,%s),(%s,%s),(%s,%s))', w, s, e, s, e, n, w, n)::polygon poly FROM bounds
+)
+SELECT array(SELECT h3_tile_to_cells(8, 134, 87, 6) c ORDER BY c)
+    = array(SELECT c FROM tile, h3_polygon_to_cells_experimental(poly, null, 6, 'overlapping_bbox') c ORDER BY c);
+
+-- margin grows the cover
+SELECT array(SELECT h3_tile_to_cells(8, 134, 87, 6, 0.125))
+    @> array(SELECT h3_tile_to_cells(8, 134, 87, 6))
+    AND (SELECT count(*) FROM h3_tile_to_cells(8, 134, 87, 6, 0.125))
+    > (SELECT count(*) FROM h3_tile_to_cells(8, 134, 87, 6));
+
+-- the tile must exist
+SELECT h3_tile_to_cells(2, 4, 0, 1);
@@ -0,0 +1,68 @@
+\pset tuples_only on
+\set cell '\'8928308280fffff\'::h3index'
+
+--
+-- TEST h3.track_stats
+--
+
+-- nothing is collected while tracking is off
+SELECT h3_stat_reset();
+SELECT count(*) FROM h3_grid_disk(:cell, 2);
+SELECT sum(calls) = 0 FROM h3_stat_functions;
+
+SET h3.track_stats TO true;
+
+-- calls and cells are counted per function
+SELECT count(*) FROM h3_grid_disk(:cell, 2);
+SELECT count(*) FROM h3_grid_disk(:cell, 1);
+SELECT calls = 2 AND cells = 19 + 7 AND total_time >= max_time
+FROM h3_stat_functions WHERE function = 'h3_grid_disk';
+
+SELECT count(*) FROM h3_compact_cells(ARRAY(SELECT h3_cell_to_children(:cell)));
+SELECT calls = 1 AND cells = 1
+FROM h3_stat_functions WHERE function = 'h3_compact_cells';
+
+-- index support functions only report calls
+CREATE TABLE h3_test_stats (hex h3index);
+INSERT INTO h3_test_stats SELECT h3_grid_disk(:cell, 10);
+CREATE INDEX ON h3_test_stats USING gist (hex h3index_gist_ops_experimental);
+SET enable_seqscan TO false;
+SELECT count(*) FROM h3_test_stats WHERE hex <@ h3_cell_to_parent(:cell, 7);
+RESET enable_seqscan;
+SELECT calls > 0 AND total_time IS NULL
+FROM h3_stat_functions WHERE function = 'h3index_gist_consistent';
+DROP TABLE h3_test_stats;
+
+-- reset discards everything
+SELECT h3_stat_reset();
+SELECT sum(calls) = 0 FROM h3_stat_functions;
+
+RESET h3.track_stats;
+
+--
+-- TEST h3.cell_cache_size
+--
+
+-- a cleared cache starts empty and cached results match uncached ones
+SET h3.cell_cache_size TO 0;
+SELECT entries = 0 FROM h3_cell_cache_stats();
+CREATE TEMP TABLE h3_test_cache AS
+SELECT h3_cell_to_boundary(:cell)::text AS boundary, h3_cell_area(:cell, 'm^2') AS area;
+SET h3.cell_cache_size TO 2;
+
+SELECT hits AS h, misses AS m FROM h3_cell_cache_stats() \gset
+SELECT h3_cell_to_boundary(:cell)::text = boundary FROM h3_test_cache;
+SELECT h3_cell_to_boundary(:cell)::text = boundary FROM h3_test_cache;
+SELECT h3_cell_area(:cell, 'm^2') = area FROM h3_test_cache;
+SELECT h3_cell_area(:cell, 'm^2') = area FROM h3_test_cache;
+SELECT entries = 1 AND hits = :h + 2 AND misses = :m + 2 FROM h3_cell_cache_stats();
+
+-- the least recently used cells are evicted
+SELECT count(h3_cell_to_boundary(c)) FROM h3_grid_disk(:cell, 1) c;
+SELECT entries = 2 AND evictions > 0 FROM h3_cell_cache_stats();
+SET h3.cell_cache_size TO 1;
+SELECT entries = 1 FROM h3_cell_cache_stats();
+RESET h3.cell_cache_size;
+-- the cache is off by default
+SELECT capacity = 0 AND entries = 0 FROM h3_cell_cache_stats();
+DROP TABLE h3_test_cache;
@@ -145,3 +145,37 @@ SELECT h3_test_grid_distance_invalid();
 
 -- they are inverse of each others
 SELECT :hexagon = h3_local_ij_to_cell(:origin, h3_cell_to_local_ij(:origin, :hexagon));
+
+--
+-- TEST h3_grid_disk_convolve
+--
+
+-- same as aggregating the disks, also around a pentagon
+WITH input AS (
+	SELECT cell, ((cell::bigint % 7) + 1)::double precision AS value
+	FROM (
+		SELECT h3_grid_disk(:hexagon, 2) cell
+		UNION SELECT h3_grid_disk(:pentagon, 1)
+	) q
+), expected AS (
+	SELECT kernel, d.index AS cell,
+		SUM(CASE kernel WHEN 'uniform' THEN 1 ELSE 1 - d.distance / 3.0 END * value) AS value
+	FROM input, h3_grid_disk_distances(cell, 2) d, (VALUES ('uniform'), ('linear')) k(kernel)
+	GROUP BY 1, 2
+), actual AS (
+	SELECT kernel, c.*
+	FROM (VALUES ('uniform'), ('linear')) k(kernel),
+		h3_grid_disk_convolve(
+			ARRAY(SELECT cell FROM input), ARRAY(SELECT value FROM input), 2, kernel) c
+)
+SELECT COUNT(*) = (SELECT COUNT(*) FROM expected)
+	AND bool_and(abs(actual.value - expected.value) < 1e-9)
+FROM actual JOIN expected USING (kernel, cell);
+
+-- k 0 returns the input, duplicates are summed
+SELECT * FROM h3_grid_disk_convolve(ARRAY[:hexagon, :hexagon, :origin]::h3index[], ARRAY[1, 2, 4], 0);
+
+-- fails on invalid input
+SELECT * FROM h3_grid_disk_convolve(ARRAY[:hexagon]::h3index[], ARRAY[1, 2], 1);
+SELECT * FROM h3_grid_disk_convolve(ARRAY[:hexagon]::h3index[], ARRAY[1], 1, 'gaussian');
+SELECT * FROM h3_grid_disk_convolve(ARRAY[:hexagon]::h3index[], ARRAY[1], -1);
@@ -39,3 +39,24 @@ SELECT array_agg(hex) is null FROM (
     SELECT hex FROM h3_test_binary_send
     EXCEPT SELECT hex FROM h3_test_binary_recv
 ) q;
+
+--
+-- TEST packed cell arrays
+--
+SELECT h3_cells_to_packed(ARRAY[:hexagon, :pentagon]);
+
+SELECT h3_cells_from_packed(h3_cells_to_packed(ARRAY[:hexagon, :pentagon]));
+
+SELECT h3_cells_to_packed(ARRAY[:hexagon, :hexagon, :pentagon], true);
+
+SELECT cells = h3_cells_from_packed(h3_cells_to_packed(cells, true), true) FROM (
+    SELECT array_agg(c ORDER BY c) cells FROM h3_cell_to_children(:pentagon, 7) c
+) q;
+
+SELECT h3_cells_from_packed(''), h3_cells_from_packed('', true);
+
+-- truncated input
+SELECT h3_cells_from_packed('\x0102');
+SELECT h3_cells_from_packed('\x81', true);
+
+SELECT h3_cells_to_packed(ARRAY[:hexagon, NULL]);
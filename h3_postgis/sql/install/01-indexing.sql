@@ -193,3 +193,38 @@ $$ LANGUAGE plpgsql IMMUTABLE STRICT PARALLEL SAFE;
 COMMENT ON FUNCTION
     h3_get_resolution_from_tile_zoom(integer, integer, integer, integer, integer)
 IS 'Returns the optimal H3 resolution for a specified XYZ tile zoom level, based on hexagon size in pixels and resolution limits';
+
+--@ availability: unreleased
+--@ refid: h3_cell_to_tile_geometry
+CREATE OR REPLACE FUNCTION h3_cell_to_tile_geometry(
+    cell h3index,
+    z integer,
+    x integer,
+    y integer,
+    extent integer DEFAULT 4096,
+    buffer integer DEFAULT 256
+) RETURNS @extschema:postgis@.geometry
+AS $$
+DECLARE
+    self_schema CONSTANT text := (
+        SELECT extnamespace::regnamespace::text
+        FROM pg_catalog.pg_extension
+        WHERE extname = 'h3_postgis'
+    );
+    wkb bytea;
+BEGIN
+    EXECUTE pg_catalog.format(
+        'SELECT %I.h3_cell_to_tile_wkb($1, $2, $3, $4, $5, $6)',
+        self_schema
+    )
+    INTO wkb
+    USING cell, z, x, y, extent, buffer;
+
+    RETURN wkb::@extschema:postgis@.geometry;
+END;
+$$ LANGUAGE plpgsql IMMUTABLE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION
+    h3_cell_to_tile_geometry(h3index, integer, integer, integer, integer, integer)
+IS 'Finds the boundary of the index in coordinates of the XYZ tile, ready for ST_AsMVT.
+
+Same as ST_AsMVTGeom(ST_Transform(h3_cell_to_boundary_geometry(cell), 3857), ST_TileEnvelope(z, x, y), extent, buffer), without going through PostGIS. Returns NULL if the cell misses the tile.';
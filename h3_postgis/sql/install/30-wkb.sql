@@ -27,6 +27,26 @@ Splits polygons when crossing 180th meridian.
 
 This function has to return WKB since Postgres does not provide multipolygon type.';
 
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_cell_to_boundary_twkb(cell h3index, prec integer DEFAULT 6) RETURNS bytea
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cell_to_boundary_twkb(h3index, integer)
+IS 'Finds the boundary of the index, converts to TWKB with the given number of decimal digits, like ST_AsTWKB.
+
+Splits polygons when crossing 180th meridian. TWKB carries no SRID.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_cell_to_tile_wkb(cell h3index, z integer, x integer, y integer, extent integer DEFAULT 4096, buffer integer DEFAULT 256) RETURNS bytea
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cell_to_tile_wkb(h3index, integer, integer, integer, integer, integer)
+IS 'Finds the boundary of the index in Web Mercator XYZ tile coordinates, converts to WKB.
+
+Clips it to the tile extended by buffer and snaps it to integers, with Y pointing down, like ST_AsMVTGeom. Returns NULL if the cell misses the tile.
+
+Casting the result to geometry skips the overhead of h3_cell_to_tile_geometry, e.g. `SELECT ST_AsMVT(t) FROM (SELECT h3_cell_to_tile_wkb(h3, z, x, y)::geometry AS geom FROM cells) t`.';
+
 --| # WKB regions functions
 
 --@ availability: 4.1.0
@@ -37,3 +57,12 @@ AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
 IS 'Create a LinkedGeoPolygon describing the outline(s) of a set of hexagons, converts to EWKB.
 
 Splits polygons when crossing 180th meridian.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_twkb(h3index[], prec integer DEFAULT 6) RETURNS bytea
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cells_to_multi_polygon_twkb(h3index[], integer)
+IS 'Outline of a set of hexagons as h3_cells_to_multi_polygon_wkb, converted to TWKB with the given number of decimal digits, like ST_AsTWKB.
+
+TWKB carries no SRID.';
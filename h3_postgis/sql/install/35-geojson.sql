@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+--| # GeoJSON functions
+
+CREATE OR REPLACE FUNCTION __h3_cells_to_geojson_agg_transfn(
+    state internal,
+    cell h3index,
+    properties jsonb)
+RETURNS internal
+AS 'h3_postgis', 'h3_cells_to_geojson_agg_transfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_cells_to_geojson_agg_combinefn(
+    state1 internal,
+    state2 internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_cells_to_geojson_agg_combinefn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_cells_to_geojson_agg_serialfn(state internal)
+RETURNS bytea
+AS 'h3_postgis', 'h3_cells_to_geojson_agg_serialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_cells_to_geojson_agg_deserialfn(serialized bytea, state internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_cells_to_geojson_agg_deserialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_cells_to_geojson_agg_finalfn(state internal)
+RETURNS json
+AS 'h3_postgis', 'h3_cells_to_geojson_agg_finalfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+--@ availability: unreleased
+CREATE AGGREGATE h3_cells_to_geojson_agg(cell h3index, properties jsonb) (
+    sfunc = __h3_cells_to_geojson_agg_transfn,
+    stype = internal,
+    finalfunc = __h3_cells_to_geojson_agg_finalfn,
+    combinefunc = __h3_cells_to_geojson_agg_combinefn,
+    serialfunc = __h3_cells_to_geojson_agg_serialfn,
+    deserialfunc = __h3_cells_to_geojson_agg_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_cells_to_geojson_agg(h3index, jsonb) IS
+'Builds a GeoJSON FeatureCollection with one feature per cell, with the cell as id and the given properties.
+
+Boundaries are split when crossing 180th meridian, like h3_cell_to_boundary_geometry, and written with 9 decimal digits, like ST_AsGeoJSON. NULL cells are skipped.';
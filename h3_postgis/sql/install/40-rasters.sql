@@ -395,37 +395,41 @@ AS $$
         (stats).max;
 $$ LANGUAGE SQL IMMUTABLE PARALLEL SAFE;
 
+-- Aggregate state is kept in C as count, sum, sum of squared differences from
+-- the mean, min and max. Partial states are merged pairwise, which keeps the
+-- standard deviation numerically stable and allows parallel aggregation.
 CREATE OR REPLACE FUNCTION __h3_raster_summary_stats_agg_transfn(
-    s1 h3_raster_summary_stats,
-    s2 h3_raster_summary_stats)
+    state internal,
+    stats h3_raster_summary_stats)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_summary_stats_agg_transfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_summary_stats_agg_combinefn(
+    state1 internal,
+    state2 internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_summary_stats_agg_combinefn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_summary_stats_agg_serialfn(state internal)
+RETURNS bytea
+AS 'h3_postgis', 'h3_raster_summary_stats_agg_serialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_summary_stats_agg_deserialfn(serialized bytea, state internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_summary_stats_agg_deserialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_summary_stats_agg_finalfn(state internal)
 RETURNS h3_raster_summary_stats
-AS $$
-    WITH total AS (
-        SELECT
-            (s1).count + (s2).count AS count,
-            (s1).sum + (s2).sum AS sum)
-    SELECT
-        t.count,
-        t.sum,
-        t.sum / t.count,
-        pg_catalog.sqrt(
-            (
-                -- sum of squared values: (variance + mean squared) * count
-                (((s1).stddev * (s1).stddev + (s1).mean * (s1).mean)) * (s1).count
-                + (((s2).stddev * (s2).stddev + (s2).mean * (s2).mean)) * (s2).count
-            )
-            / t.count
-            - ((t.sum * t.sum) / (t.count * t.count)) -- mean squared
-        ),
-        least((s1).min, (s2).min),
-        greatest((s1).max, (s2).max)
-    FROM total AS t;
-$$ LANGUAGE SQL IMMUTABLE STRICT PARALLEL SAFE;
+AS 'h3_postgis', 'h3_raster_summary_stats_agg_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 --@ availability: 4.1.1
 CREATE AGGREGATE h3_raster_summary_stats_agg(h3_raster_summary_stats) (
     sfunc = __h3_raster_summary_stats_agg_transfn,
-    stype = h3_raster_summary_stats,
+    stype = internal,
+    finalfunc = __h3_raster_summary_stats_agg_finalfn,
+    combinefunc = __h3_raster_summary_stats_agg_combinefn,
+    serialfunc = __h3_raster_summary_stats_agg_serialfn,
+    deserialfunc = __h3_raster_summary_stats_agg_deserialfn,
     parallel = safe
 );
 
@@ -602,6 +606,86 @@ COMMENT ON FUNCTION
     h3_raster_summary_subpixel(raster, integer, integer)
 IS 'Returns `h3_raster_summary_stats` for each H3 cell in raster for a given band. Assumes H3 cell is smaller than a pixel. Finds corresponding pixel for each H3 cell in raster.';
 
+-- Raster in EPSG:4326, coverage is computed in degrees
+CREATE OR REPLACE FUNCTION __h3_raster_to_4326(rast raster)
+RETURNS raster
+AS $$
+    SELECT CASE
+        WHEN @extschema:postgis_raster@.ST_SRID(rast) = 4326 THEN
+            rast
+        ELSE
+            @extschema:postgis_raster@.ST_Transform(rast, 4326)
+    END;
+$$ LANGUAGE SQL STABLE STRICT PARALLEL SAFE;
+
+-- Weighted stats for each H3 cell overlapping the raster given by its
+-- values (see ST_DumpValues) and georeference.
+CREATE OR REPLACE FUNCTION __h3_raster_coverage_summary(
+    vals double precision[],
+    upperleftx double precision,
+    upperlefty double precision,
+    scalex double precision,
+    scaley double precision,
+    skewx double precision,
+    skewy double precision,
+    resolution integer)
+RETURNS TABLE (
+    h3 h3index,
+    count double precision,
+    sum double precision,
+    mean double precision,
+    stddev double precision,
+    min double precision,
+    max double precision)
+AS 'h3_postgis', 'h3_raster_coverage_summary' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION h3_raster_summary_coverage(
+    rast raster,
+    resolution integer,
+    nband integer DEFAULT 1)
+RETURNS TABLE (h3 h3index, stats h3_raster_summary_stats)
+AS $$
+DECLARE
+    self_schema CONSTANT text := (
+        SELECT extnamespace::regnamespace::text
+        FROM pg_catalog.pg_extension
+        WHERE extname = 'h3_postgis'
+    );
+BEGIN
+    RETURN QUERY EXECUTE pg_catalog.format(
+        'SELECT
+             c.h3,
+             ROW(
+                 c.count,
+                 c.sum,
+                 c.mean,
+                 c.stddev,
+                 c.min,
+                 c.max
+             )::%1$I.h3_raster_summary_stats AS stats
+         FROM
+             %1$I.__h3_raster_to_4326($1) AS r,
+             @extschema:postgis_raster@.ST_MetaData(r) AS m,
+             %1$I.__h3_raster_coverage_summary(
+                 @extschema:postgis_raster@.ST_DumpValues(r, $3, TRUE),
+                 m.upperleftx,
+                 m.upperlefty,
+                 m.scalex,
+                 m.scaley,
+                 m.skewx,
+                 m.skewy,
+                 $2
+             ) AS c',
+        self_schema
+    )
+    USING rast, resolution, nband;
+END;
+$$ LANGUAGE plpgsql STABLE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION
+    h3_raster_summary_coverage(raster, integer, integer)
+IS 'Returns `h3_raster_summary_stats` for each H3 cell in raster for a given band. Computes the exact fraction of each pixel covered by each H3 cell and weights pixel values by it, so `count` is a fractional number of pixels. Rasters not in EPSG:4326 are transformed first.';
+
 --@ availability: 4.1.1
 CREATE OR REPLACE FUNCTION h3_raster_summary(
     rast raster,
@@ -778,20 +862,37 @@ COMMENT ON FUNCTION
 IS 'Convert raster summary to JSONB, example: `{"count": 10, "value": 2, "area": 16490.3423}`';
 
 CREATE OR REPLACE FUNCTION __h3_raster_class_summary_item_agg_transfn(
-    s1 h3_raster_class_summary_item,
-    s2 h3_raster_class_summary_item)
+    state internal,
+    item h3_raster_class_summary_item)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_class_summary_item_agg_transfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_class_summary_item_agg_combinefn(
+    state1 internal,
+    state2 internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_class_summary_item_agg_combinefn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_class_summary_item_agg_serialfn(state internal)
+RETURNS bytea
+AS 'h3_postgis', 'h3_raster_class_summary_item_agg_serialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_class_summary_item_agg_deserialfn(serialized bytea, state internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_class_summary_item_agg_deserialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_class_summary_item_agg_finalfn(state internal)
 RETURNS h3_raster_class_summary_item
-AS $$
-    SELECT
-        (s1).val,
-        (s1).count + (s2).count,
-        (s1).area + (s2).area;
-$$ LANGUAGE SQL IMMUTABLE STRICT PARALLEL SAFE;
+AS 'h3_postgis', 'h3_raster_class_summary_item_agg_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 --@ availability: 4.1.1
 CREATE AGGREGATE h3_raster_class_summary_item_agg(h3_raster_class_summary_item) (
-    stype = h3_raster_class_summary_item,
     sfunc = __h3_raster_class_summary_item_agg_transfn,
+    stype = internal,
+    finalfunc = __h3_raster_class_summary_item_agg_finalfn,
+    combinefunc = __h3_raster_class_summary_item_agg_combinefn,
+    serialfunc = __h3_raster_class_summary_item_agg_serialfn,
+    deserialfunc = __h3_raster_class_summary_item_agg_deserialfn,
     parallel = safe
 );
 
@@ -1041,6 +1142,89 @@ COMMENT ON FUNCTION
     h3_raster_class_summary_subpixel(raster, integer, integer)
 IS 'Returns `h3_raster_class_summary_item` for each H3 cell and value for a given band. Assumes H3 cell is smaller than a pixel. Finds corresponding pixel for each H3 cell in raster.';
 
+-- Weighted pixel count for each H3 cell and value of the raster given by
+-- its values (see ST_DumpValues) and georeference.
+CREATE OR REPLACE FUNCTION __h3_raster_class_coverage_summary(
+    vals double precision[],
+    upperleftx double precision,
+    upperlefty double precision,
+    scalex double precision,
+    scaley double precision,
+    skewx double precision,
+    skewy double precision,
+    resolution integer)
+RETURNS TABLE (h3 h3index, val integer, count double precision)
+AS 'h3_postgis', 'h3_raster_class_coverage_summary' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION h3_raster_class_summary_coverage(
+    rast raster,
+    resolution integer,
+    nband integer DEFAULT 1)
+RETURNS TABLE (h3 h3index, val integer, summary h3_raster_class_summary_item)
+AS $$
+DECLARE
+    self_schema CONSTANT text := (
+        SELECT extnamespace::regnamespace::text
+        FROM pg_catalog.pg_extension
+        WHERE extname = 'h3_postgis'
+    );
+    rast4326 @extschema:postgis_raster@.raster;
+    poly @extschema:postgis@.geometry;
+    pixel_area double precision;
+BEGIN
+    -- coverage and pixel area both come from the transformed raster
+    EXECUTE pg_catalog.format(
+        'SELECT %1$I.__h3_raster_to_4326($1)',
+        self_schema
+    )
+    INTO rast4326
+    USING rast;
+
+    EXECUTE pg_catalog.format(
+        'SELECT %1$I.__h3_raster_to_polygon($1, $2)',
+        self_schema
+    )
+    INTO poly
+    USING rast4326, nband;
+
+    EXECUTE pg_catalog.format(
+        'SELECT %1$I.__h3_raster_polygon_pixel_area($1, $2)',
+        self_schema
+    )
+    INTO pixel_area
+    USING rast4326, poly;
+
+    RETURN QUERY EXECUTE pg_catalog.format(
+        'SELECT
+             c.h3,
+             c.val,
+             ROW(
+                 c.val,
+                 c.count,
+                 c.count * $4
+             )::%1$I.h3_raster_class_summary_item AS summary
+         FROM
+             @extschema:postgis_raster@.ST_MetaData($1) AS m,
+             %1$I.__h3_raster_class_coverage_summary(
+                 @extschema:postgis_raster@.ST_DumpValues($1, $3, TRUE),
+                 m.upperleftx,
+                 m.upperlefty,
+                 m.scalex,
+                 m.scaley,
+                 m.skewx,
+                 m.skewy,
+                 $2
+             ) AS c',
+        self_schema
+    )
+    USING rast4326, resolution, nband, pixel_area;
+END;
+$$ LANGUAGE plpgsql STABLE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION
+    h3_raster_class_summary_coverage(raster, integer, integer)
+IS 'Returns `h3_raster_class_summary_item` for each H3 cell and value for a given band. Computes the exact fraction of each pixel covered by each H3 cell, so `count` is a fractional number of pixels. Rasters not in EPSG:4326 are transformed first.';
+
 --@ availability: 4.1.1
 CREATE OR REPLACE FUNCTION h3_raster_class_summary(
     rast raster,
@@ -1129,3 +1313,87 @@ END;
 $$ LANGUAGE plpgsql IMMUTABLE STRICT PARALLEL SAFE;
 COMMENT ON FUNCTION h3_raster_class_summary(raster, integer, integer)
 IS 'Returns `h3_raster_class_summary_item` for each H3 cell and value for a given band. Attempts to select an appropriate method based on number of pixels per H3 cell.';
+
+--| ## Exporting to raster
+--|
+--| Per-cell values can be written into a raster aligned with a reference
+--| raster. Every pixel gets the value of the cell containing its center:
+--|
+--| ```
+--| SELECT h3_cells_to_raster(c.cells, c.vals, r.rast)
+--| FROM
+--|     (SELECT array_agg(h3) AS cells, array_agg(value) AS vals FROM cell_values) c,
+--|     reference r;
+--| ```
+
+-- Values of pixels of a raster with given size and georeference, see
+-- ST_SetValues.
+CREATE OR REPLACE FUNCTION __h3_cells_to_raster_values(
+    cells h3index[],
+    vals double precision[],
+    width integer,
+    height integer,
+    upperleftx double precision,
+    upperlefty double precision,
+    scalex double precision,
+    scaley double precision,
+    skewx double precision,
+    skewy double precision)
+RETURNS double precision[]
+AS 'h3_postgis', 'h3_cells_to_raster_values' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION h3_cells_to_raster(
+    cells h3index[],
+    vals double precision[],
+    reference raster)
+RETURNS raster
+AS $$
+DECLARE
+    self_schema CONSTANT text := (
+        SELECT extnamespace::regnamespace::text
+        FROM pg_catalog.pg_extension
+        WHERE extname = 'h3_postgis'
+    );
+    result @extschema:postgis_raster@.raster;
+BEGIN
+    IF @extschema:postgis_raster@.ST_SRID(reference) != 4326 THEN
+        RAISE EXCEPTION 'Reference raster must use SRID 4326';
+    END IF;
+
+    EXECUTE pg_catalog.format(
+        'SELECT @extschema:postgis_raster@.ST_SetValues(
+             @extschema:postgis_raster@.ST_AddBand(
+                 @extschema:postgis_raster@.ST_MakeEmptyRaster($3),
+                 ''64BF''::text,
+                 n.value,
+                 n.value
+             ),
+             1, 1, 1,
+             %1$I.__h3_cells_to_raster_values(
+                 $1,
+                 $2,
+                 m.width,
+                 m.height,
+                 m.upperleftx,
+                 m.upperlefty,
+                 m.scalex,
+                 m.scaley,
+                 m.skewx,
+                 m.skewy
+             )
+         )
+         FROM
+             @extschema:postgis_raster@.ST_MetaData($3) AS m,
+             @extschema:postgis_raster@.ST_MinPossibleValue(''64BF'') AS n(value)',
+        self_schema
+    )
+    INTO result
+    USING cells, vals, reference;
+
+    RETURN result;
+END;
+$$ LANGUAGE plpgsql IMMUTABLE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION
+    h3_cells_to_raster(h3index[], double precision[], raster)
+IS 'Creates a single band raster aligned with reference raster, setting each pixel to the value of the cell containing its center. Cells can be of different resolutions, the finest cell wins. Pixels not covered by any cell are set to NODATA. Reference raster must use SRID 4326.';
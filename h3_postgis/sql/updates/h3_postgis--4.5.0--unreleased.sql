@@ -17,3 +17,409 @@
 
 -- complain if script is sourced in psql, rather than via CREATE EXTENSION
 \echo Use "ALTER EXTENSION h3_postgis UPDATE TO 'unreleased'" to load this file. \quit
+
+-- Raster summary aggregates switch to internal C state with combine and
+-- serialization support, the SQL transition functions are no longer used.
+CREATE OR REPLACE FUNCTION __h3_raster_summary_stats_agg_transfn(
+    state internal,
+    stats h3_raster_summary_stats)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_summary_stats_agg_transfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_summary_stats_agg_combinefn(
+    state1 internal,
+    state2 internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_summary_stats_agg_combinefn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_summary_stats_agg_serialfn(state internal)
+RETURNS bytea
+AS 'h3_postgis', 'h3_raster_summary_stats_agg_serialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_summary_stats_agg_deserialfn(serialized bytea, state internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_summary_stats_agg_deserialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_summary_stats_agg_finalfn(state internal)
+RETURNS h3_raster_summary_stats
+AS 'h3_postgis', 'h3_raster_summary_stats_agg_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE AGGREGATE h3_raster_summary_stats_agg(h3_raster_summary_stats) (
+    sfunc = __h3_raster_summary_stats_agg_transfn,
+    stype = internal,
+    finalfunc = __h3_raster_summary_stats_agg_finalfn,
+    combinefunc = __h3_raster_summary_stats_agg_combinefn,
+    serialfunc = __h3_raster_summary_stats_agg_serialfn,
+    deserialfunc = __h3_raster_summary_stats_agg_deserialfn,
+    parallel = safe
+);
+
+DROP FUNCTION __h3_raster_summary_stats_agg_transfn(h3_raster_summary_stats, h3_raster_summary_stats);
+
+CREATE OR REPLACE FUNCTION __h3_raster_class_summary_item_agg_transfn(
+    state internal,
+    item h3_raster_class_summary_item)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_class_summary_item_agg_transfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_class_summary_item_agg_combinefn(
+    state1 internal,
+    state2 internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_class_summary_item_agg_combinefn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_class_summary_item_agg_serialfn(state internal)
+RETURNS bytea
+AS 'h3_postgis', 'h3_raster_class_summary_item_agg_serialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_class_summary_item_agg_deserialfn(serialized bytea, state internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_raster_class_summary_item_agg_deserialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_raster_class_summary_item_agg_finalfn(state internal)
+RETURNS h3_raster_class_summary_item
+AS 'h3_postgis', 'h3_raster_class_summary_item_agg_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE AGGREGATE h3_raster_class_summary_item_agg(h3_raster_class_summary_item) (
+    sfunc = __h3_raster_class_summary_item_agg_transfn,
+    stype = internal,
+    finalfunc = __h3_raster_class_summary_item_agg_finalfn,
+    combinefunc = __h3_raster_class_summary_item_agg_combinefn,
+    serialfunc = __h3_raster_class_summary_item_agg_serialfn,
+    deserialfunc = __h3_raster_class_summary_item_agg_deserialfn,
+    parallel = safe
+);
+
+DROP FUNCTION __h3_raster_class_summary_item_agg_transfn(h3_raster_class_summary_item, h3_raster_class_summary_item);
+
+-- Raster in EPSG:4326, coverage is computed in degrees
+CREATE OR REPLACE FUNCTION __h3_raster_to_4326(rast raster)
+RETURNS raster
+AS $$
+    SELECT CASE
+        WHEN @extschema:postgis_raster@.ST_SRID(rast) = 4326 THEN
+            rast
+        ELSE
+            @extschema:postgis_raster@.ST_Transform(rast, 4326)
+    END;
+$$ LANGUAGE SQL STABLE STRICT PARALLEL SAFE;
+
+-- Weighted stats for each H3 cell overlapping the raster given by its
+-- values (see ST_DumpValues) and georeference.
+CREATE OR REPLACE FUNCTION __h3_raster_coverage_summary(
+    vals double precision[],
+    upperleftx double precision,
+    upperlefty double precision,
+    scalex double precision,
+    scaley double precision,
+    skewx double precision,
+    skewy double precision,
+    resolution integer)
+RETURNS TABLE (
+    h3 h3index,
+    count double precision,
+    sum double precision,
+    mean double precision,
+    stddev double precision,
+    min double precision,
+    max double precision)
+AS 'h3_postgis', 'h3_raster_coverage_summary' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION h3_raster_summary_coverage(
+    rast raster,
+    resolution integer,
+    nband integer DEFAULT 1)
+RETURNS TABLE (h3 h3index, stats h3_raster_summary_stats)
+AS $$
+DECLARE
+    self_schema CONSTANT text := (
+        SELECT extnamespace::regnamespace::text
+        FROM pg_catalog.pg_extension
+        WHERE extname = 'h3_postgis'
+    );
+BEGIN
+    RETURN QUERY EXECUTE pg_catalog.format(
+        'SELECT
+             c.h3,
+             ROW(
+                 c.count,
+                 c.sum,
+                 c.mean,
+                 c.stddev,
+                 c.min,
+                 c.max
+             )::%1$I.h3_raster_summary_stats AS stats
+         FROM
+             %1$I.__h3_raster_to_4326($1) AS r,
+             @extschema:postgis_raster@.ST_MetaData(r) AS m,
+             %1$I.__h3_raster_coverage_summary(
+                 @extschema:postgis_raster@.ST_DumpValues(r, $3, TRUE),
+                 m.upperleftx,
+                 m.upperlefty,
+                 m.scalex,
+                 m.scaley,
+                 m.skewx,
+                 m.skewy,
+                 $2
+             ) AS c',
+        self_schema
+    )
+    USING rast, resolution, nband;
+END;
+$$ LANGUAGE plpgsql STABLE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION
+    h3_raster_summary_coverage(raster, integer, integer)
+IS 'Returns `h3_raster_summary_stats` for each H3 cell in raster for a given band. Computes the exact fraction of each pixel covered by each H3 cell and weights pixel values by it, so `count` is a fractional number of pixels. Rasters not in EPSG:4326 are transformed first.';
+
+-- Weighted pixel count for each H3 cell and value of the raster given by
+-- its values (see ST_DumpValues) and georeference.
+CREATE OR REPLACE FUNCTION __h3_raster_class_coverage_summary(
+    vals double precision[],
+    upperleftx double precision,
+    upperlefty double precision,
+    scalex double precision,
+    scaley double precision,
+    skewx double precision,
+    skewy double precision,
+    resolution integer)
+RETURNS TABLE (h3 h3index, val integer, count double precision)
+AS 'h3_postgis', 'h3_raster_class_coverage_summary' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION h3_raster_class_summary_coverage(
+    rast raster,
+    resolution integer,
+    nband integer DEFAULT 1)
+RETURNS TABLE (h3 h3index, val integer, summary h3_raster_class_summary_item)
+AS $$
+DECLARE
+    self_schema CONSTANT text := (
+        SELECT extnamespace::regnamespace::text
+        FROM pg_catalog.pg_extension
+        WHERE extname = 'h3_postgis'
+    );
+    rast4326 @extschema:postgis_raster@.raster;
+    poly @extschema:postgis@.geometry;
+    pixel_area double precision;
+BEGIN
+    -- coverage and pixel area both come from the transformed raster
+    EXECUTE pg_catalog.format(
+        'SELECT %1$I.__h3_raster_to_4326($1)',
+        self_schema
+    )
+    INTO rast4326
+    USING rast;
+
+    EXECUTE pg_catalog.format(
+        'SELECT %1$I.__h3_raster_to_polygon($1, $2)',
+        self_schema
+    )
+    INTO poly
+    USING rast4326, nband;
+
+    EXECUTE pg_catalog.format(
+        'SELECT %1$I.__h3_raster_polygon_pixel_area($1, $2)',
+        self_schema
+    )
+    INTO pixel_area
+    USING rast4326, poly;
+
+    RETURN QUERY EXECUTE pg_catalog.format(
+        'SELECT
+             c.h3,
+             c.val,
+             ROW(
+                 c.val,
+                 c.count,
+                 c.count * $4
+             )::%1$I.h3_raster_class_summary_item AS summary
+         FROM
+             @extschema:postgis_raster@.ST_MetaData($1) AS m,
+             %1$I.__h3_raster_class_coverage_summary(
+                 @extschema:postgis_raster@.ST_DumpValues($1, $3, TRUE),
+                 m.upperleftx,
+                 m.upperlefty,
+                 m.scalex,
+                 m.scaley,
+                 m.skewx,
+                 m.skewy,
+                 $2
+             ) AS c',
+        self_schema
+    )
+    USING rast4326, resolution, nband, pixel_area;
+END;
+$$ LANGUAGE plpgsql STABLE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION
+    h3_raster_class_summary_coverage(raster, integer, integer)
+IS 'Returns `h3_raster_class_summary_item` for each H3 cell and value for a given band. Computes the exact fraction of each pixel covered by each H3 cell, so `count` is a fractional number of pixels. Rasters not in EPSG:4326 are transformed first.';
+
+-- Values of pixels of a raster with given size and georeference, see
+-- ST_SetValues.
+CREATE OR REPLACE FUNCTION __h3_cells_to_raster_values(
+    cells h3index[],
+    vals double precision[],
+    width integer,
+    height integer,
+    upperleftx double precision,
+    upperlefty double precision,
+    scalex double precision,
+    scaley double precision,
+    skewx double precision,
+    skewy double precision)
+RETURNS double precision[]
+AS 'h3_postgis', 'h3_cells_to_raster_values' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION h3_cells_to_raster(
+    cells h3index[],
+    vals double precision[],
+    reference raster)
+RETURNS raster
+AS $$
+DECLARE
+    self_schema CONSTANT text := (
+        SELECT extnamespace::regnamespace::text
+        FROM pg_catalog.pg_extension
+        WHERE extname = 'h3_postgis'
+    );
+    result @extschema:postgis_raster@.raster;
+BEGIN
+    IF @extschema:postgis_raster@.ST_SRID(reference) != 4326 THEN
+        RAISE EXCEPTION 'Reference raster must use SRID 4326';
+    END IF;
+
+    EXECUTE pg_catalog.format(
+        'SELECT @extschema:postgis_raster@.ST_SetValues(
+             @extschema:postgis_raster@.ST_AddBand(
+                 @extschema:postgis_raster@.ST_MakeEmptyRaster($3),
+                 ''64BF''::text,
+                 n.value,
+                 n.value
+             ),
+             1, 1, 1,
+             %1$I.__h3_cells_to_raster_values(
+                 $1,
+                 $2,
+                 m.width,
+                 m.height,
+                 m.upperleftx,
+                 m.upperlefty,
+                 m.scalex,
+                 m.scaley,
+                 m.skewx,
+                 m.skewy
+             )
+         )
+         FROM
+             @extschema:postgis_raster@.ST_MetaData($3) AS m,
+             @extschema:postgis_raster@.ST_MinPossibleValue(''64BF'') AS n(value)',
+        self_schema
+    )
+    INTO result
+    USING cells, vals, reference;
+
+    RETURN result;
+END;
+$$ LANGUAGE plpgsql IMMUTABLE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION
+    h3_cells_to_raster(h3index[], double precision[], raster)
+IS 'Creates a single band raster aligned with reference raster, setting each pixel to the value of the cell containing its center. Cells can be of different resolutions, the finest cell wins. Pixels not covered by any cell are set to NODATA. Reference raster must use SRID 4326.';
+
+CREATE OR REPLACE FUNCTION
+    h3_cell_to_tile_wkb(cell h3index, z integer, x integer, y integer, extent integer DEFAULT 4096, buffer integer DEFAULT 256) RETURNS bytea
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cell_to_tile_wkb(h3index, integer, integer, integer, integer, integer)
+IS 'Finds the boundary of the index in Web Mercator XYZ tile coordinates, converts to WKB.
+
+Clips it to the tile extended by buffer and snaps it to integers, with Y pointing down, like ST_AsMVTGeom. Returns NULL if the cell misses the tile.
+
+Casting the result to geometry skips the overhead of h3_cell_to_tile_geometry, e.g. `SELECT ST_AsMVT(t) FROM (SELECT h3_cell_to_tile_wkb(h3, z, x, y)::geometry AS geom FROM cells) t`.';
+
+CREATE OR REPLACE FUNCTION h3_cell_to_tile_geometry(
+    cell h3index,
+    z integer,
+    x integer,
+    y integer,
+    extent integer DEFAULT 4096,
+    buffer integer DEFAULT 256
+) RETURNS @extschema:postgis@.geometry
+AS $$
+DECLARE
+    self_schema CONSTANT text := (
+        SELECT extnamespace::regnamespace::text
+        FROM pg_catalog.pg_extension
+        WHERE extname = 'h3_postgis'
+    );
+    wkb bytea;
+BEGIN
+    EXECUTE pg_catalog.format(
+        'SELECT %I.h3_cell_to_tile_wkb($1, $2, $3, $4, $5, $6)',
+        self_schema
+    )
+    INTO wkb
+    USING cell, z, x, y, extent, buffer;
+
+    RETURN wkb::@extschema:postgis@.geometry;
+END;
+$$ LANGUAGE plpgsql IMMUTABLE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION
+    h3_cell_to_tile_geometry(h3index, integer, integer, integer, integer, integer)
+IS 'Finds the boundary of the index in coordinates of the XYZ tile, ready for ST_AsMVT.
+
+Same as ST_AsMVTGeom(ST_Transform(h3_cell_to_boundary_geometry(cell), 3857), ST_TileEnvelope(z, x, y), extent, buffer), without going through PostGIS. Returns NULL if the cell misses the tile.';
+
+CREATE OR REPLACE FUNCTION
+    h3_cell_to_boundary_twkb(cell h3index, prec integer DEFAULT 6) RETURNS bytea
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cell_to_boundary_twkb(h3index, integer)
+IS 'Finds the boundary of the index, converts to TWKB with the given number of decimal digits, like ST_AsTWKB.
+
+Splits polygons when crossing 180th meridian. TWKB carries no SRID.';
+
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_twkb(h3index[], prec integer DEFAULT 6) RETURNS bytea
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cells_to_multi_polygon_twkb(h3index[], integer)
+IS 'Outline of a set of hexagons as h3_cells_to_multi_polygon_wkb, converted to TWKB with the given number of decimal digits, like ST_AsTWKB.
+
+TWKB carries no SRID.';
+
+--| # GeoJSON functions
+
+CREATE OR REPLACE FUNCTION __h3_cells_to_geojson_agg_transfn(
+    state internal,
+    cell h3index,
+    properties jsonb)
+RETURNS internal
+AS 'h3_postgis', 'h3_cells_to_geojson_agg_transfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_cells_to_geojson_agg_combinefn(
+    state1 internal,
+    state2 internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_cells_to_geojson_agg_combinefn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_cells_to_geojson_agg_serialfn(state internal)
+RETURNS bytea
+AS 'h3_postgis', 'h3_cells_to_geojson_agg_serialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_cells_to_geojson_agg_deserialfn(serialized bytea, state internal)
+RETURNS internal
+AS 'h3_postgis', 'h3_cells_to_geojson_agg_deserialfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION __h3_cells_to_geojson_agg_finalfn(state internal)
+RETURNS json
+AS 'h3_postgis', 'h3_cells_to_geojson_agg_finalfn' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE h3_cells_to_geojson_agg(cell h3index, properties jsonb) (
+    sfunc = __h3_cells_to_geojson_agg_transfn,
+    stype = internal,
+    finalfunc = __h3_cells_to_geojson_agg_finalfn,
+    combinefunc = __h3_cells_to_geojson_agg_combinefn,
+    serialfunc = __h3_cells_to_geojson_agg_serialfn,
+    deserialfunc = __h3_cells_to_geojson_agg_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_cells_to_geojson_agg(h3index, jsonb) IS
+'Builds a GeoJSON FeatureCollection with one feature per cell, with the cell as id and the given properties.
+
+Boundaries are split when crossing 180th meridian, like h3_cell_to_boundary_geometry, and written with 9 decimal digits, like ST_AsGeoJSON. NULL cells are skipped.';
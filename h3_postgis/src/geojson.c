@@ -0,0 +1,297 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <fmgr.h>				 // PG_FUNCTION_ARGS
+#include <lib/stringinfo.h>		 // StringInfo
+#include <utils/jsonb.h>		 // JsonbToCString
+#include <math.h>
+
+#include "error.h"
+#include "type.h"
+#include "wkb.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_geojson_agg_transfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_geojson_agg_combinefn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_geojson_agg_serialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_geojson_agg_deserialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_geojson_agg_finalfn);
+
+/* Decimal digits of coordinates, as the default of ST_AsGeoJSON */
+#define GEOJSON_DECIMAL_DIGITS 9
+#define GEOJSON_SCALE INT64CONST(1000000000)
+
+#define GEOJSON_COLLECTION_HEAD "{\"type\":\"FeatureCollection\",\"features\":["
+#define GEOJSON_COLLECTION_TAIL "]}"
+
+#define AGG_ASSERT_CONTEXT(fcinfo, aggcontext)				\
+	ASSERT(													\
+		AggCheckCallContext(fcinfo, aggcontext),			\
+		ERRCODE_FEATURE_NOT_SUPPORTED,						\
+		"Function called in non-aggregate context")
+
+static MemoryContext
+agg_context(FunctionCallInfo fcinfo)
+{
+	MemoryContext aggcontext;
+
+	AGG_ASSERT_CONTEXT(fcinfo, &aggcontext);
+	return aggcontext;
+}
+
+/*
+ * Appends a coordinate rounded to GEOJSON_DECIMAL_DIGITS, without trailing
+ * zeros. Formatting the scaled integer by hand avoids the printf machinery,
+ * which dominates the cost of a feature otherwise.
+ */
+static void
+geojson_append_coord(StringInfo buf, double value)
+{
+	char		digits[32];
+	char	   *end = digits + sizeof(digits);
+	char	   *start = end;
+	int64		scaled = llround(value * GEOJSON_SCALE);
+	uint64		magnitude = scaled < 0 ? -(uint64) scaled : (uint64) scaled;
+	uint64		whole = magnitude / GEOJSON_SCALE;
+	uint64		fraction = magnitude % GEOJSON_SCALE;
+
+	if (fraction != 0)
+	{
+		int			numDigits = GEOJSON_DECIMAL_DIGITS;
+
+		while (fraction % 10 == 0)
+		{
+			fraction /= 10;
+			numDigits--;
+		}
+		while (numDigits-- > 0)
+		{
+			*--start = '0' + fraction % 10;
+			fraction /= 10;
+		}
+		*--start = '.';
+	}
+	do
+	{
+		*--start = '0' + whole % 10;
+		whole /= 10;
+	} while (whole != 0);
+	if (scaled < 0)
+		*--start = '-';
+
+	appendBinaryStringInfo(buf, start, end - start);
+}
+
+/* Appends a closed ring of one boundary in degrees. */
+static void
+geojson_append_ring(StringInfo buf, const CellBoundary * boundary)
+{
+	const LatLng *verts = boundary->verts;
+	int			numVerts = boundary->numVerts;
+
+	if (numVerts > 1
+		&& verts[0].lat == verts[numVerts - 1].lat
+		&& verts[0].lng == verts[numVerts - 1].lng)
+		numVerts--;
+
+	appendStringInfoChar(buf, '[');
+	for (int i = 0; i <= numVerts; i++)
+	{
+		const LatLng *vert = &verts[i < numVerts ? i : 0];
+
+		if (i > 0)
+			appendStringInfoChar(buf, ',');
+		appendStringInfoChar(buf, '[');
+		geojson_append_coord(buf, vert->lng);
+		appendStringInfoChar(buf, ',');
+		geojson_append_coord(buf, vert->lat);
+		appendStringInfoChar(buf, ']');
+	}
+	appendStringInfoChar(buf, ']');
+}
+
+/* Appends one feature with the cell as id. */
+static void
+geojson_append_feature(StringInfo buf, H3Index cell, Jsonb *properties)
+{
+	CellBoundary parts[2];
+	int			num = cell_to_planar_boundaries(cell, parts);
+	char		id[17];
+
+	h3_assert(h3ToString(cell, id, sizeof(id)));
+
+	appendStringInfo(buf, "{\"type\":\"Feature\",\"id\":\"%s\",\"geometry\":{\"type\":", id);
+	if (num == 1)
+	{
+		appendStringInfoString(buf, "\"Polygon\",\"coordinates\":[");
+		geojson_append_ring(buf, &parts[0]);
+		appendStringInfoChar(buf, ']');
+	}
+	else
+	{
+		appendStringInfoString(buf, "\"MultiPolygon\",\"coordinates\":[");
+		for (int i = 0; i < num; i++)
+		{
+			if (i > 0)
+				appendStringInfoChar(buf, ',');
+			appendStringInfoChar(buf, '[');
+			geojson_append_ring(buf, &parts[i]);
+			appendStringInfoChar(buf, ']');
+		}
+		appendStringInfoChar(buf, ']');
+	}
+
+	appendStringInfoString(buf, "},\"properties\":");
+	if (properties == NULL)
+		appendStringInfoString(buf, "null");
+	else
+		JsonbToCString(buf, &properties->root, VARSIZE(properties));
+	appendStringInfoChar(buf, '}');
+}
+
+/*
+ * Transition function of h3_cells_to_geojson_agg.
+ *
+ * The state is the text of the features so far, separated by commas, which
+ * each cell is written into directly. NULL cells are skipped.
+ */
+Datum
+h3_cells_to_geojson_agg_transfn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext = agg_context(fcinfo);
+	StringInfo	state;
+
+	state = PG_ARGISNULL(0) ? NULL : (StringInfo) PG_GETARG_POINTER(0);
+
+	if (PG_ARGISNULL(1))
+	{
+		if (state == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state);
+	}
+
+	if (state == NULL)
+	{
+		MemoryContext oldcontext = MemoryContextSwitchTo(aggcontext);
+
+		state = makeStringInfo();
+		MemoryContextSwitchTo(oldcontext);
+	}
+	else
+		appendStringInfoChar(state, ',');
+
+	geojson_append_feature(state, PG_GETARG_H3INDEX(1),
+						   PG_ARGISNULL(2) ? NULL : PG_GETARG_JSONB_P(2));
+
+	PG_RETURN_POINTER(state);
+}
+
+/* Combine function of h3_cells_to_geojson_agg. */
+Datum
+h3_cells_to_geojson_agg_combinefn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext = agg_context(fcinfo);
+	StringInfo	state1;
+	StringInfo	state2;
+
+	state1 = PG_ARGISNULL(0) ? NULL : (StringInfo) PG_GETARG_POINTER(0);
+	state2 = PG_ARGISNULL(1) ? NULL : (StringInfo) PG_GETARG_POINTER(1);
+
+	if (state2 == NULL)
+	{
+		if (state1 == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state1);
+	}
+
+	if (state1 == NULL)
+	{
+		MemoryContext oldcontext = MemoryContextSwitchTo(aggcontext);
+
+		state1 = makeStringInfo();
+		MemoryContextSwitchTo(oldcontext);
+	}
+	else
+		appendStringInfoChar(state1, ',');
+
+	appendBinaryStringInfo(state1, state2->data, state2->len);
+	PG_RETURN_POINTER(state1);
+}
+
+/* Serialization function of h3_cells_to_geojson_agg. */
+Datum
+h3_cells_to_geojson_agg_serialfn(PG_FUNCTION_ARGS)
+{
+	StringInfo	state;
+	bytea	   *serialized;
+
+	agg_context(fcinfo);
+	state = (StringInfo) PG_GETARG_POINTER(0);
+
+	serialized = palloc(VARHDRSZ + state->len);
+	SET_VARSIZE(serialized, VARHDRSZ + state->len);
+	memcpy(VARDATA(serialized), state->data, state->len);
+
+	PG_RETURN_BYTEA_P(serialized);
+}
+
+/* Deserialization function of h3_cells_to_geojson_agg. */
+Datum
+h3_cells_to_geojson_agg_deserialfn(PG_FUNCTION_ARGS)
+{
+	bytea	   *serialized;
+	StringInfo	state;
+
+	agg_context(fcinfo);
+	serialized = PG_GETARG_BYTEA_PP(0);
+
+	state = makeStringInfo();
+	appendBinaryStringInfo(state, VARDATA_ANY(serialized),
+						   VARSIZE_ANY_EXHDR(serialized));
+
+	PG_RETURN_POINTER(state);
+}
+
+/* Final function of h3_cells_to_geojson_agg: wraps the features. */
+Datum
+h3_cells_to_geojson_agg_finalfn(PG_FUNCTION_ARGS)
+{
+	StringInfo	state;
+	text	   *result;
+	char	   *data;
+	int			len;
+
+	agg_context(fcinfo);
+	state = PG_ARGISNULL(0) ? NULL : (StringInfo) PG_GETARG_POINTER(0);
+	len = state == NULL ? 0 : state->len;
+
+	/* the state may be finalized again, so it is copied rather than extended */
+	result = palloc(VARHDRSZ + strlen(GEOJSON_COLLECTION_HEAD) + len
+					+ strlen(GEOJSON_COLLECTION_TAIL));
+	data = VARDATA(result);
+	memcpy(data, GEOJSON_COLLECTION_HEAD, strlen(GEOJSON_COLLECTION_HEAD));
+	data += strlen(GEOJSON_COLLECTION_HEAD);
+	if (len > 0)
+		memcpy(data, state->data, len);
+	data += len;
+	memcpy(data, GEOJSON_COLLECTION_TAIL, strlen(GEOJSON_COLLECTION_TAIL));
+	data += strlen(GEOJSON_COLLECTION_TAIL);
+	SET_VARSIZE(result, data - (char *) result);
+
+	PG_RETURN_TEXT_P(result);
+}
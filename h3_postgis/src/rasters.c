@@ -0,0 +1,1274 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <access/htup_details.h> // heap_form_tuple
+#include <catalog/pg_type.h>	 // FLOAT8OID
+#include <executor/executor.h>	 // GetAttributeByNum
+#include <fmgr.h>				 // PG_FUNCTION_ARGS
+#include <funcapi.h>			 // get_call_result_type
+#include <libpq/pqformat.h>		 // pq_sendfloat8
+#include <utils/array.h>		 // deconstruct_array
+#include <utils/hsearch.h>		 // hash_create
+#include <inttypes.h>
+#include <math.h>
+
+#include "error.h"
+#include "type.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_summary_stats_agg_transfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_summary_stats_agg_combinefn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_summary_stats_agg_serialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_summary_stats_agg_deserialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_summary_stats_agg_finalfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_class_summary_item_agg_transfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_class_summary_item_agg_combinefn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_class_summary_item_agg_serialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_class_summary_item_agg_deserialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_class_summary_item_agg_finalfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_coverage_summary);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_raster_class_coverage_summary);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_raster_values);
+
+/* Attribute numbers of h3_raster_summary_stats */
+#define SUMMARY_STATS_ATTR_COUNT 1
+#define SUMMARY_STATS_ATTR_SUM 2
+#define SUMMARY_STATS_ATTR_STDDEV 4
+#define SUMMARY_STATS_ATTR_MIN 5
+#define SUMMARY_STATS_ATTR_MAX 6
+#define SUMMARY_STATS_NATTS 6
+
+/* Attribute numbers of h3_raster_class_summary_item */
+#define CLASS_SUMMARY_ATTR_VAL 1
+#define CLASS_SUMMARY_ATTR_COUNT 2
+#define CLASS_SUMMARY_ATTR_AREA 3
+#define CLASS_SUMMARY_NATTS 3
+
+#define AGG_ASSERT_CONTEXT(fcinfo, aggcontext)				\
+	ASSERT(													\
+		AggCheckCallContext(fcinfo, aggcontext),			\
+		ERRCODE_FEATURE_NOT_SUPPORTED,						\
+		"Function called in non-aggregate context")
+
+/*
+ * Running summary statistics.
+ *
+ * Instead of the sum of squared values we keep the sum of squared
+ * differences from the mean (M2), which is merged using the pairwise update
+ * of Chan et al. This avoids the catastrophic cancellation of the naive
+ * "mean of squares minus square of mean" formula for large values with a
+ * small spread, and lets parallel workers combine partial states.
+ */
+typedef struct
+{
+	double		count;
+	double		sum;
+	double		m2;
+	double		min;
+	double		max;
+	bool		hasMinMax;
+}			SummaryStatsState;
+
+/* Running per-class summary, values of one class are simply added up. */
+typedef struct
+{
+	int32		val;
+	bool		valIsNull;
+	double		count;
+	double		area;
+}			ClassSummaryState;
+
+static MemoryContext
+agg_context(FunctionCallInfo fcinfo)
+{
+	MemoryContext aggcontext;
+
+	AGG_ASSERT_CONTEXT(fcinfo, &aggcontext);
+	return aggcontext;
+}
+
+static double
+attr_float8(HeapTupleHeader tuple, int attnum, bool *isnull)
+{
+	Datum		value = GetAttributeByNum(tuple, attnum, isnull);
+
+	return *isnull ? 0 : DatumGetFloat8(value);
+}
+
+/* Merges summary `b` into `a`. */
+static void
+summary_stats_merge(SummaryStatsState * a, const SummaryStatsState * b)
+{
+	double		count;
+	double		delta;
+
+	if (b->count <= 0)
+		return;
+
+	if (a->count <= 0)
+	{
+		*a = *b;
+		return;
+	}
+
+	count = a->count + b->count;
+	delta = b->sum / b->count - a->sum / a->count;
+
+	a->m2 += b->m2 + delta * delta * (a->count * b->count / count);
+	a->count = count;
+	a->sum += b->sum;
+
+	if (b->hasMinMax)
+	{
+		if (!a->hasMinMax)
+		{
+			a->min = b->min;
+			a->max = b->max;
+			a->hasMinMax = true;
+		}
+		else
+		{
+			a->min = fmin(a->min, b->min);
+			a->max = fmax(a->max, b->max);
+		}
+	}
+}
+
+/*
+ * Transition function of h3_raster_summary_stats_agg.
+ *
+ * Items without pixels are skipped.
+ */
+Datum
+h3_raster_summary_stats_agg_transfn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext = agg_context(fcinfo);
+	SummaryStatsState *state;
+	SummaryStatsState item;
+	HeapTupleHeader tuple;
+	double		stddev;
+	bool		isnull;
+	bool		minIsNull;
+	bool		maxIsNull;
+
+	state = PG_ARGISNULL(0) ? NULL : (SummaryStatsState *) PG_GETARG_POINTER(0);
+
+	if (PG_ARGISNULL(1))
+		goto done;
+
+	tuple = PG_GETARG_HEAPTUPLEHEADER(1);
+
+	item.count = attr_float8(tuple, SUMMARY_STATS_ATTR_COUNT, &isnull);
+	if (isnull || item.count <= 0)
+		goto done;
+
+	item.sum = attr_float8(tuple, SUMMARY_STATS_ATTR_SUM, &isnull);
+	if (isnull)
+		goto done;
+
+	/* single-pixel summaries may carry NULL deviation */
+	stddev = attr_float8(tuple, SUMMARY_STATS_ATTR_STDDEV, &isnull);
+	item.m2 = stddev * stddev * item.count;
+
+	item.min = attr_float8(tuple, SUMMARY_STATS_ATTR_MIN, &minIsNull);
+	item.max = attr_float8(tuple, SUMMARY_STATS_ATTR_MAX, &maxIsNull);
+	item.hasMinMax = !minIsNull && !maxIsNull;
+
+	if (state == NULL)
+		state = MemoryContextAllocZero(aggcontext, sizeof(SummaryStatsState));
+	summary_stats_merge(state, &item);
+
+done:
+	if (state == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(state);
+}
+
+/* Combine function of h3_raster_summary_stats_agg. */
+Datum
+h3_raster_summary_stats_agg_combinefn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext = agg_context(fcinfo);
+	SummaryStatsState *state1;
+	SummaryStatsState *state2;
+
+	state1 = PG_ARGISNULL(0) ? NULL : (SummaryStatsState *) PG_GETARG_POINTER(0);
+	state2 = PG_ARGISNULL(1) ? NULL : (SummaryStatsState *) PG_GETARG_POINTER(1);
+
+	if (state2 == NULL)
+	{
+		if (state1 == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state1);
+	}
+
+	if (state1 == NULL)
+	{
+		state1 = MemoryContextAlloc(aggcontext, sizeof(SummaryStatsState));
+		*state1 = *state2;
+		PG_RETURN_POINTER(state1);
+	}
+
+	summary_stats_merge(state1, state2);
+	PG_RETURN_POINTER(state1);
+}
+
+/* Serialization function of h3_raster_summary_stats_agg. */
+Datum
+h3_raster_summary_stats_agg_serialfn(PG_FUNCTION_ARGS)
+{
+	SummaryStatsState *state;
+	StringInfoData buf;
+
+	agg_context(fcinfo);
+	state = (SummaryStatsState *) PG_GETARG_POINTER(0);
+
+	pq_begintypsend(&buf);
+	pq_sendfloat8(&buf, state->count);
+	pq_sendfloat8(&buf, state->sum);
+	pq_sendfloat8(&buf, state->m2);
+	pq_sendfloat8(&buf, state->min);
+	pq_sendfloat8(&buf, state->max);
+	pq_sendbyte(&buf, state->hasMinMax);
+
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+/* Deserialization function of h3_raster_summary_stats_agg. */
+Datum
+h3_raster_summary_stats_agg_deserialfn(PG_FUNCTION_ARGS)
+{
+	bytea	   *serialized;
+	SummaryStatsState *state;
+	StringInfoData buf;
+
+	agg_context(fcinfo);
+	serialized = PG_GETARG_BYTEA_PP(0);
+
+	initStringInfo(&buf);
+	appendBinaryStringInfo(&buf, VARDATA_ANY(serialized),
+						   VARSIZE_ANY_EXHDR(serialized));
+
+	state = palloc(sizeof(SummaryStatsState));
+	state->count = pq_getmsgfloat8(&buf);
+	state->sum = pq_getmsgfloat8(&buf);
+	state->m2 = pq_getmsgfloat8(&buf);
+	state->min = pq_getmsgfloat8(&buf);
+	state->max = pq_getmsgfloat8(&buf);
+	state->hasMinMax = pq_getmsgbyte(&buf);
+	pq_getmsgend(&buf);
+
+	PG_RETURN_POINTER(state);
+}
+
+/* Final function of h3_raster_summary_stats_agg. */
+Datum
+h3_raster_summary_stats_agg_finalfn(PG_FUNCTION_ARGS)
+{
+	SummaryStatsState *state;
+	TupleDesc	tupdesc;
+	Datum		values[SUMMARY_STATS_NATTS];
+	bool		nulls[SUMMARY_STATS_NATTS] = {0};
+	HeapTuple	tuple;
+
+	agg_context(fcinfo);
+	state = (SummaryStatsState *) PG_GETARG_POINTER(0);
+
+	ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tupdesc));
+	tupdesc = BlessTupleDesc(tupdesc);
+
+	values[0] = Float8GetDatum(state->count);
+	values[1] = Float8GetDatum(state->sum);
+	values[2] = Float8GetDatum(state->sum / state->count);
+	values[3] = Float8GetDatum(sqrt(fmax(state->m2, 0) / state->count));
+	values[4] = Float8GetDatum(state->min);
+	values[5] = Float8GetDatum(state->max);
+	nulls[4] = !state->hasMinMax;
+	nulls[5] = !state->hasMinMax;
+
+	tuple = heap_form_tuple(tupdesc, values, nulls);
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+/* Transition function of h3_raster_class_summary_item_agg. */
+Datum
+h3_raster_class_summary_item_agg_transfn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext = agg_context(fcinfo);
+	ClassSummaryState *state;
+	HeapTupleHeader tuple;
+	Datum		val;
+	bool		valIsNull;
+	bool		isnull;
+
+	state = PG_ARGISNULL(0) ? NULL : (ClassSummaryState *) PG_GETARG_POINTER(0);
+
+	if (PG_ARGISNULL(1))
+		goto done;
+
+	tuple = PG_GETARG_HEAPTUPLEHEADER(1);
+
+	if (state == NULL)
+	{
+		/* class value is taken from the first item */
+		val = GetAttributeByNum(tuple, CLASS_SUMMARY_ATTR_VAL, &valIsNull);
+
+		state = MemoryContextAllocZero(aggcontext, sizeof(ClassSummaryState));
+		state->val = valIsNull ? 0 : DatumGetInt32(val);
+		state->valIsNull = valIsNull;
+	}
+
+	state->count += attr_float8(tuple, CLASS_SUMMARY_ATTR_COUNT, &isnull);
+	state->area += attr_float8(tuple, CLASS_SUMMARY_ATTR_AREA, &isnull);
+
+done:
+	if (state == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(state);
+}
+
+/* Combine function of h3_raster_class_summary_item_agg. */
+Datum
+h3_raster_class_summary_item_agg_combinefn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext = agg_context(fcinfo);
+	ClassSummaryState *state1;
+	ClassSummaryState *state2;
+
+	state1 = PG_ARGISNULL(0) ? NULL : (ClassSummaryState *) PG_GETARG_POINTER(0);
+	state2 = PG_ARGISNULL(1) ? NULL : (ClassSummaryState *) PG_GETARG_POINTER(1);
+
+	if (state2 == NULL)
+	{
+		if (state1 == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state1);
+	}
+
+	if (state1 == NULL)
+	{
+		state1 = MemoryContextAlloc(aggcontext, sizeof(ClassSummaryState));
+		*state1 = *state2;
+		PG_RETURN_POINTER(state1);
+	}
+
+	state1->count += state2->count;
+	state1->area += state2->area;
+	PG_RETURN_POINTER(state1);
+}
+
+/* Serialization function of h3_raster_class_summary_item_agg. */
+Datum
+h3_raster_class_summary_item_agg_serialfn(PG_FUNCTION_ARGS)
+{
+	ClassSummaryState *state;
+	StringInfoData buf;
+
+	agg_context(fcinfo);
+	state = (ClassSummaryState *) PG_GETARG_POINTER(0);
+
+	pq_begintypsend(&buf);
+	pq_sendint32(&buf, state->val);
+	pq_sendbyte(&buf, state->valIsNull);
+	pq_sendfloat8(&buf, state->count);
+	pq_sendfloat8(&buf, state->area);
+
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+/* Deserialization function of h3_raster_class_summary_item_agg. */
+Datum
+h3_raster_class_summary_item_agg_deserialfn(PG_FUNCTION_ARGS)
+{
+	bytea	   *serialized;
+	ClassSummaryState *state;
+	StringInfoData buf;
+
+	agg_context(fcinfo);
+	serialized = PG_GETARG_BYTEA_PP(0);
+
+	initStringInfo(&buf);
+	appendBinaryStringInfo(&buf, VARDATA_ANY(serialized),
+						   VARSIZE_ANY_EXHDR(serialized));
+
+	state = palloc(sizeof(ClassSummaryState));
+	state->val = pq_getmsgint(&buf, 4);
+	state->valIsNull = pq_getmsgbyte(&buf);
+	state->count = pq_getmsgfloat8(&buf);
+	state->area = pq_getmsgfloat8(&buf);
+	pq_getmsgend(&buf);
+
+	PG_RETURN_POINTER(state);
+}
+
+/* Final function of h3_raster_class_summary_item_agg. */
+Datum
+h3_raster_class_summary_item_agg_finalfn(PG_FUNCTION_ARGS)
+{
+	ClassSummaryState *state;
+	TupleDesc	tupdesc;
+	Datum		values[CLASS_SUMMARY_NATTS];
+	bool		nulls[CLASS_SUMMARY_NATTS] = {0};
+	HeapTuple	tuple;
+
+	agg_context(fcinfo);
+	state = (ClassSummaryState *) PG_GETARG_POINTER(0);
+
+	ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tupdesc));
+	tupdesc = BlessTupleDesc(tupdesc);
+
+	values[0] = Int32GetDatum(state->val);
+	values[1] = Float8GetDatum(state->count);
+	values[2] = Float8GetDatum(state->area);
+	nulls[0] = state->valIsNull;
+
+	tuple = heap_form_tuple(tupdesc, values, nulls);
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+/*
+ * Exact pixel coverage.
+ *
+ * Cell boundaries are mapped into raster pixel space, where every pixel is a
+ * unit square, and clipped against the pixel grid row by row and then column
+ * by column. The area of each clipped piece is the exact fraction of the
+ * pixel covered by the cell, which is used as the pixel weight. Like the
+ * clip-based summaries, boundaries are treated as straight lines in
+ * longitude/latitude.
+ */
+
+/* Maximum number of vertices in a clipped cell boundary */
+#define COVERAGE_MAX_VERTS (4 * MAX_CELL_BNDRY_VERTS)
+
+/* Pixel fractions below this are clipping noise along shared edges */
+#define COVERAGE_EPSILON 1e-9
+
+/* Maximum longitude span (in degrees) of one cell search polygon */
+#define COVERAGE_SEARCH_MAX_SPAN 90.0
+
+/* Maximum length (in degrees) of one cell search polygon edge */
+#define COVERAGE_SEARCH_MAX_EDGE 1.0
+
+#define COVERAGE_MAX_LAT 89.999999
+
+typedef struct
+{
+	double		x;
+	double		y;
+}			CoverageVertex;
+
+/* Affine georeference of a raster, see ST_GeoReference */
+typedef struct
+{
+	double		upperLeftX;
+	double		upperLeftY;
+	double		scaleX;
+	double		scaleY;
+	double		skewX;
+	double		skewY;
+	double		det;
+	int			width;
+	int			height;
+}			RasterGeoRef;
+
+/* Pixel values of a single band, NULL for nodata pixels */
+typedef struct
+{
+	RasterGeoRef geo;
+	Datum	   *values;
+	bool	   *nulls;
+}			RasterBand;
+
+typedef void (*CoverageCallback) (void *arg, const RasterBand * band,
+								  int row, int col, double weight);
+
+typedef struct
+{
+	H3Index		cell;
+	SummaryStatsState stats;
+}			CoverageSummary;
+
+typedef struct
+{
+	H3Index		cell;
+	int32		val;
+	double		count;
+}			CoverageClassSummary;
+
+/* Per-cell accumulator for class coverage */
+typedef struct
+{
+	CoverageClassSummary *items;
+	int			count;
+	int			capacity;
+}			CoverageClassList;
+
+typedef struct
+{
+	void	   *items;
+	int			count;
+}			CoverageResults;
+
+static void
+raster_pixel_to_world(const RasterGeoRef * geo, double col, double row,
+					  double *x, double *y)
+{
+	*x = geo->upperLeftX + col * geo->scaleX + row * geo->skewX;
+	*y = geo->upperLeftY + col * geo->skewY + row * geo->scaleY;
+}
+
+static void
+raster_world_to_pixel(const RasterGeoRef * geo, double x, double y,
+					  CoverageVertex * pixel)
+{
+	double		dx = x - geo->upperLeftX;
+	double		dy = y - geo->upperLeftY;
+
+	pixel->x = (dx * geo->scaleY - dy * geo->skewX) / geo->det;
+	pixel->y = (dy * geo->scaleX - dx * geo->skewY) / geo->det;
+}
+
+/*
+ * Clips polygon against an axis-aligned half-plane (Sutherland-Hodgman).
+ *
+ * Keeps the part where the x (or y) coordinate is above (or below) `value`.
+ * Returns number of vertices written to `out`.
+ */
+static int
+coverage_clip(const CoverageVertex * in, int n, CoverageVertex * out,
+			  bool alongX, double value, bool keepAbove)
+{
+	int			count = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		const CoverageVertex *a = &in[i];
+		const CoverageVertex *b = &in[(i + 1) % n];
+		double		da = (alongX ? a->x : a->y) - value;
+		double		db = (alongX ? b->x : b->y) - value;
+
+		if (!keepAbove)
+		{
+			da = -da;
+			db = -db;
+		}
+
+		ASSERT(
+			   count + 2 <= COVERAGE_MAX_VERTS,
+			   ERRCODE_EXTERNAL_ROUTINE_EXCEPTION,
+			   "Too many vertices in clipped cell boundary");
+
+		if (da >= 0)
+			out[count++] = *a;
+
+		if ((da >= 0) != (db >= 0))
+		{
+			double		t = da / (da - db);
+
+			out[count].x = a->x + t * (b->x - a->x);
+			out[count].y = a->y + t * (b->y - a->y);
+			count++;
+		}
+	}
+	return count;
+}
+
+static double
+coverage_area(const CoverageVertex * polygon, int n)
+{
+	double		area = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		const CoverageVertex *a = &polygon[i];
+		const CoverageVertex *b = &polygon[(i + 1) % n];
+
+		area += a->x * b->y - b->x * a->y;
+	}
+	return fabs(area) / 2;
+}
+
+/*
+ * Calls `callback` for every valid pixel covered by polygon (in pixel space)
+ * with the covered fraction of the pixel.
+ *
+ * The polygon is sliced into one-pixel-high strips, and each strip into
+ * one-pixel-wide pieces, so each clip works on a small convex part.
+ */
+static void
+polygon_pixel_coverage(const CoverageVertex * polygon, int n,
+					   const RasterBand * band,
+					   CoverageCallback callback, void *arg)
+{
+	const RasterGeoRef *geo = &band->geo;
+	CoverageVertex rows[COVERAGE_MAX_VERTS];
+	CoverageVertex strip[COVERAGE_MAX_VERTS];
+	CoverageVertex cols[COVERAGE_MAX_VERTS];
+	CoverageVertex piece[COVERAGE_MAX_VERTS];
+	CoverageVertex rest[COVERAGE_MAX_VERTS];
+	double		minX = polygon[0].x;
+	double		maxX = polygon[0].x;
+	double		minY = polygon[0].y;
+	double		maxY = polygon[0].y;
+	int			rowMin;
+	int			rowMax;
+	int			rowsN;
+
+	for (int i = 1; i < n; i++)
+	{
+		minX = fmin(minX, polygon[i].x);
+		maxX = fmax(maxX, polygon[i].x);
+		minY = fmin(minY, polygon[i].y);
+		maxY = fmax(maxY, polygon[i].y);
+	}
+
+	if (maxX <= 0 || minX >= geo->width || maxY <= 0 || minY >= geo->height)
+		return;
+
+	rowMin = Max(0, (int) floor(minY));
+	rowMax = Min(geo->height - 1, (int) ceil(maxY) - 1);
+
+	rowsN = coverage_clip(polygon, n, rows, false, rowMin, true);
+
+	for (int row = rowMin; row <= rowMax && rowsN >= 3; row++)
+	{
+		int			stripN;
+		int			colsN;
+		int			colMin;
+		int			colMax;
+
+		stripN = coverage_clip(rows, rowsN, strip, false, row + 1, false);
+		rowsN = coverage_clip(rows, rowsN, rest, false, row + 1, true);
+		memcpy(rows, rest, rowsN * sizeof(CoverageVertex));
+
+		if (stripN < 3)
+			continue;
+
+		minX = strip[0].x;
+		maxX = strip[0].x;
+		for (int i = 1; i < stripN; i++)
+		{
+			minX = fmin(minX, strip[i].x);
+			maxX = fmax(maxX, strip[i].x);
+		}
+
+		colMin = Max(0, (int) floor(minX));
+		colMax = Min(geo->width - 1, (int) ceil(maxX) - 1);
+
+		colsN = coverage_clip(strip, stripN, cols, true, colMin, true);
+
+		for (int col = colMin; col <= colMax && colsN >= 3; col++)
+		{
+			int			pieceN;
+			double		weight;
+
+			pieceN = coverage_clip(cols, colsN, piece, true, col + 1, false);
+			colsN = coverage_clip(cols, colsN, rest, true, col + 1, true);
+			memcpy(cols, rest, colsN * sizeof(CoverageVertex));
+
+			if (pieceN < 3)
+				continue;
+
+			weight = coverage_area(piece, pieceN);
+			if (weight > COVERAGE_EPSILON
+				&& !band->nulls[(int64) row * geo->width + col])
+				callback(arg, band, row, col, weight);
+		}
+	}
+}
+
+/*
+ * Calls `callback` for every valid pixel covered by the cell.
+ *
+ * Longitudes are unwrapped so that cells crossing the antimeridian stay
+ * contiguous, and the boundary is also tried one turn east and west so that
+ * rasters extending past +/-180 are covered. Boundaries of polar cells are
+ * closed along the pole.
+ */
+static void
+cell_pixel_coverage(H3Index cell, const RasterBand * band,
+					CoverageCallback callback, void *arg)
+{
+	CellBoundary boundary;
+	CoverageVertex polygon[MAX_CELL_BNDRY_VERTS + 3];
+	double		lngs[MAX_CELL_BNDRY_VERTS + 3];
+	double		lats[MAX_CELL_BNDRY_VERTS + 3];
+	int			numVerts;
+
+	h3_assert(cellToBoundary(cell, &boundary));
+	numVerts = boundary.numVerts;
+
+	for (int i = 0; i < numVerts; i++)
+	{
+		lats[i] = radsToDegs(boundary.verts[i].lat);
+		lngs[i] = radsToDegs(boundary.verts[i].lng);
+		if (i > 0)
+		{
+			if (lngs[i] - lngs[i - 1] > 180)
+				lngs[i] -= 360;
+			else if (lngs[i] - lngs[i - 1] < -180)
+				lngs[i] += 360;
+		}
+	}
+
+	/*
+	 * Cell around a pole: the closing edge completes a full turn, so close
+	 * the boundary one turn away from the first vertex and along the pole.
+	 */
+	if (fabs(lngs[numVerts - 1] - lngs[0]) > 180)
+	{
+		LatLng		center;
+		double		pole;
+		double		turnLng = lngs[0] + (lngs[numVerts - 1] > lngs[0] ? 360 : -360);
+
+		h3_assert(cellToLatLng(cell, &center));
+		pole = center.lat > 0 ? 90 : -90;
+
+		lats[numVerts] = lats[0];
+		lngs[numVerts] = turnLng;
+		lats[numVerts + 1] = pole;
+		lngs[numVerts + 1] = turnLng;
+		lats[numVerts + 2] = pole;
+		lngs[numVerts + 2] = lngs[0];
+		numVerts += 3;
+	}
+
+	for (int turn = -1; turn <= 1; turn++)
+	{
+		for (int i = 0; i < numVerts; i++)
+			raster_world_to_pixel(&band->geo, lngs[i] + turn * 360, lats[i],
+								  &polygon[i]);
+
+		polygon_pixel_coverage(polygon, numVerts, band, callback, arg);
+	}
+}
+
+static int
+coverage_cmp_cells(const void *a, const void *b)
+{
+	H3Index		x = *(const H3Index *) a;
+	H3Index		y = *(const H3Index *) b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Appends densified edge between two pixel space points (without its end)
+ * to `verts`, or just counts the vertices when `verts` is NULL.
+ */
+static int
+coverage_search_edge(const RasterGeoRef * geo, const CoverageVertex * from,
+					 const CoverageVertex * to, LatLng * verts)
+{
+	double		x1,
+				y1,
+				x2,
+				y2;
+	int			steps;
+
+	raster_pixel_to_world(geo, from->x, from->y, &x1, &y1);
+	raster_pixel_to_world(geo, to->x, to->y, &x2, &y2);
+
+	steps = Max(1, (int) ceil(fmax(fabs(x2 - x1), fabs(y2 - y1))
+							  / COVERAGE_SEARCH_MAX_EDGE));
+
+	for (int i = 0; verts && i < steps; i++)
+	{
+		double		x = x1 + (x2 - x1) * i / steps;
+		double		y = y1 + (y2 - y1) * i / steps;
+
+		verts[i].lat = degsToRads(fmax(-COVERAGE_MAX_LAT, fmin(COVERAGE_MAX_LAT, y)));
+		verts[i].lng = degsToRads(remainder(x, 360));
+	}
+	return steps;
+}
+
+/*
+ * Finds all cells overlapping the raster.
+ *
+ * The raster outline is padded by one pixel and split into parts narrow
+ * enough for H3 to interpret unambiguously. Edges are densified, since H3
+ * treats polygon edges as great circle arcs while raster edges follow
+ * meridians and parallels. Cells which end up not covering any pixel are
+ * skipped later.
+ */
+static H3Index *
+raster_cells(const RasterGeoRef * geo, int resolution, int64 *numCells)
+{
+	double		span = fabs(geo->scaleX) * geo->width + fabs(geo->skewX) * geo->height;
+	int			parts = Max(1, (int) ceil(span / COVERAGE_SEARCH_MAX_SPAN));
+	H3Index    *cells = NULL;
+	int64		count = 0;
+
+	for (int part = 0; part < parts; part++)
+	{
+		double		col1 = (double) geo->width * part / parts - 1;
+		double		col2 = (double) geo->width * (part + 1) / parts + 1;
+		CoverageVertex corners[4] = {
+			{col1, -1},
+			{col2, -1},
+			{col2, geo->height + 1},
+			{col1, geo->height + 1}
+		};
+		GeoPolygon	polygon = {0};
+		int			numVerts = 0;
+		int64		maxSize;
+		int64		last;
+
+		for (int i = 0; i < 4; i++)
+			numVerts += coverage_search_edge(geo, &corners[i], &corners[(i + 1) % 4], NULL);
+
+		polygon.geoloop.verts = palloc(numVerts * sizeof(LatLng));
+		for (int i = 0; i < 4; i++)
+			polygon.geoloop.numVerts += coverage_search_edge(
+															 geo, &corners[i], &corners[(i + 1) % 4],
+															 polygon.geoloop.verts + polygon.geoloop.numVerts);
+
+		h3_assert(maxPolygonToCellsSizeExperimental(&polygon, resolution, CONTAINMENT_OVERLAPPING, &maxSize));
+
+		cells = cells
+			? repalloc_huge(cells, (count + maxSize) * sizeof(H3Index))
+			: palloc_extended(maxSize * sizeof(H3Index), MCXT_ALLOC_HUGE);
+		memset(cells + count, 0, maxSize * sizeof(H3Index));
+
+		h3_assert(polygonToCellsExperimental(&polygon, resolution, CONTAINMENT_OVERLAPPING, maxSize, cells + count));
+
+		/* drop unused output slots */
+		last = count + maxSize;
+		for (int64 i = count; i < last; i++)
+		{
+			if (cells[i] != H3_NULL)
+				cells[count++] = cells[i];
+		}
+
+		pfree(polygon.geoloop.verts);
+	}
+
+	/* padded parts overlap */
+	if (count > 1)
+	{
+		int64		unique = 1;
+
+		qsort(cells, count, sizeof(H3Index), coverage_cmp_cells);
+		for (int64 i = 1; i < count; i++)
+		{
+			if (cells[i] != cells[unique - 1])
+				cells[unique++] = cells[i];
+		}
+		count = unique;
+	}
+
+	*numCells = count;
+	return cells;
+}
+
+/* Reads raster georeference and band values passed from SQL */
+static void
+raster_band_from_args(FunctionCallInfo fcinfo, RasterBand * band)
+{
+	ArrayType  *values = PG_GETARG_ARRAYTYPE_P(0);
+	RasterGeoRef *geo = &band->geo;
+	int			numValues;
+
+	ASSERT(
+		   ARR_NDIM(values) == 2,
+		   ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Raster values must be a two-dimensional array");
+
+	geo->height = ARR_DIMS(values)[0];
+	geo->width = ARR_DIMS(values)[1];
+	geo->upperLeftX = PG_GETARG_FLOAT8(1);
+	geo->upperLeftY = PG_GETARG_FLOAT8(2);
+	geo->scaleX = PG_GETARG_FLOAT8(3);
+	geo->scaleY = PG_GETARG_FLOAT8(4);
+	geo->skewX = PG_GETARG_FLOAT8(5);
+	geo->skewY = PG_GETARG_FLOAT8(6);
+	geo->det = geo->scaleX * geo->scaleY - geo->skewX * geo->skewY;
+
+	ASSERT(
+		   geo->det != 0,
+		   ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Raster georeference is not invertible");
+
+	deconstruct_array(values, FLOAT8OID, sizeof(float8), FLOAT8PASSBYVAL,
+					  TYPALIGN_DOUBLE, &band->values, &band->nulls, &numValues);
+}
+
+static double
+raster_band_value(const RasterBand * band, int row, int col)
+{
+	return DatumGetFloat8(band->values[(int64) row * band->geo.width + col]);
+}
+
+static void
+coverage_summary_callback(void *arg, const RasterBand * band,
+						  int row, int col, double weight)
+{
+	double		value = raster_band_value(band, row, col);
+	SummaryStatsState item = {
+		.count = weight,
+		.sum = weight * value,
+		.m2 = 0,
+		.min = value,
+		.max = value,
+		.hasMinMax = true
+	};
+
+	summary_stats_merge((SummaryStatsState *) arg, &item);
+}
+
+static void
+coverage_class_callback(void *arg, const RasterBand * band,
+						int row, int col, double weight)
+{
+	CoverageClassList *list = (CoverageClassList *) arg;
+	int32		val = (int32) rint(raster_band_value(band, row, col));
+
+	for (int i = 0; i < list->count; i++)
+	{
+		if (list->items[i].val == val)
+		{
+			list->items[i].count += weight;
+			return;
+		}
+	}
+
+	if (list->count == list->capacity)
+	{
+		list->capacity *= 2;
+		list->items = repalloc(list->items, list->capacity * sizeof(CoverageClassSummary));
+	}
+
+	list->items[list->count].val = val;
+	list->items[list->count].count = weight;
+	list->count++;
+}
+
+/*
+ * Summary stats of raster band values for each H3 cell, weighting every
+ * pixel by the fraction of it covered by the cell.
+ *
+ * Arguments are band values as returned by ST_DumpValues, followed by the
+ * raster georeference (in degrees) and the resolution.
+ */
+Datum
+h3_raster_coverage_summary(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	CoverageResults *results;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		TupleDesc	tuple_desc;
+		RasterBand	band;
+		H3Index    *cells;
+		int64		numCells;
+		CoverageSummary *items;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		raster_band_from_args(fcinfo, &band);
+		cells = raster_cells(&band.geo, PG_GETARG_INT32(7), &numCells);
+
+		results = palloc0(sizeof(CoverageResults));
+		items = palloc_extended(Max(numCells, 1) * sizeof(CoverageSummary), MCXT_ALLOC_HUGE);
+
+		for (int64 i = 0; i < numCells; i++)
+		{
+			CoverageSummary *item = &items[results->count];
+
+			memset(item, 0, sizeof(CoverageSummary));
+			item->cell = cells[i];
+			cell_pixel_coverage(cells[i], &band, coverage_summary_callback, &item->stats);
+
+			if (item->stats.count > 0)
+				results->count++;
+		}
+		results->items = items;
+
+		ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
+
+		funcctx->tuple_desc = BlessTupleDesc(tuple_desc);
+		funcctx->user_fctx = results;
+		funcctx->max_calls = results->count;
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	results = (CoverageResults *) funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		CoverageSummary *item = &((CoverageSummary *) results->items)[funcctx->call_cntr];
+		SummaryStatsState *stats = &item->stats;
+		Datum		values[SUMMARY_STATS_NATTS + 1];
+		bool		nulls[SUMMARY_STATS_NATTS + 1] = {0};
+		HeapTuple	tuple;
+
+		values[0] = H3IndexGetDatum(item->cell);
+		values[1] = Float8GetDatum(stats->count);
+		values[2] = Float8GetDatum(stats->sum);
+		values[3] = Float8GetDatum(stats->sum / stats->count);
+		values[4] = Float8GetDatum(sqrt(fmax(stats->m2, 0) / stats->count));
+		values[5] = Float8GetDatum(stats->min);
+		values[6] = Float8GetDatum(stats->max);
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
+
+/*
+ * Covered pixel count of each raster band value for each H3 cell, weighting
+ * every pixel by the fraction of it covered by the cell.
+ *
+ * Takes the same arguments as h3_raster_coverage_summary.
+ */
+Datum
+h3_raster_class_coverage_summary(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	CoverageResults *results;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		TupleDesc	tuple_desc;
+		RasterBand	band;
+		H3Index    *cells;
+		int64		numCells;
+		CoverageClassList list;
+		CoverageClassList all;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		raster_band_from_args(fcinfo, &band);
+		cells = raster_cells(&band.geo, PG_GETARG_INT32(7), &numCells);
+
+		list.capacity = 8;
+		list.items = palloc(list.capacity * sizeof(CoverageClassSummary));
+
+		all.count = 0;
+		all.capacity = Max(numCells, 8);
+		all.items = palloc_extended(all.capacity * sizeof(CoverageClassSummary), MCXT_ALLOC_HUGE);
+
+		for (int64 i = 0; i < numCells; i++)
+		{
+			list.count = 0;
+			cell_pixel_coverage(cells[i], &band, coverage_class_callback, &list);
+
+			if (all.count + list.count > all.capacity)
+			{
+				all.capacity = Max(all.capacity * 2, all.count + list.count);
+				all.items = repalloc_huge(all.items, all.capacity * sizeof(CoverageClassSummary));
+			}
+
+			for (int j = 0; j < list.count; j++)
+			{
+				all.items[all.count] = list.items[j];
+				all.items[all.count].cell = cells[i];
+				all.count++;
+			}
+		}
+
+		results = palloc(sizeof(CoverageResults));
+		results->items = all.items;
+		results->count = all.count;
+
+		ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
+
+		funcctx->tuple_desc = BlessTupleDesc(tuple_desc);
+		funcctx->user_fctx = results;
+		funcctx->max_calls = results->count;
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	results = (CoverageResults *) funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		CoverageClassSummary *item = &((CoverageClassSummary *) results->items)[funcctx->call_cntr];
+		Datum		values[3];
+		bool		nulls[3] = {0};
+		HeapTuple	tuple;
+
+		values[0] = H3IndexGetDatum(item->cell);
+		values[1] = Int32GetDatum(item->val);
+		values[2] = Float8GetDatum(item->count);
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
+
+/* Finest H3 resolution */
+#define RASTER_MAX_H3_RES 15
+
+typedef struct
+{
+	H3Index		cell;
+	double		value;
+}			CellValueEntry;
+
+/*
+ * Pixel values of a raster band with the given georeference (in degrees)
+ * from per-cell values.
+ *
+ * Each pixel gets the value of the cell containing its center. Cells may be
+ * of different resolutions (e.g. a compacted set), in which case the finest
+ * cell containing the pixel center wins. Pixels not covered by any cell are
+ * NULL. Returns a two-dimensional array suitable for ST_SetValues.
+ */
+Datum
+h3_cells_to_raster_values(PG_FUNCTION_ARGS)
+{
+	ArrayType  *cellsArray = PG_GETARG_ARRAYTYPE_P(0);
+	ArrayType  *valuesArray = PG_GETARG_ARRAYTYPE_P(1);
+	RasterGeoRef geo;
+	Datum	   *cells;
+	bool	   *cellNulls;
+	Datum	   *values;
+	bool	   *valueNulls;
+	int			numCells;
+	int			numValues;
+	HASHCTL		ctl = {0};
+	HTAB	   *table;
+	bool		resolutions[RASTER_MAX_H3_RES + 1] = {0};
+	int			finestRes = -1;
+	int64		numPixels;
+	Datum	   *pixels;
+	bool	   *pixelNulls;
+	int			dims[2];
+	int			lbs[2] = {1, 1};
+
+	geo.width = PG_GETARG_INT32(2);
+	geo.height = PG_GETARG_INT32(3);
+	geo.upperLeftX = PG_GETARG_FLOAT8(4);
+	geo.upperLeftY = PG_GETARG_FLOAT8(5);
+	geo.scaleX = PG_GETARG_FLOAT8(6);
+	geo.scaleY = PG_GETARG_FLOAT8(7);
+	geo.skewX = PG_GETARG_FLOAT8(8);
+	geo.skewY = PG_GETARG_FLOAT8(9);
+
+	ASSERT(
+		   geo.width > 0 && geo.height > 0,
+		   ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Raster must not be empty");
+
+	/* h3index is stored like int8 */
+	deconstruct_array(cellsArray, ARR_ELEMTYPE(cellsArray), sizeof(H3Index),
+					  FLOAT8PASSBYVAL, TYPALIGN_DOUBLE,
+					  &cells, &cellNulls, &numCells);
+	deconstruct_array(valuesArray, FLOAT8OID, sizeof(float8), FLOAT8PASSBYVAL,
+					  TYPALIGN_DOUBLE, &values, &valueNulls, &numValues);
+
+	ASSERT(
+		   numCells == numValues,
+		   ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Cells and values arrays must have the same length");
+
+	ctl.keysize = sizeof(H3Index);
+	ctl.entrysize = sizeof(CellValueEntry);
+	ctl.hcxt = CurrentMemoryContext;
+	table = hash_create("h3_cells_to_raster", Max(numCells, 1), &ctl,
+						HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	/* later duplicates overwrite earlier ones */
+	for (int i = 0; i < numCells; i++)
+	{
+		H3Index		cell;
+		CellValueEntry *entry;
+		int			res;
+
+		if (cellNulls[i] || valueNulls[i])
+			continue;
+
+		cell = DatumGetH3Index(cells[i]);
+		ASSERT(
+			   isValidCell(cell),
+			   ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Invalid H3 cell: %" PRIx64, (uint64) cell);
+
+		entry = hash_search(table, &cell, HASH_ENTER, NULL);
+		entry->value = DatumGetFloat8(values[i]);
+
+		res = getResolution(cell);
+		resolutions[res] = true;
+		finestRes = Max(finestRes, res);
+	}
+
+	numPixels = (int64) geo.width * geo.height;
+	pixels = palloc_extended(numPixels * sizeof(Datum), MCXT_ALLOC_HUGE);
+	pixelNulls = palloc_extended(numPixels * sizeof(bool), MCXT_ALLOC_HUGE);
+	memset(pixelNulls, true, numPixels * sizeof(bool));
+
+	for (int row = 0; finestRes >= 0 && row < geo.height; row++)
+	{
+		for (int col = 0; col < geo.width; col++)
+		{
+			int64		pixel = (int64) row * geo.width + col;
+			LatLng		center;
+			double		x;
+			double		y;
+			H3Index		cell;
+
+			raster_pixel_to_world(&geo, col + 0.5, row + 0.5, &x, &y);
+			if (!isfinite(x) || !isfinite(y) || fabs(y) > 90)
+				continue;
+
+			center.lat = degsToRads(y);
+			center.lng = degsToRads(x);
+			if (latLngToCell(&center, finestRes, &cell) != E_SUCCESS)
+				continue;
+
+			for (int res = finestRes; res >= 0; res--)
+			{
+				CellValueEntry *entry;
+
+				if (!resolutions[res])
+					continue;
+				if (res < finestRes)
+					h3_assert(cellToParent(cell, res, &cell));
+
+				entry = hash_search(table, &cell, HASH_FIND, NULL);
+				if (entry)
+				{
+					pixels[pixel] = Float8GetDatum(entry->value);
+					pixelNulls[pixel] = false;
+					break;
+				}
+			}
+		}
+	}
+
+	hash_destroy(table);
+
+	dims[0] = geo.height;
+	dims[1] = geo.width;
+	PG_RETURN_ARRAYTYPE_P(construct_md_array(pixels, pixelNulls, 2, dims, lbs,
+											 FLOAT8OID, sizeof(float8),
+											 FLOAT8PASSBYVAL, TYPALIGN_DOUBLE));
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <math.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -35,6 +36,26 @@
 
 #define WKB_SRID_DEFAULT 4326
 
+#define TWKB_EMPTY_FLAG 0x10
+
+/* Longest varint of a 64-bit value */
+#define TWKB_VARINT_MAX_SIZE 10
+
+/* Leading points of a ring written even when repeated, as in ST_AsTWKB */
+#define TWKB_RING_MIN_POINTS 4
+
+/*
+ * TWKB output state: coordinates are scaled by 10^precision, rounded, and
+ * written as zigzag varint deltas from the previous point of the geometry.
+ */
+typedef struct
+{
+	uint8	   *data;
+	double		scale;
+	int64		x;
+	int64		y;
+}			TwkbWriter;
+
 #define ASSERT_WKB_DATA_WRITTEN(wkb, data) \
 	ASSERT( \
 		(uint8 *)wkb + VARSIZE(wkb) == data, \
@@ -55,10 +76,7 @@ static size_t
 			boundary_data_size(const CellBoundary * boundary);
 
 static size_t
-			linked_geo_polygon_data_size(const LinkedGeoPolygon * multiPolygon);
-
-static size_t
-			linked_geo_loop_data_size(const LinkedGeoLoop * loop);
+			flat_multi_polygon_data_size(const FlatMultiPolygon * multiPolygon);
 
 static uint8 *
 			wkb_write_boundary_array_data(uint8 *data, const CellBoundary * boundaries, int num);
@@ -67,17 +85,32 @@ static uint8 *
 			wkb_write_boundary_data(uint8 *data, const CellBoundary * boundary);
 
 static uint8 *
-			wkb_write_linked_geo_polygon_data(uint8 *data, const LinkedGeoPolygon * multiPolygon);
+			wkb_write_flat_multi_polygon_data(uint8 *data, const FlatMultiPolygon * multiPolygon);
 
 static uint8 *
 			wkb_write_lat_lng_array(uint8 *data, const LatLng * coord, int num);
 
-static uint8 *
-			wkb_write_linked_geo_loop_data(uint8 *data, const LinkedGeoLoop * loop);
-
 static uint8 *
 			wkb_write_lat_lng(uint8 *data, const LatLng * coord);
 
+static bytea *
+			twkb_begin(TwkbWriter * writer, int precision, size_t numParts, size_t numCoords);
+
+static bytea *
+			twkb_end(bytea *twkb, const TwkbWriter * writer);
+
+static void
+			twkb_write_header(TwkbWriter * writer, int type, int precision, bool empty);
+
+static void
+			twkb_write_ring(TwkbWriter * writer, const LatLng * coords, int num);
+
+static void
+			twkb_write_varint(TwkbWriter * writer, uint64 value);
+
+static void
+			twkb_write_signed(TwkbWriter * writer, int64 value);
+
 static uint8 *
 			wkb_write_endian(uint8 *data);
 
@@ -122,22 +155,224 @@ boundary_to_wkb(const CellBoundary * boundary)
 }
 
 bytea *
-linked_geo_polygon_to_wkb(const LinkedGeoPolygon * multiPolygon)
+tile_ring_to_wkb(const LatLng * coords, int num)
 {
 	bytea	   *wkb;
 	uint8	   *data;
-	size_t		size = linked_geo_polygon_data_size(multiPolygon);
+
+	/* byte order + type + # of rings + # of points, point data */
+	size_t		size = WKB_BYTE_SIZE + WKB_INT_SIZE * 3 + (num + 1) * WKB_DOUBLE_SIZE * 2;
 
 	wkb = palloc(VARHDRSZ + size);
 	SET_VARSIZE(wkb, VARHDRSZ + size);
 
 	data = (uint8 *) VARDATA(wkb);
-	data = wkb_write_linked_geo_polygon_data(data, multiPolygon);
+	data = wkb_write_endian(data);
+	data = wkb_write_int(data, WKB_POLYGON_TYPE);
+	data = wkb_write_int(data, 1);
+	data = wkb_write_int(data, num + 1);
+	data = wkb_write_lat_lng_array(data, coords, num);
+	data = wkb_write_lat_lng(data, &coords[0]);
 
 	ASSERT_WKB_DATA_WRITTEN(wkb, data);
 	return wkb;
 }
 
+FlatMultiPolygon *
+flat_multi_polygon_from_linked(const LinkedGeoPolygon * multiPolygon)
+{
+	FlatMultiPolygon *flat;
+	int			numPolygons = 0;
+	int			numRings = 0;
+	int			numCoords = 0;
+	int			ring = 0;
+	int			coord = 0;
+	char	   *ptr;
+
+	FOREACH_LINKED_POLYGON(multiPolygon, polygon)
+	{
+		numPolygons++;
+		FOREACH_LINKED_LOOP(polygon, loop)
+		{
+			numRings++;
+			numCoords += count_linked_lat_lng(loop);
+		}
+	}
+
+	ptr = palloc(MAXALIGN(sizeof(FlatMultiPolygon))
+				 + MAXALIGN(sizeof(int) * (numPolygons + 1))
+				 + MAXALIGN(sizeof(int) * (numRings + 1))
+				 + sizeof(LatLng) * numCoords);
+	flat = (FlatMultiPolygon *) ptr;
+	ptr += MAXALIGN(sizeof(FlatMultiPolygon));
+	flat->polygonRings = (int *) ptr;
+	ptr += MAXALIGN(sizeof(int) * (numPolygons + 1));
+	flat->ringCoords = (int *) ptr;
+	ptr += MAXALIGN(sizeof(int) * (numRings + 1));
+	flat->coords = (LatLng *) ptr;
+	flat->numPolygons = numPolygons;
+	flat->numRings = numRings;
+
+	numPolygons = 0;
+	FOREACH_LINKED_POLYGON(multiPolygon, polygon)
+	{
+		flat->polygonRings[numPolygons++] = ring;
+		FOREACH_LINKED_LOOP(polygon, loop)
+		{
+			flat->ringCoords[ring++] = coord;
+			FOREACH_LINKED_LAT_LNG(loop, latlng)
+				flat->coords[coord++] = latlng->vertex;
+		}
+	}
+	flat->polygonRings[numPolygons] = ring;
+	flat->ringCoords[ring] = coord;
+
+	return flat;
+}
+
+void
+flat_multi_polygon_to_degs(FlatMultiPolygon * multiPolygon)
+{
+	LatLng	   *coords = multiPolygon->coords;
+	int			numCoords = multiPolygon->ringCoords[multiPolygon->numRings];
+
+	for (int i = 0; i < numCoords; i++)
+	{
+		coords[i].lat = radsToDegs(coords[i].lat);
+		coords[i].lng = radsToDegs(coords[i].lng);
+	}
+}
+
+bytea *
+flat_multi_polygon_to_wkb(const FlatMultiPolygon * multiPolygon)
+{
+	bytea	   *wkb;
+	uint8	   *data;
+	size_t		size = flat_multi_polygon_data_size(multiPolygon);
+
+	wkb = palloc(VARHDRSZ + size);
+	SET_VARSIZE(wkb, VARHDRSZ + size);
+
+	data = (uint8 *) VARDATA(wkb);
+	data = wkb_write_flat_multi_polygon_data(data, multiPolygon);
+
+	ASSERT_WKB_DATA_WRITTEN(wkb, data);
+	return wkb;
+}
+
+FlatMultiPolygon *
+flat_multi_polygon_from_boundary(const CellBoundary * boundary)
+{
+	FlatMultiPolygon *flat = palloc(sizeof(FlatMultiPolygon)
+									+ sizeof(int) * 4
+									+ sizeof(LatLng) * MAX_CELL_BNDRY_VERTS);
+	int			numVerts = boundary->numVerts;
+
+	if (!boundary_is_empty(boundary) && boundary_is_closed(boundary))
+		numVerts--;
+
+	flat->polygonRings = (int *) (flat + 1);
+	flat->ringCoords = flat->polygonRings + 2;
+	flat->coords = (LatLng *) (flat->ringCoords + 2);
+	flat->numPolygons = 1;
+	flat->numRings = boundary_is_empty(boundary) ? 0 : 1;
+	flat->polygonRings[0] = 0;
+	flat->polygonRings[1] = flat->numRings;
+	flat->ringCoords[0] = 0;
+	flat->ringCoords[flat->numRings] = numVerts;
+	memcpy(flat->coords, boundary->verts, sizeof(LatLng) * numVerts);
+
+	return flat;
+}
+
+bytea *
+boundary_array_to_twkb(const CellBoundary * boundaries, int num, int precision)
+{
+	TwkbWriter	writer;
+	bytea	   *twkb;
+	size_t		numCoords = 0;
+	int			isMulti = (num > 1);
+
+	for (int i = 0; i < num; i++)
+		numCoords += boundaries[i].numVerts + 1;
+
+	twkb = twkb_begin(&writer, precision, 2 * num + 1, numCoords);
+
+	if (!isMulti)
+	{
+		twkb_write_header(&writer, WKB_POLYGON_TYPE, precision,
+						  boundary_is_empty(&boundaries[0]));
+		if (boundary_is_empty(&boundaries[0]))
+			return twkb_end(twkb, &writer);
+	}
+	else
+	{
+		twkb_write_header(&writer, WKB_MULTIPOLYGON_TYPE, precision, false);
+		/* # of polygons */
+		twkb_write_varint(&writer, num);
+	}
+
+	for (int i = 0; i < num; i++)
+	{
+		const CellBoundary *boundary = &boundaries[i];
+		int			numVerts = boundary->numVerts;
+
+		/* # of rings */
+		twkb_write_varint(&writer, boundary_is_empty(boundary) ? 0 : 1);
+		if (boundary_is_empty(boundary))
+			continue;
+
+		if (boundary_is_closed(boundary))
+			numVerts--;
+		twkb_write_ring(&writer, boundary->verts, numVerts);
+	}
+
+	return twkb_end(twkb, &writer);
+}
+
+bytea *
+flat_multi_polygon_to_twkb(const FlatMultiPolygon * multiPolygon, int precision)
+{
+	TwkbWriter	writer;
+	bytea	   *twkb;
+	int			numPolygons = multiPolygon->numPolygons;
+	int			numRings = multiPolygon->numRings;
+	int			isMulti = (numPolygons > 1);
+
+	twkb = twkb_begin(&writer, precision, 1 + numPolygons + numRings,
+					  multiPolygon->ringCoords[numRings] + numRings);
+
+	twkb_write_header(&writer, isMulti ? WKB_MULTIPOLYGON_TYPE : WKB_POLYGON_TYPE,
+					  precision, numRings == 0);
+	if (numRings == 0)
+		return twkb_end(twkb, &writer);
+
+	if (isMulti)
+	{
+		/* # of polygons */
+		twkb_write_varint(&writer, numPolygons);
+	}
+
+	for (int i = 0; i < numPolygons; i++)
+	{
+		int			firstRing = multiPolygon->polygonRings[i];
+		int			endRing = multiPolygon->polygonRings[i + 1];
+
+		/* # of rings */
+		twkb_write_varint(&writer, endRing - firstRing);
+
+		for (int j = firstRing; j < endRing; j++)
+		{
+			int			firstCoord = multiPolygon->ringCoords[j];
+
+			twkb_write_ring(&writer, &multiPolygon->coords[firstCoord],
+							multiPolygon->ringCoords[j + 1] - firstCoord);
+		}
+	}
+
+	return twkb_end(twkb, &writer);
+}
+
 bool
 boundary_is_empty(const CellBoundary * boundary)
 {
@@ -191,48 +426,24 @@ boundary_data_size(const CellBoundary * boundary)
 }
 
 size_t
-linked_geo_polygon_data_size(const LinkedGeoPolygon * multiPolygon)
+flat_multi_polygon_data_size(const FlatMultiPolygon * multiPolygon)
 {
-	size_t		size = 0;
-	int			isMulti = (multiPolygon->next != NULL);
+	int			numPolygons = multiPolygon->numPolygons;
+	int			numRings = multiPolygon->numRings;
+	int			numCoords = multiPolygon->ringCoords[numRings];
 
 	/* byte order + type + srid */
-	size = WKB_BYTE_SIZE + WKB_INT_SIZE * 2;
+	size_t		size = WKB_BYTE_SIZE + WKB_INT_SIZE * 2;
 
-	if (isMulti)
-	{
-		/* # of polygons */
-		size += WKB_INT_SIZE;
-	}
-
-	FOREACH_LINKED_POLYGON(multiPolygon, polygon)
+	if (numPolygons > 1)
 	{
-		if (isMulti)
-		{
-			/* byte order + type + srid  */
-			size += WKB_BYTE_SIZE + WKB_INT_SIZE * 2;
-		}
-
-		/* # of rings */
-		size += WKB_INT_SIZE;
-
-		FOREACH_LINKED_LOOP(polygon, loop)
-		{
-			size += linked_geo_loop_data_size(loop);
-		}
+		/* # of polygons, byte order + type + srid of each */
+		size += WKB_INT_SIZE + numPolygons * (WKB_BYTE_SIZE + WKB_INT_SIZE * 2);
 	}
 
-	return size;
-}
-
-size_t
-linked_geo_loop_data_size(const LinkedGeoLoop * loop)
-{
-	/* ring size */
-	size_t		size = WKB_INT_SIZE;
-
-	/* point data (including closing point) */
-	size += WKB_DOUBLE_SIZE * (count_linked_lat_lng(loop) + 1) * 2;
+	/* # of rings, ring sizes, point data (including closing points) */
+	size += numPolygons * WKB_INT_SIZE + numRings * WKB_INT_SIZE;
+	size += (size_t) (numCoords + numRings) * WKB_DOUBLE_SIZE * 2;
 
 	return size;
 }
@@ -280,9 +491,9 @@ wkb_write_boundary_data(uint8 *data, const CellBoundary * boundary)
 }
 
 uint8 *
-wkb_write_linked_geo_polygon_data(uint8 *data, const LinkedGeoPolygon * multiPolygon)
+wkb_write_flat_multi_polygon_data(uint8 *data, const FlatMultiPolygon * multiPolygon)
 {
-	int			isMulti = (multiPolygon->next != NULL);
+	int			isMulti = (multiPolygon->numPolygons > 1);
 	int			type = isMulti ? WKB_MULTIPOLYGON_TYPE : WKB_POLYGON_TYPE;
 
 	/* byte order */
@@ -295,11 +506,14 @@ wkb_write_linked_geo_polygon_data(uint8 *data, const LinkedGeoPolygon * multiPol
 	if (isMulti)
 	{
 		/* # of polygons */
-		data = wkb_write_int(data, count_linked_polygons(multiPolygon));
+		data = wkb_write_int(data, multiPolygon->numPolygons);
 	}
 
-	FOREACH_LINKED_POLYGON(multiPolygon, polygon)
+	for (int i = 0; i < multiPolygon->numPolygons; i++)
 	{
+		int			firstRing = multiPolygon->polygonRings[i];
+		int			endRing = multiPolygon->polygonRings[i + 1];
+
 		if (isMulti)
 		{
 			/* byte order */
@@ -311,12 +525,19 @@ wkb_write_linked_geo_polygon_data(uint8 *data, const LinkedGeoPolygon * multiPol
 		}
 
 		/* # of rings */
-		data = wkb_write_int(data, count_linked_geo_loops(polygon));
+		data = wkb_write_int(data, endRing - firstRing);
 
 		/* rings */
-		FOREACH_LINKED_LOOP(polygon, loop)
+		for (int j = firstRing; j < endRing; j++)
 		{
-			data = wkb_write_linked_geo_loop_data(data, loop);
+			const LatLng *coords = &multiPolygon->coords[multiPolygon->ringCoords[j]];
+			int			num = multiPolygon->ringCoords[j + 1] - multiPolygon->ringCoords[j];
+
+			/* # of points (including closing point) */
+			data = wkb_write_int(data, num + 1);
+			data = wkb_write_lat_lng_array(data, coords, num);
+			/* closing point data */
+			data = wkb_write_lat_lng(data, &coords[0]);
 		}
 	}
 
@@ -332,28 +553,105 @@ wkb_write_lat_lng_array(uint8 *data, const LatLng * coords, int num)
 }
 
 uint8 *
-wkb_write_linked_geo_loop_data(uint8 *data, const LinkedGeoLoop * loop)
+wkb_write_lat_lng(uint8 *data, const LatLng * coord)
 {
-	/* # of points (including closing point) */
-	data = wkb_write_int(data, count_linked_lat_lng(loop) + 1);
+	data = wkb_write(data, &coord->lng, sizeof(coord->lng));
+	data = wkb_write(data, &coord->lat, sizeof(coord->lat));
+	return data;
+}
+
+/*
+ * Allocates TWKB output for the given number of count varints and points,
+ * sized for the longest varints: twkb_end() gives the unused tail back.
+ */
+bytea *
+twkb_begin(TwkbWriter * writer, int precision, size_t numParts, size_t numCoords)
+{
+	bytea	   *twkb = palloc(VARHDRSZ + 2 + TWKB_VARINT_MAX_SIZE * (numParts + 2 * numCoords));
+
+	writer->data = (uint8 *) VARDATA(twkb);
+	writer->scale = pow(10.0, precision);
+	writer->x = 0;
+	writer->y = 0;
+	return twkb;
+}
+
+bytea *
+twkb_end(bytea *twkb, const TwkbWriter * writer)
+{
+	size_t		size = writer->data - (uint8 *) twkb;
+
+	twkb = repalloc(twkb, size);
+	SET_VARSIZE(twkb, size);
+	return twkb;
+}
 
-	/* point data */
-	FOREACH_LINKED_LAT_LNG(loop, latlng)
+void
+twkb_write_header(TwkbWriter * writer, int type, int precision, bool empty)
+{
+	/* type and zigzag encoded precision */
+	*writer->data++ = type | ((((uint32) precision << 1) ^ (precision >> 31)) & 0x0f) << 4;
+	/* metadata: no bounding box, size or id list */
+	*writer->data++ = empty ? TWKB_EMPTY_FLAG : 0;
+}
+
+/*
+ * Writes an unclosed ring, closing it. Like ST_AsTWKB, points that quantize
+ * onto the previous one are dropped past the first TWKB_RING_MIN_POINTS + 1,
+ * so a ring collapsed by a low precision still decodes as a valid ring.
+ */
+void
+twkb_write_ring(TwkbWriter * writer, const LatLng * coords, int num)
+{
+	int64		x = writer->x;
+	int64		y = writer->y;
+	int			numPoints = 0;
+
+	/* count the points first, the count comes before them */
+	for (int i = 0; i <= num; i++)
 	{
-		data = wkb_write_lat_lng(data, &latlng->vertex);
+		const LatLng *coord = &coords[i < num ? i : 0];
+		int64		nextX = llround(coord->lng * writer->scale);
+		int64		nextY = llround(coord->lat * writer->scale);
+
+		if (i > TWKB_RING_MIN_POINTS && nextX == x && nextY == y)
+			continue;
+		x = nextX;
+		y = nextY;
+		numPoints++;
 	}
-	/* closing point data */
-	data = wkb_write_lat_lng(data, &loop->first->vertex);
 
-	return data;
+	twkb_write_varint(writer, numPoints);
+	for (int i = 0; i <= num; i++)
+	{
+		const LatLng *coord = &coords[i < num ? i : 0];
+		int64		nextX = llround(coord->lng * writer->scale);
+		int64		nextY = llround(coord->lat * writer->scale);
+
+		if (i > TWKB_RING_MIN_POINTS && nextX == writer->x && nextY == writer->y)
+			continue;
+		twkb_write_signed(writer, nextX - writer->x);
+		twkb_write_signed(writer, nextY - writer->y);
+		writer->x = nextX;
+		writer->y = nextY;
+	}
 }
 
-uint8 *
-wkb_write_lat_lng(uint8 *data, const LatLng * coord)
+void
+twkb_write_varint(TwkbWriter * writer, uint64 value)
 {
-	data = wkb_write(data, &coord->lng, sizeof(coord->lng));
-	data = wkb_write(data, &coord->lat, sizeof(coord->lat));
-	return data;
+	while (value >= 0x80)
+	{
+		*writer->data++ = (uint8) (value | 0x80);
+		value >>= 7;
+	}
+	*writer->data++ = (uint8) value;
+}
+
+void
+twkb_write_signed(TwkbWriter * writer, int64 value)
+{
+	twkb_write_varint(writer, ((uint64) value << 1) ^ (uint64) (value >> 63));
 }
 
 uint8 *
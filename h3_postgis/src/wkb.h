@@ -32,7 +32,52 @@ bytea *
 bytea *
 			boundary_to_wkb(const CellBoundary * boundary);
 
+/* Planar boundary of one cell in degrees, split at the antimeridian into 1 or 2 parts */
+int
+			cell_to_planar_boundaries(H3Index cell, CellBoundary * parts);
+
+/* Polygon of one ring in tile coordinates (x = lng, y = lat), no SRID */
+bytea *
+			tile_ring_to_wkb(const LatLng * coords, int num);
+
+/*
+ * Polygons laid out in flat arrays: polygon i owns the rings from
+ * polygonRings[i] up to polygonRings[i + 1], ring j the coordinates from
+ * ringCoords[j] up to ringCoords[j + 1]. Rings are not closed.
+ */
+typedef struct
+{
+	int			numPolygons;
+	int			numRings;
+	int		   *polygonRings;	/* numPolygons + 1 offsets */
+	int		   *ringCoords;		/* numRings + 1 offsets */
+	LatLng	   *coords;			/* radians until converted to degrees */
+}			FlatMultiPolygon;
+
+/* Flattens linked polygons into one allocation, keeping radians */
+FlatMultiPolygon *
+			flat_multi_polygon_from_linked(const LinkedGeoPolygon * multiPolygon);
+
+/* Converts the coordinates from radians to degrees in place */
+void
+			flat_multi_polygon_to_degs(FlatMultiPolygon * multiPolygon);
+
+/* Single polygon of one boundary in degrees */
+FlatMultiPolygon *
+			flat_multi_polygon_from_boundary(const CellBoundary * boundary);
+
+bytea *
+			flat_multi_polygon_to_wkb(const FlatMultiPolygon * multiPolygon);
+
+/* Decimal digits kept by TWKB output, as in ST_AsTWKB */
+#define TWKB_PRECISION_MIN -7
+#define TWKB_PRECISION_MAX 7
+
+/* Polygon, or multipolygon of several boundaries, in TWKB */
+bytea *
+			boundary_array_to_twkb(const CellBoundary * boundaries, int num, int precision);
+
 bytea *
-			linked_geo_polygon_to_wkb(const LinkedGeoPolygon * multiPolygon);
+			flat_multi_polygon_to_twkb(const FlatMultiPolygon * multiPolygon, int precision);
 
 #endif
@@ -18,7 +18,6 @@
 #include <string.h>
 
 #include "wkb_bbox3.h"
-#include "wkb_linked_geo.h"
 
 typedef struct
 {
@@ -61,21 +60,21 @@ bbox3_merge(const Bbox3 * other, Bbox3 * bbox)
 }
 
 void
-bbox3_from_linked_loop(const LinkedGeoLoop * loop, Bbox3 * bbox)
+bbox3_from_ring(const LatLng * coords, int num, Bbox3 * bbox)
 {
 	Vect3		vect,
 				nextVect;
 
-	vect3_from_lat_lng(&loop->first->vertex, &vect);
+	vect3_from_lat_lng(&coords[0], &vect);
 	bbox3_from_vect3(&vect, bbox);
-	if (!loop->first->next)
+	if (num < 2)
 		return;
 
-	FOREACH_LINKED_LAT_LNG_PAIR(loop, cur, next)
+	for (int i = 0; i < num; i++)
 	{
 		Bbox3		segmentBbox;
 
-		vect3_from_lat_lng(&next->vertex, &nextVect);
+		vect3_from_lat_lng(&coords[(i + 1) % num], &nextVect);
 
 		if (!vect3_eq(&vect, &nextVect))
 		{
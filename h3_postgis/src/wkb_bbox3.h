@@ -37,8 +37,9 @@ void
 void
 			bbox3_merge(const Bbox3 * other, Bbox3 * bbox);
 
+/* Bounding box of the arcs of a ring of num > 0 unclosed coordinates */
 void
-			bbox3_from_linked_loop(const LinkedGeoLoop * loop, Bbox3 * bbox);
+			bbox3_from_ring(const LatLng * coords, int num, Bbox3 * bbox);
 
 int
 			bbox3_contains_vect3(const Bbox3 * bbox, const Vect3 * vect);
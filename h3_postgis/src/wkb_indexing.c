@@ -20,8 +20,10 @@
 #include <fmgr.h>  // PG_FUNCTION_ARGS
 #include <math.h>
 
+#include "cell_cache.h"
 #include "constants.h"
 #include "error.h"
+#include "stats.h"
 #include "type.h"
 #include "wkb_split.h"
 #include "wkb_vect3.h"
@@ -36,6 +38,13 @@
  */
 #define ABS_LAT_MAX (degsToRads(89.9999))
 
+/*
+ * Vertices of a tile ring: a split polar boundary has at most
+ * MAX_CELL_BNDRY_VERTS + 4, and each of the four clipping passes can at most
+ * double them.
+ */
+#define TILE_RING_MAX_VERTS (16 * (MAX_CELL_BNDRY_VERTS + 4))
+
 #define SPLIT_ASSERT(condition, message)			\
 	ASSERT(										\
 		condition,									\
@@ -43,6 +52,8 @@
 		message)
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_boundary_wkb);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_boundary_twkb);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_tile_wkb);
 
 /* Converts CellBoundary coordinates to degrees in place. */
 void
@@ -61,28 +72,26 @@ void
 			boundary_split_180_polar(const CellBoundary * boundary, CellBoundary * res);
 
 /*
- * Serialize one H3 cell boundary to WKB.
+ * Planar boundary of one H3 cell in degrees, as one or two parts.
  *
  * Most cells can be emitted directly. Cells crossing the antimeridian need to
  * be split first so the planar PostGIS geometry stays valid.
  */
-Datum
-h3_cell_to_boundary_wkb(PG_FUNCTION_ARGS)
+int
+cell_to_planar_boundaries(H3Index cell, CellBoundary * parts)
 {
-	H3Index		cell = PG_GETARG_H3INDEX(0);
-
-	bytea	   *wkb;
 	CellBoundary boundary;
 	int			crossNum;
 
-	h3_assert(cellToBoundary(cell, &boundary));
+	h3_assert(h3_cell_to_boundary_cached(cell, &boundary));
 
 	crossNum = boundary_crosses_180_num(&boundary);
 	if (crossNum == 0)
 	{
 		/* Cell is not crossed by antimeridian */
-		boundary_to_degs(&boundary);
-		wkb = boundary_to_wkb(&boundary);
+		parts[0] = boundary;
+		boundary_to_degs(&parts[0]);
+		return 1;
 	}
 	else if (crossNum == 1)
 	{
@@ -90,27 +99,251 @@ h3_cell_to_boundary_wkb(PG_FUNCTION_ARGS)
 		 * A single crossing means the cell touches a pole and returns through the
 		 * prime meridian. That needs the dedicated polar splitter.
 		 */
-		CellBoundary split;
-
-		boundary_split_180_polar(&boundary, &split);
-		boundary_to_degs(&split);
-		wkb = boundary_to_wkb(&split);
+		boundary_split_180_polar(&boundary, &parts[0]);
+		boundary_to_degs(&parts[0]);
+		return 1;
 	}
 	else
 	{
 		/* A normal antimeridian crossing splits into west/east polygons. */
-		CellBoundary parts[2];
-
 		boundary_split_180(&boundary, &parts[0], &parts[1]);
 
 		boundary_to_degs(&parts[0]);
 		boundary_to_degs(&parts[1]);
-		wkb = boundary_array_to_wkb(parts, 2);
+		return 2;
 	}
+}
+
+/* Serialize one H3 cell boundary to WKB. */
+Datum
+h3_cell_to_boundary_wkb(PG_FUNCTION_ARGS)
+{
+	H3Index		cell = PG_GETARG_H3INDEX(0);
+
+	bytea	   *wkb;
+	CellBoundary parts[2];
+	H3StatTimer timer;
+
+	h3_stats_begin(&timer);
+
+	if (cell_to_planar_boundaries(cell, parts) == 1)
+		wkb = boundary_to_wkb(&parts[0]);
+	else
+		wkb = boundary_array_to_wkb(parts, 2);
+
+	h3_stats_end(&timer, H3_STAT_CELL_TO_BOUNDARY_WKB, 1);
 
 	PG_RETURN_BYTEA_P(wkb);
 }
 
+/* Serialize one H3 cell boundary to TWKB, with the same splitting as WKB. */
+Datum
+h3_cell_to_boundary_twkb(PG_FUNCTION_ARGS)
+{
+	H3Index		cell = PG_GETARG_H3INDEX(0);
+	int			precision = PG_GETARG_INT32(1);
+
+	bytea	   *twkb;
+	CellBoundary parts[2];
+	int			num;
+	H3StatTimer timer;
+
+	ASSERT(precision >= TWKB_PRECISION_MIN && precision <= TWKB_PRECISION_MAX,
+		   ERRCODE_INVALID_PARAMETER_VALUE,
+		   "TWKB precision must be between %d and %d, got %d",
+		   TWKB_PRECISION_MIN, TWKB_PRECISION_MAX, precision);
+
+	h3_stats_begin(&timer);
+
+	num = cell_to_planar_boundaries(cell, parts);
+	twkb = boundary_array_to_twkb(parts, num, precision);
+
+	h3_stats_end(&timer, H3_STAT_CELL_TO_BOUNDARY_TWKB, 1);
+
+	PG_RETURN_BYTEA_P(twkb);
+}
+
+/*
+ * One Sutherland-Hodgman pass keeping the side of the ring where x (or y)
+ * is at most (or at least) bound. Tile coordinates are kept as lng = x and
+ * lat = y.
+ */
+static int
+tile_ring_clip(const LatLng * in, int num, LatLng * out, bool alongX, double bound, bool keepBelow)
+{
+	int			count = 0;
+
+	for (int v = 0; v < num; v++)
+	{
+		const LatLng *a = &in[v];
+		const LatLng *b = &in[(v + 1) % num];
+		double		va = alongX ? a->lng : a->lat;
+		double		vb = alongX ? b->lng : b->lat;
+		bool		aInside = keepBelow ? va <= bound : va >= bound;
+		bool		bInside = keepBelow ? vb <= bound : vb >= bound;
+
+		if (aInside)
+			out[count++] = *a;
+		if (aInside != bInside)
+		{
+			double		t = (bound - va) / (vb - va);
+
+			out[count].lng = alongX ? bound : a->lng + t * (b->lng - a->lng);
+			out[count].lat = alongX ? a->lat + t * (b->lat - a->lat) : bound;
+			count++;
+		}
+	}
+	return count;
+}
+
+/* Cross product of (b - a) and (c - b), zero when the points are collinear */
+static double
+tile_cross(const LatLng * a, const LatLng * b, const LatLng * c)
+{
+	return (b->lng - a->lng) * (c->lat - b->lat) - (b->lat - a->lat) * (c->lng - b->lng);
+}
+
+/*
+ * Project the cell boundary into Web Mercator tile z/x/y with extent units
+ * per side, clip it to the tile and buffer units around it and snap it to
+ * integers, like ST_AsMVTGeom does. Y points down and the exterior ring is
+ * clockwise, as vector tiles expect. Returns NULL if the cell misses the
+ * tile.
+ *
+ * Clipping keeps one ring: where the clip cuts a concave polar cell in two,
+ * the parts stay joined along the edge of the buffer, as with other tile
+ * clippers.
+ */
+Datum
+h3_cell_to_tile_wkb(PG_FUNCTION_ARGS)
+{
+	H3Index		cell = PG_GETARG_H3INDEX(0);
+	int			z = PG_GETARG_INT32(1);
+	int			x = PG_GETARG_INT32(2);
+	int			y = PG_GETARG_INT32(3);
+	int			extent = PG_GETARG_INT32(4);
+	int			buffer = PG_GETARG_INT32(5);
+
+	CellBoundary boundary;
+	LatLng		ring[2][TILE_RING_MAX_VERTS];
+	LatLng	   *points;
+	int			numVerts;
+	int			count = 0;
+	double		tiles;
+	double		shift = 0;
+	double		area = 0;
+	H3StatTimer timer;
+
+	ASSERT(z >= 0 && z <= 30, ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Tile zoom must be between 0 and 30, got %d", z);
+	ASSERT(x >= 0 && x < (1 << z) && y >= 0 && y < (1 << z),
+		   ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Tile %d/%d/%d does not exist", z, x, y);
+	ASSERT(extent > 0, ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Tile extent must be positive, got %d", extent);
+	ASSERT(buffer >= 0, ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Tile buffer must not be negative, got %d", buffer);
+
+	h3_stats_begin(&timer);
+
+	h3_assert(h3_cell_to_boundary_cached(cell, &boundary));
+	tiles = (double) (1 << z);
+
+	if (boundary_crosses_180_num(&boundary) == 1)
+	{
+		/* A polar cell spans all longitudes, bridge it along the antimeridian */
+		CellBoundary split;
+
+		boundary_split_180_polar(&boundary, &split);
+		boundary = split;
+	}
+	else
+	{
+		/*
+		 * Make the boundary continuous across the antimeridian, then take the
+		 * copy nearest to the tile, so that buffers wrap around too.
+		 */
+		double		tileLng = ((x + 0.5) / tiles - 0.5) * 2 * M_PI;
+		bool		crosses = boundary_crosses_180_num(&boundary) > 0;
+		double		center = 0;
+
+		for (int v = 0; v < boundary.numVerts; v++)
+		{
+			if (crosses && boundary.verts[v].lng < 0)
+				boundary.verts[v].lng += 2 * M_PI;
+			center += boundary.verts[v].lng;
+		}
+		center /= boundary.numVerts;
+		shift = rint((tileLng - center) / (2 * M_PI)) * 2 * M_PI;
+	}
+
+	numVerts = boundary.numVerts;
+	for (int v = 0; v < numVerts; v++)
+	{
+		double		lng = boundary.verts[v].lng + shift;
+		/* past the edge of the Mercator world, clipping cuts it off */
+		double		lat = Max(-ABS_LAT_MAX, Min(ABS_LAT_MAX, boundary.verts[v].lat));
+
+		ring[0][v].lng = ((lng / (2 * M_PI) + 0.5) * tiles - x) * extent;
+		ring[0][v].lat = ((0.5 - log(tan(M_PI_4 + lat / 2)) / (2 * M_PI)) * tiles - y) * extent;
+	}
+
+	/* clip to the buffered tile */
+	numVerts = tile_ring_clip(ring[0], numVerts, ring[1], true, -buffer, false);
+	numVerts = tile_ring_clip(ring[1], numVerts, ring[0], true, extent + buffer, true);
+	numVerts = tile_ring_clip(ring[0], numVerts, ring[1], false, -buffer, false);
+	numVerts = tile_ring_clip(ring[1], numVerts, ring[0], false, extent + buffer, true);
+
+	/*
+	 * Snap to the grid, dropping repeated and collinear points, such as the
+	 * spikes left where clamping flattens polar cells.
+	 */
+	points = ring[1];
+	for (int v = 0; v < numVerts; v++)
+	{
+		LatLng		point = {.lat = rint(ring[0][v].lat) + 0.0,.lng = rint(ring[0][v].lng) + 0.0};
+
+		while (count >= 2 && tile_cross(&points[count - 2], &points[count - 1], &point) == 0)
+			count--;
+		if (count == 0 || point.lat != points[count - 1].lat || point.lng != points[count - 1].lng)
+			points[count++] = point;
+	}
+	while (count >= 3 && tile_cross(&points[count - 2], &points[count - 1], &points[0]) == 0)
+		count--;
+	while (count >= 3 && tile_cross(&points[count - 1], &points[0], &points[1]) == 0)
+	{
+		points++;
+		count--;
+	}
+
+	/* positive shoelace area with y down is clockwise */
+	for (int v = 0; v < count; v++)
+	{
+		const LatLng *a = &points[v];
+		const LatLng *b = &points[(v + 1) % count];
+
+		area += a->lng * b->lat - b->lng * a->lat;
+	}
+
+	h3_stats_end(&timer, H3_STAT_CELL_TO_TILE_WKB, 1);
+
+	if (count < 3 || area == 0)
+		PG_RETURN_NULL();
+
+	if (area < 0)
+	{
+		for (int v = 0; v < count / 2; v++)
+		{
+			LatLng		swap = points[v];
+
+			points[v] = points[count - 1 - v];
+			points[count - 1 - v] = swap;
+		}
+	}
+
+	PG_RETURN_BYTEA_P(tile_ring_to_wkb(points, count));
+}
+
 void
 boundary_to_degs(CellBoundary * boundary)
 {
@@ -29,6 +29,7 @@
 #include <utils/memutils.h>
 
 #include "error.h"
+#include "stats.h"
 #include "type.h"
 #include "wkb_vertex_graph.h"
 #include "wkb_linked_geo.h"
@@ -36,6 +37,7 @@
 #include "wkb.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_multi_polygon_wkb);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_multi_polygon_twkb);
 
 typedef struct
 {
@@ -75,6 +77,21 @@ typedef struct
 	double	   *splitTs;
 } NodedSegment;
 
+/*
+ * Uniform grid over the bounds of the noded segments, listing the segments
+ * whose bounds meet each bucket, so only nearby pairs get tested.
+ */
+typedef struct
+{
+	int			size;			/* buckets along each axis */
+	double		minLat;
+	double		maxLat;
+	double		minLng;
+	double		maxLng;
+	int		   *bucketStart;	/* size * size + 1 offsets into segments */
+	int		   *segments;
+} SegmentGrid;
+
 typedef struct
 {
 	LatLng		vertex;
@@ -82,6 +99,23 @@ typedef struct
 	int			edgeCount;
 } PolygonizeVertex;
 
+/*
+ * Side of the grid cells hashing polygonizer vertices, in radians. It only
+ * has to exceed the geoAlmostEqual() tolerance, so that vertices equal under
+ * it land in the same or neighboring cells.
+ */
+#define POLYGONIZE_VERTEX_CELL 1e-9
+
+/* Polygonizer vertices, hashed by grid cell for tolerant lookups */
+typedef struct
+{
+	PolygonizeVertex *vertices;
+	int			count;
+	int			cap;
+	int		   *bucketHeads;	/* cap * 2 buckets, -1 when empty */
+	int		   *bucketNext;		/* next vertex in the same bucket, or -1 */
+} PolygonizeVertexSet;
+
 typedef struct
 {
 	int			edgeIdx;
@@ -109,10 +143,6 @@ static const CellBoundary FULL_WORLD_BOUNDARY = {
 	}
 };
 
-/* Converts LinkedGeoPolygon vertex coordinates to degrees in place */
-static void
-			linked_geo_polygon_to_degs(LinkedGeoPolygon * multiPolygon);
-
 int
 			boundary_crosses_180_num(const CellBoundary * boundary);
 
@@ -130,8 +160,8 @@ void
  * normal cases stay on released H3 output, and SQL wrappers do not try to
  * repair invalid geometry after the fact.
  */
-static bytea *
-			coarse_cells_to_multi_polygon_wkb(const H3Index * h3set, int numHexes, int resolution);
+static FlatMultiPolygon *
+			coarse_cells_to_flat_multi_polygon(const H3Index * h3set, int numHexes, int resolution);
 
 static LinkedGeoPolygon *
 			prepare_linked_polygon_for_wkb(const LinkedGeoPolygon * linkedPolygon, int numHexes, int resolution);
@@ -253,6 +283,15 @@ static void
 static bool
 			segment_intersection_t(const NodedSegment * a, const NodedSegment * b, double *ta, double *tb);
 
+static int
+			segment_grid_bucket(double value, double low, double high, int size);
+
+static void
+			segment_grid_build(SegmentGrid * grid, const NodedSegment * segments, int segmentCount);
+
+static void
+			segments_add_split_ts(NodedSegment * a, NodedSegment * b);
+
 static bool
 			segment_collinear_overlap_ts(const NodedSegment * a, const NodedSegment * b, double *aStart, double *aEnd, double *bStart, double *bEnd);
 
@@ -275,7 +314,13 @@ static LinkedGeoPolygon *
 			polygonize_noded_graph(const VertexGraph * graph);
 
 static int
-			polygonize_find_or_add_vertex(PolygonizeVertex **vertices, int *vertexCount, int *vertexCap, const LatLng *vertex);
+			polygonize_vertex_bucket(const PolygonizeVertexSet * set, int64 latCell, int64 lngCell);
+
+static void
+			polygonize_vertex_set_grow(PolygonizeVertexSet * set);
+
+static int
+			polygonize_find_or_add_vertex(PolygonizeVertexSet * set, const LatLng * vertex);
 
 static int
 			polygonize_edge_ref_cmp(const void *a, const void *b);
@@ -307,10 +352,10 @@ static void
 static double
 			normalize_lng_around(double lng, double around);
 
-Datum
-h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
+/* Builds the planar multipolygon of the cells in array */
+static FlatMultiPolygon *
+cells_to_flat_multi_polygon(ArrayType *array)
 {
-	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
 	LinkedGeoPolygon *linkedPolygon;
 	H3Error		error;
 	int			numHexes;
@@ -318,7 +363,7 @@ h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
 	Datum		value;
 	bool		isnull;
 	H3Index    *h3set;
-	bytea	   *wkb = NULL;
+	FlatMultiPolygon *flat = NULL;
 	int			resolution = -1;
 	bool		localLinkedPolygon = false;
 
@@ -355,13 +400,13 @@ h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
 		{
 			pfree(linkedPolygon);
 			pfree(h3set);
-			PG_RETURN_BYTEA_P(boundary_to_wkb(&FULL_WORLD_BOUNDARY));
+			return flat_multi_polygon_from_boundary(&FULL_WORLD_BOUNDARY);
 		}
 
-		wkb = coarse_cells_to_multi_polygon_wkb(h3set, numHexes, resolution);
+		flat = coarse_cells_to_flat_multi_polygon(h3set, numHexes, resolution);
 		pfree(linkedPolygon);
 		pfree(h3set);
-		PG_RETURN_BYTEA_P(wkb);
+		return flat;
 	}
 	h3_assert(error);
 
@@ -382,11 +427,11 @@ h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
 			CellBoundary boundary;
 
 			build_extent_boundary(&boundary, &extents);
-			wkb = boundary_to_wkb(&boundary);
+			flat = flat_multi_polygon_from_boundary(&boundary);
 			destroyLinkedMultiPolygon(linkedPolygon);
 			pfree(linkedPolygon);
 			pfree(h3set);
-			PG_RETURN_BYTEA_P(wkb);
+			return flat;
 		}
 	}
 
@@ -400,11 +445,11 @@ h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
 		&& is_linked_polygon_crossed_by_180(linkedPolygon)
 		&& linked_polygon_is_north_polar_single_self_touch(linkedPolygon))
 	{
-		wkb = coarse_cells_to_multi_polygon_wkb(h3set, numHexes, resolution);
+		flat = coarse_cells_to_flat_multi_polygon(h3set, numHexes, resolution);
 		destroyLinkedMultiPolygon(linkedPolygon);
 		pfree(linkedPolygon);
 		pfree(h3set);
-		PG_RETURN_BYTEA_P(wkb);
+		return flat;
 	}
 
 	if (resolution <= 2)
@@ -443,11 +488,11 @@ h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
 		{
 			if (preparedPolygon)
 				free_linked_geo_polygon(preparedPolygon);
-			wkb = coarse_cells_to_multi_polygon_wkb(h3set, numHexes, resolution);
+			flat = coarse_cells_to_flat_multi_polygon(h3set, numHexes, resolution);
 			destroyLinkedMultiPolygon(linkedPolygon);
 			pfree(linkedPolygon);
 			pfree(h3set);
-			PG_RETURN_BYTEA_P(wkb);
+			return flat;
 		}
 
 		destroyLinkedMultiPolygon(linkedPolygon);
@@ -455,29 +500,9 @@ h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
 		linkedPolygon = preparedPolygon;
 		localLinkedPolygon = true;
 	}
-	else if (is_linked_polygon_crossed_by_180(linkedPolygon))
-	{
-		/*
-		 * Higher-resolution crossed output is usually salvageable by splitting at
-		 * the antimeridian and then continuing through the normal WKB path.
-		 */
-		LinkedGeoPolygon *splitPolygon = split_linked_polygon_by_180(linkedPolygon);
-
-		destroyLinkedMultiPolygon(linkedPolygon);
-		pfree(linkedPolygon);
-		linkedPolygon = splitPolygon;
-		localLinkedPolygon = true;
-	}
 
-	if (numHexes > 0
-		&& !linkedPolygon->first
-		&& !linkedPolygon->next)
-		wkb = boundary_to_wkb(&FULL_WORLD_BOUNDARY);
-	else
-	{
-		linked_geo_polygon_to_degs(linkedPolygon);
-		wkb = linked_geo_polygon_to_wkb(linkedPolygon);
-	}
+	/* From here on the polygons are only read, so they are flattened once */
+	flat = flat_multi_polygon_from_linked(linkedPolygon);
 	if (localLinkedPolygon)
 		free_linked_geo_polygon(linkedPolygon);
 	else
@@ -487,25 +512,87 @@ h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
 	}
 	pfree(h3set);
 
-	PG_RETURN_BYTEA_P(wkb);
+	if (resolution > 2 && is_flat_multi_polygon_crossed_by_180(flat))
+	{
+		/*
+		 * Higher-resolution crossed output is usually salvageable by splitting at
+		 * the antimeridian and then continuing through the normal WKB path.
+		 */
+		FlatMultiPolygon *splitPolygon = split_flat_multi_polygon_by_180(flat);
+
+		pfree(flat);
+		flat = splitPolygon;
+	}
+
+	if (numHexes > 0
+		&& flat->numPolygons == 1
+		&& flat->numRings == 0)
+		return flat_multi_polygon_from_boundary(&FULL_WORLD_BOUNDARY);
+
+	flat_multi_polygon_to_degs(flat);
+	return flat;
 }
 
-void
-linked_geo_polygon_to_degs(LinkedGeoPolygon * multiPolygon)
+/*
+ * Runs the polygon pipeline in a new context, which the caller deletes once
+ * the result is serialized. The pipeline builds and discards many small
+ * linked nodes that are then released all at once.
+ */
+static FlatMultiPolygon *
+cells_to_flat_multi_polygon_in(ArrayType *array, MemoryContext *arena)
 {
-	FOREACH_LINKED_POLYGON_NOCONST(multiPolygon, polygon)
-	{
-		FOREACH_LINKED_LOOP_NOCONST(polygon, loop)
-		{
-			FOREACH_LINKED_LAT_LNG_NOCONST(loop, latlng)
-			{
-				LatLng	   *vertex = &latlng->vertex;
+	FlatMultiPolygon *flat;
+	MemoryContext oldContext;
 
-				vertex->lat = radsToDegs(vertex->lat);
-				vertex->lng = radsToDegs(vertex->lng);
-			}
-		}
-	}
+	*arena = AllocSetContextCreate(CurrentMemoryContext,
+								   "h3 multi polygon",
+								   ALLOCSET_DEFAULT_SIZES);
+	oldContext = MemoryContextSwitchTo(*arena);
+	flat = cells_to_flat_multi_polygon(array);
+	MemoryContextSwitchTo(oldContext);
+
+	return flat;
+}
+
+Datum
+h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
+{
+	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+	bytea	   *wkb;
+	MemoryContext arena;
+	H3StatTimer timer;
+
+	h3_stats_begin(&timer);
+	wkb = flat_multi_polygon_to_wkb(cells_to_flat_multi_polygon_in(array, &arena));
+	MemoryContextDelete(arena);
+	h3_stats_end(&timer, H3_STAT_CELLS_TO_MULTI_POLYGON_WKB,
+				 ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array)));
+
+	PG_RETURN_BYTEA_P(wkb);
+}
+
+Datum
+h3_cells_to_multi_polygon_twkb(PG_FUNCTION_ARGS)
+{
+	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+	int			precision = PG_GETARG_INT32(1);
+	bytea	   *twkb;
+	MemoryContext arena;
+	H3StatTimer timer;
+
+	ASSERT(precision >= TWKB_PRECISION_MIN && precision <= TWKB_PRECISION_MAX,
+		   ERRCODE_INVALID_PARAMETER_VALUE,
+		   "TWKB precision must be between %d and %d, got %d",
+		   TWKB_PRECISION_MIN, TWKB_PRECISION_MAX, precision);
+
+	h3_stats_begin(&timer);
+	twkb = flat_multi_polygon_to_twkb(cells_to_flat_multi_polygon_in(array, &arena),
+									  precision);
+	MemoryContextDelete(arena);
+	h3_stats_end(&timer, H3_STAT_CELLS_TO_MULTI_POLYGON_TWKB,
+				 ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array)));
+
+	PG_RETURN_BYTEA_P(twkb);
 }
 
 /*
@@ -669,13 +756,13 @@ cell_set_is_full_globe(const H3Index * h3set, int numHexes)
  * Example: low-res seam-heavy world-edge tiles can reject direct output but
  * still serialize correctly from exact split cell boundaries.
  */
-bytea *
-coarse_cells_to_multi_polygon_wkb(const H3Index * h3set, int numHexes, int resolution)
+FlatMultiPolygon *
+coarse_cells_to_flat_multi_polygon(const H3Index * h3set, int numHexes, int resolution)
 {
 	LinkedGeoPolygon *cellsPolygon = NULL;
 	LinkedGeoPolygon *lastPolygon = NULL;
 	LinkedGeoPolygon *preparedPolygon;
-	bytea	   *wkb;
+	FlatMultiPolygon *flat;
 
 	for (int i = 0; i < numHexes; i++)
 	{
@@ -723,22 +810,22 @@ coarse_cells_to_multi_polygon_wkb(const H3Index * h3set, int numHexes, int resol
 
 		h3_set_boundary_extents(h3set, numHexes, &extents);
 		build_extent_boundary(&boundary, &extents);
-		wkb = boundary_to_wkb(&boundary);
+		flat = flat_multi_polygon_from_boundary(&boundary);
 		free_linked_geo_polygon(preparedPolygon);
-		return wkb;
+		return flat;
 	}
 
 	if (numHexes > 0
 		&& !preparedPolygon->first
 		&& !preparedPolygon->next)
-		wkb = boundary_to_wkb(&FULL_WORLD_BOUNDARY);
+		flat = flat_multi_polygon_from_boundary(&FULL_WORLD_BOUNDARY);
 	else
 	{
-		linked_geo_polygon_to_degs(preparedPolygon);
-		wkb = linked_geo_polygon_to_wkb(preparedPolygon);
+		flat = flat_multi_polygon_from_linked(preparedPolygon);
+		flat_multi_polygon_to_degs(flat);
 	}
 	free_linked_geo_polygon(preparedPolygon);
-	return wkb;
+	return flat;
 }
 
 /*
@@ -1894,12 +1981,121 @@ segment_lat_lng_at(const NodedSegment * segment, double t, LatLng * latlng)
 	latlng->lng = segment->from.lng + (segment->to.lng - segment->from.lng) * t;
 }
 
+/* Grid bucket of a coordinate, clamped to the grid */
+int
+segment_grid_bucket(double value, double low, double high, int size)
+{
+	int			bucket;
+
+	if (high <= low)
+		return 0;
+	bucket = (int) ((value - low) / (high - low) * size);
+	return Max(0, Min(size - 1, bucket));
+}
+
+/*
+ * Bucket the segments by their bounds, grown by the tolerance of
+ * segments_bounds_overlap so that overlapping pairs always share a bucket.
+ * About one bucket per segment keeps buckets short for evenly spread cells.
+ */
+void
+segment_grid_build(SegmentGrid * grid, const NodedSegment * segments, int segmentCount)
+{
+	int			bucketCount;
+	int64		entryCount = 0;
+	int		   *fill;
+
+	grid->size = Max(1, Min(1024, (int) sqrt((double) segmentCount)));
+	grid->minLat = grid->minLng = DBL_MAX;
+	grid->maxLat = grid->maxLng = -DBL_MAX;
+	for (int i = 0; i < segmentCount; i++)
+	{
+		grid->minLat = fmin(grid->minLat, segments[i].minLat);
+		grid->maxLat = fmax(grid->maxLat, segments[i].maxLat);
+		grid->minLng = fmin(grid->minLng, segments[i].minLng);
+		grid->maxLng = fmax(grid->maxLng, segments[i].maxLng);
+	}
+
+	bucketCount = grid->size * grid->size;
+	grid->bucketStart = palloc0_array_checked(bucketCount + 1, sizeof(*grid->bucketStart));
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int i = 0; i < segmentCount; i++)
+		{
+			const NodedSegment *segment = &segments[i];
+			int			lat0 = segment_grid_bucket(segment->minLat - DBL_EPSILON, grid->minLat, grid->maxLat, grid->size);
+			int			lat1 = segment_grid_bucket(segment->maxLat + DBL_EPSILON, grid->minLat, grid->maxLat, grid->size);
+			int			lng0 = segment_grid_bucket(segment->minLng - DBL_EPSILON, grid->minLng, grid->maxLng, grid->size);
+			int			lng1 = segment_grid_bucket(segment->maxLng + DBL_EPSILON, grid->minLng, grid->maxLng, grid->size);
+
+			for (int lat = lat0; lat <= lat1; lat++)
+			{
+				for (int lng = lng0; lng <= lng1; lng++)
+				{
+					int			bucket = lat * grid->size + lng;
+
+					if (pass == 0)
+					{
+						grid->bucketStart[bucket + 1]++;
+						entryCount++;
+					}
+					else
+						grid->segments[fill[bucket]++] = i;
+				}
+			}
+		}
+
+		if (pass == 0)
+		{
+			if (entryCount > INT_MAX)
+				elog(ERROR, "too many polygon edges");
+			for (int bucket = 0; bucket < bucketCount; bucket++)
+				grid->bucketStart[bucket + 1] += grid->bucketStart[bucket];
+			grid->segments = palloc_array_checked(entryCount, sizeof(*grid->segments));
+			fill = palloc_array_checked(bucketCount, sizeof(*fill));
+			memcpy(fill, grid->bucketStart, bucketCount * sizeof(*fill));
+		}
+	}
+	pfree(fill);
+}
+
+/* Record where two segments cross or overlap as split points of both */
+void
+segments_add_split_ts(NodedSegment * a, NodedSegment * b)
+{
+	double		ta;
+	double		tb;
+	double		overlapStartA;
+	double		overlapEndA;
+	double		overlapStartB;
+	double		overlapEndB;
+
+	if (segment_intersection_t(a, b, &ta, &tb))
+	{
+		segment_add_split_t(a, ta);
+		segment_add_split_t(b, tb);
+		return;
+	}
+
+	if (segment_collinear_overlap_ts(
+			a, b,
+			&overlapStartA, &overlapEndA,
+			&overlapStartB, &overlapEndB))
+	{
+		segment_add_split_t(a, overlapStartA);
+		segment_add_split_t(a, overlapEndA);
+		segment_add_split_t(b, overlapStartB);
+		segment_add_split_t(b, overlapEndB);
+	}
+}
+
 /* Add every noded segment piece to the vertex graph used for polygonization. */
 void
 graph_add_noded_linked_polygon_edges(VertexGraph * graph, const LinkedGeoPolygon * multiPolygon)
 {
 	int			segmentCount = count_linked_polygon_edges(multiPolygon);
 	NodedSegment *segments;
+	SegmentGrid grid;
 
 	if (segmentCount <= 0)
 		return;
@@ -1907,43 +2103,44 @@ graph_add_noded_linked_polygon_edges(VertexGraph * graph, const LinkedGeoPolygon
 	segments = palloc_array_checked(segmentCount, sizeof(*segments));
 	collect_linked_polygon_segments(multiPolygon, segments, segmentCount);
 
-	for (int i = 0; i < segmentCount; i++)
+	/*
+	 * Test the pairs sharing a grid bucket. A pair meeting several buckets is
+	 * tested only in the one holding the corner where their bounds start to
+	 * overlap.
+	 */
+	segment_grid_build(&grid, segments, segmentCount);
+	for (int bucket = 0; bucket < grid.size * grid.size; bucket++)
 	{
+		int			start = grid.bucketStart[bucket];
+		int			end = grid.bucketStart[bucket + 1];
+
 		CHECK_FOR_INTERRUPTS();
-		for (int j = i + 1; j < segmentCount; j++)
+		for (int a = start; a < end; a++)
 		{
-			double		ti;
-			double		tj;
-			double		overlapStartI;
-			double		overlapEndI;
-			double		overlapStartJ;
-			double		overlapEndJ;
-
-			if ((j & 0x3ff) == 0)
-				CHECK_FOR_INTERRUPTS();
+			NodedSegment *first = &segments[grid.segments[a]];
 
-			if (!segments_bounds_overlap(&segments[i], &segments[j]))
-				continue;
-
-			if (segment_intersection_t(&segments[i], &segments[j], &ti, &tj))
+			for (int b = a + 1; b < end; b++)
 			{
-				segment_add_split_t(&segments[i], ti);
-				segment_add_split_t(&segments[j], tj);
-				continue;
-			}
+				NodedSegment *second = &segments[grid.segments[b]];
+				int			latBucket;
+				int			lngBucket;
 
-			if (segment_collinear_overlap_ts(
-					&segments[i], &segments[j],
-					&overlapStartI, &overlapEndI,
-					&overlapStartJ, &overlapEndJ))
-			{
-				segment_add_split_t(&segments[i], overlapStartI);
-				segment_add_split_t(&segments[i], overlapEndI);
-				segment_add_split_t(&segments[j], overlapStartJ);
-				segment_add_split_t(&segments[j], overlapEndJ);
+				if (!segments_bounds_overlap(first, second))
+					continue;
+
+				latBucket = segment_grid_bucket(fmax(first->minLat, second->minLat),
+												grid.minLat, grid.maxLat, grid.size);
+				lngBucket = segment_grid_bucket(fmax(first->minLng, second->minLng),
+												grid.minLng, grid.maxLng, grid.size);
+				if (latBucket * grid.size + lngBucket != bucket)
+					continue;
+
+				segments_add_split_ts(first, second);
 			}
 		}
 	}
+	pfree(grid.bucketStart);
+	pfree(grid.segments);
 
 	for (int i = 0; i < segmentCount; i++)
 	{
@@ -2013,11 +2210,11 @@ LinkedGeoPolygon *
 polygonize_noded_graph(const VertexGraph * graph)
 {
 	PolygonizeHalfEdge *edges;
-	PolygonizeVertex *vertices = NULL;
+	PolygonizeVertexSet vertexSet = {0};
+	PolygonizeVertex *vertices;
 	PolygonizeEdgeRef *edgeRefs;
 	int		   *edgeOffsets;
-	int			vertexCount = 0;
-	int			vertexCap = 0;
+	int			vertexCount;
 	int			edgeIdx = 0;
 	int			halfEdgeCount;
 	LinkedGeoPolygon *raw = NULL;
@@ -2038,10 +2235,8 @@ polygonize_noded_graph(const VertexGraph * graph)
 		for (VertexNode *node = graph->buckets[bucketIdx]; node; node = node->next)
 		{
 			double		dLng = normalize_lng_around(node->to.lng, node->from.lng) - node->from.lng;
-			int			fromVertex = polygonize_find_or_add_vertex(
-				&vertices, &vertexCount, &vertexCap, &node->from);
-			int			toVertex = polygonize_find_or_add_vertex(
-				&vertices, &vertexCount, &vertexCap, &node->to);
+			int			fromVertex = polygonize_find_or_add_vertex(&vertexSet, &node->from);
+			int			toVertex = polygonize_find_or_add_vertex(&vertexSet, &node->to);
 
 			if (edgeIdx > halfEdgeCount - 2)
 				elog(ERROR, "too many polygon edges");
@@ -2052,7 +2247,7 @@ polygonize_noded_graph(const VertexGraph * graph)
 			edges[edgeIdx].toVertex = toVertex;
 			edges[edgeIdx].angle = atan2(node->to.lat - node->from.lat, dLng);
 			edges[edgeIdx].nextEdge = -1;
-			vertices[fromVertex].edgeCount++;
+			vertexSet.vertices[fromVertex].edgeCount++;
 			edgeIdx++;
 
 			edges[edgeIdx].from = node->to;
@@ -2061,7 +2256,7 @@ polygonize_noded_graph(const VertexGraph * graph)
 			edges[edgeIdx].toVertex = fromVertex;
 			edges[edgeIdx].angle = atan2(node->from.lat - node->to.lat, -dLng);
 			edges[edgeIdx].nextEdge = -1;
-			vertices[toVertex].edgeCount++;
+			vertexSet.vertices[toVertex].edgeCount++;
 			edgeIdx++;
 		}
 	}
@@ -2069,6 +2264,11 @@ polygonize_noded_graph(const VertexGraph * graph)
 	if (edgeIdx != halfEdgeCount)
 		elog(ERROR, "vertex graph edge count changed during polygonization");
 
+	vertices = vertexSet.vertices;
+	vertexCount = vertexSet.count;
+	pfree(vertexSet.bucketHeads);
+	pfree(vertexSet.bucketNext);
+
 	edgeRefs = palloc_array_checked(edgeIdx, sizeof(*edgeRefs));
 	edgeOffsets = palloc_array_checked(vertexCount, sizeof(*edgeOffsets));
 	{
@@ -2200,36 +2400,89 @@ polygonize_noded_graph(const VertexGraph * graph)
 }
 
 int
-polygonize_find_or_add_vertex(PolygonizeVertex **vertices, int *vertexCount, int *vertexCap, const LatLng *vertex)
+polygonize_vertex_bucket(const PolygonizeVertexSet * set, int64 latCell, int64 lngCell)
 {
+	return (int) (hashVertexCell(latCell, lngCell) % (uint64) (set->cap * 2));
+}
+
+/* Doubles the capacity of the set and rehashes its vertices */
+void
+polygonize_vertex_set_grow(PolygonizeVertexSet * set)
+{
+	if (set->cap > INT_MAX / 4)
+		elog(ERROR, "too many polygon edges");
+	set->cap = set->cap ? set->cap * 2 : 32;
+	set->vertices = set->vertices
+		? repalloc_array_checked(set->vertices, set->cap, sizeof(*set->vertices))
+		: palloc_array_checked(set->cap, sizeof(*set->vertices));
+	set->bucketNext = set->bucketNext
+		? repalloc_array_checked(set->bucketNext, set->cap, sizeof(*set->bucketNext))
+		: palloc_array_checked(set->cap, sizeof(*set->bucketNext));
+	if (set->bucketHeads)
+		pfree(set->bucketHeads);
+	set->bucketHeads = palloc_array_checked(set->cap * 2, sizeof(*set->bucketHeads));
+	memset(set->bucketHeads, -1, set->cap * 2 * sizeof(*set->bucketHeads));
+
+	for (int i = 0; i < set->count; i++)
+	{
+		const LatLng *vertex = &set->vertices[i].vertex;
+		int			bucket = polygonize_vertex_bucket(
+			set,
+			(int64) floor(vertex->lat / POLYGONIZE_VERTEX_CELL),
+			(int64) floor(vertex->lng / POLYGONIZE_VERTEX_CELL));
+
+		set->bucketNext[i] = set->bucketHeads[bucket];
+		set->bucketHeads[bucket] = i;
+	}
+}
+
+int
+polygonize_find_or_add_vertex(PolygonizeVertexSet * set, const LatLng * vertex)
+{
+	int64		latCell = (int64) floor(vertex->lat / POLYGONIZE_VERTEX_CELL);
+	int64		lngCell = (int64) floor(vertex->lng / POLYGONIZE_VERTEX_CELL);
+	int			found = -1;
+	int			bucket;
+
 	/*
 	 * The polygonizer nodes edges produced from H3-generated or synthesized
 	 * split vertices. geoAlmostEqual is intentional here: the split path can
 	 * produce numerically equivalent vertices through different arithmetic
-	 * routes, and the graph has to merge them to stay connected.
+	 * routes, and the graph has to merge them to stay connected. Such vertices
+	 * can straddle a cell border, so the neighboring cells are probed too, and
+	 * the first vertex added wins as it would in a linear scan.
 	 */
-	for (int i = 0; i < *vertexCount; i++)
+	if (set->count > 0)
 	{
-		if (geoAlmostEqual(&(*vertices)[i].vertex, vertex))
-			return i;
+		for (int dLat = -1; dLat <= 1; dLat++)
+		{
+			for (int dLng = -1; dLng <= 1; dLng++)
+			{
+				bucket = polygonize_vertex_bucket(set, latCell + dLat, lngCell + dLng);
+				for (int i = set->bucketHeads[bucket]; i >= 0; i = set->bucketNext[i])
+				{
+					if ((found < 0 || i < found)
+						&& geoAlmostEqual(&set->vertices[i].vertex, vertex))
+						found = i;
+				}
+			}
+		}
+		if (found >= 0)
+			return found;
 	}
 
-	if (*vertexCount >= *vertexCap)
-	{
-		if (*vertexCap > INT_MAX / 2)
-			elog(ERROR, "too many polygon edges");
-		*vertexCap = *vertexCap ? *vertexCap * 2 : 32;
-		*vertices = *vertices
-			? repalloc_array_checked(*vertices, *vertexCap, sizeof(**vertices))
-			: palloc_array_checked(*vertexCap, sizeof(**vertices));
-	}
+	if (set->count >= set->cap)
+		polygonize_vertex_set_grow(set);
 
-	(*vertices)[*vertexCount] = (PolygonizeVertex) {
+	set->vertices[set->count] = (PolygonizeVertex) {
 		.vertex = *vertex,
 		.firstEdge = 0,
 		.edgeCount = 0,
 	};
-	return (*vertexCount)++;
+	bucket = polygonize_vertex_bucket(set, latCell, lngCell);
+	set->bucketNext[set->count] = set->bucketHeads[bucket];
+	set->bucketHeads[bucket] = set->count;
+	return set->count++;
 }
 
 int
@@ -24,6 +24,7 @@
 #include "wkb_split.h"
 #include "wkb_bbox3.h"
 #include "wkb_linked_geo.h"
+#include "wkb.h"
 
 /*
 
@@ -140,34 +141,55 @@ typedef struct
 	SplitIntersect *intersects;
 	SplitIntersect **sortedIntersects;
 
-	/* Non-split holes */
+	/* Non-split holes, as ring indices of the input (-1 once assigned) */
+	const FlatMultiPolygon *input;
 	int			holeNum;
-	const LinkedGeoLoop **holes;
+	int		   *holes;
 }	Split;
 
+/* Output of the split, growing as polygons are traced */
+typedef struct
+{
+	int			numPolygons;
+	int			numRings;
+	int			numCoords;
+	int			maxPolygons;
+	int			maxRings;
+	int			maxCoords;
+	int		   *polygonRings;
+	int		   *ringCoords;
+	LatLng	   *coords;
+}	SplitOutput;
+
 static bool
 			is_polygon_crossed(const LinkedGeoPolygon * polygon);
 
-static LinkedGeoPolygon *
-			split_polygon(const LinkedGeoPolygon * polygon);
+static bool
+			is_linked_ring_crossed(const LinkedGeoLoop * ring);
 
 static bool
-			is_ring_crossed(const LinkedGeoLoop * ring);
+			is_flat_polygon_crossed(const FlatMultiPolygon * multiPolygon, int polygon);
 
 static void
-			split_init(Split * split, int ringNum, int vertexNum);
+			split_polygon(const FlatMultiPolygon * multiPolygon, int polygon, SplitOutput * output);
+
+static bool
+			is_ring_crossed(const LatLng * coords, int num);
+
+static void
+			split_init(Split * split, const FlatMultiPolygon * input, int ringNum, int vertexNum);
 
 static void
 			split_cleanup(Split * split);
 
 static void
-			split_process_ring(Split * split, const LinkedGeoLoop * ring);
+			split_process_ring(Split * split, const LatLng * coords, int num);
 
 static void
 			split_prepare(Split * split);
 
-static LinkedGeoPolygon *
-			split_create_multi_polygon(Split * split);
+static void
+			split_create_multi_polygon(Split * split, SplitOutput * output);
 
 static int
 			split_add_vertex(Split * split, const LatLng * latlng);
@@ -182,7 +204,7 @@ static void
 			split_link_vertices(Split * split, int idx1, int idx2);
 
 static void
-			split_add_hole(Split * split, const LinkedGeoLoop * hole);
+			split_add_hole(Split * split, int ring);
 
 static
 void		split_sort_intersects(Split * split);
@@ -193,11 +215,11 @@ static int
 static int
 			split_find_next_vertex(const Split * split, int *start);
 
-static LinkedGeoPolygon *
-			split_create_polygon_vertex(Split * split, int vertexIdx);
+static void
+			split_create_polygon_vertex(Split * split, int vertexIdx, SplitOutput * output);
 
 static void
-			split_polygon_assign_holes(Split * split, short sign, LinkedGeoPolygon * polygon);
+			split_polygon_assign_holes(Split * split, short sign, SplitOutput * output);
 
 static const SplitIntersect *
 			split_get_intersect_after(Split * split, int vertexIdx);
@@ -205,11 +227,8 @@ static const SplitIntersect *
 static void
 			split_intersect_get_lat_lng(const SplitIntersect * intersect, short sign, LatLng * latlng);
 
-static int
-			count_polygon_vertices(const LinkedGeoPolygon * polygon, int *ringNum);
-
 static short
-			lat_lng_ring_pos(const LinkedGeoLoop * ring, short sign, const Bbox3 * bbox, const LatLng * latlng);
+			lat_lng_ring_pos(const LatLng * ring, int num, short sign, const Bbox3 * bbox, const LatLng * latlng);
 
 static short
 			segment_intersect(const Vect3 * v1, const Vect3 * v2, const Vect3 * u1, const Vect3 * u2);
@@ -218,7 +237,25 @@ static short
 			point_segment_pos(const Vect3 * v1, const Vect3 * v2, const Vect3 * p);
 
 static void
-			add_lat_lng(LinkedGeoLoop * loop, const LatLng * latlng);
+			output_init(SplitOutput * output, const FlatMultiPolygon * input);
+
+static void
+			output_add_polygon(SplitOutput * output);
+
+static void
+			output_add_ring(SplitOutput * output);
+
+static void
+			output_add_lat_lng(SplitOutput * output, const LatLng * latlng);
+
+static void
+			output_add_ring_copy(SplitOutput * output, const LatLng * coords, int num);
+
+static FlatMultiPolygon *
+			output_finish(SplitOutput * output);
+
+static LinkedGeoPolygon *
+			linked_multi_polygon_from_flat(const FlatMultiPolygon * multiPolygon);
 
 bool
 is_linked_polygon_crossed_by_180(const LinkedGeoPolygon * multiPolygon)
@@ -231,33 +268,59 @@ is_linked_polygon_crossed_by_180(const LinkedGeoPolygon * multiPolygon)
 	return false;
 }
 
-LinkedGeoPolygon *
-split_linked_polygon_by_180(const LinkedGeoPolygon * multiPolygon)
+bool
+is_flat_multi_polygon_crossed_by_180(const FlatMultiPolygon * multiPolygon)
 {
-	LinkedGeoPolygon *result = NULL;
-	LinkedGeoPolygon *last = NULL;
+	for (int polygon = 0; polygon < multiPolygon->numPolygons; polygon++)
+	{
+		if (is_flat_polygon_crossed(multiPolygon, polygon))
+			return true;
+	}
+	return false;
+}
 
-	FOREACH_LINKED_POLYGON(multiPolygon, polygon)
+FlatMultiPolygon *
+split_flat_multi_polygon_by_180(const FlatMultiPolygon * multiPolygon)
+{
+	SplitOutput output;
+
+	output_init(&output, multiPolygon);
+	for (int polygon = 0; polygon < multiPolygon->numPolygons; polygon++)
 	{
 		/* Split or copy next polygon */
-		LinkedGeoPolygon *nextResult = is_polygon_crossed(polygon)
-		? split_polygon(polygon)
-		: copy_linked_geo_polygon(polygon);
-
-		/* Add to result */
-		if (!result)
+		if (is_flat_polygon_crossed(multiPolygon, polygon))
 		{
-			result = nextResult;
-			last = nextResult;
+			split_polygon(multiPolygon, polygon, &output);
+			continue;
 		}
-		else
+
+		output_add_polygon(&output);
+		for (int ring = multiPolygon->polygonRings[polygon];
+			 ring < multiPolygon->polygonRings[polygon + 1];
+			 ring++)
 		{
-			last->next = nextResult;
+			int			start = multiPolygon->ringCoords[ring];
+
+			output_add_ring_copy(&output, &multiPolygon->coords[start],
+								 multiPolygon->ringCoords[ring + 1] - start);
 		}
-		while (last->next)
-			last = last->next;
 	}
 
+	return output_finish(&output);
+}
+
+LinkedGeoPolygon *
+split_linked_polygon_by_180(const LinkedGeoPolygon * multiPolygon)
+{
+	FlatMultiPolygon *flat = flat_multi_polygon_from_linked(multiPolygon);
+	FlatMultiPolygon *split = split_flat_multi_polygon_by_180(flat);
+	LinkedGeoPolygon *result = linked_multi_polygon_from_flat(split);
+
+	pfree(flat);
+	pfree(split->polygonRings);
+	pfree(split->ringCoords);
+	pfree(split->coords);
+	pfree(split);
 	return result;
 }
 
@@ -292,27 +355,63 @@ bool
 is_polygon_crossed(const LinkedGeoPolygon * polygon)
 {
 	return polygon->first
-		? is_ring_crossed(polygon->first)
+		? is_linked_ring_crossed(polygon->first)
 		: false;
 }
 
-LinkedGeoPolygon *
-split_polygon(const LinkedGeoPolygon * polygon)
+bool
+is_linked_ring_crossed(const LinkedGeoLoop * ring)
+{
+	if (!ring->first || !ring->first->next)
+		return false;
+
+	FOREACH_LINKED_LAT_LNG_PAIR(ring, cur, next)
+	{
+		double		lng = cur->vertex.lng;
+		double		nextLng = next->vertex.lng;
+
+		if (SIGN(lng) != SIGN(nextLng)
+			&& fabs(lng - nextLng) > M_PI)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool
+is_flat_polygon_crossed(const FlatMultiPolygon * multiPolygon, int polygon)
+{
+	int			ring = multiPolygon->polygonRings[polygon];
+	int			start;
+
+	if (ring == multiPolygon->polygonRings[polygon + 1])
+		return false;
+
+	start = multiPolygon->ringCoords[ring];
+	return is_ring_crossed(&multiPolygon->coords[start],
+						   multiPolygon->ringCoords[ring + 1] - start);
+}
+
+void
+split_polygon(const FlatMultiPolygon * multiPolygon, int polygon, SplitOutput * output)
 {
-	int			ringNum,
-				vertexNum;
+	int			firstRing = multiPolygon->polygonRings[polygon];
+	int			lastRing = multiPolygon->polygonRings[polygon + 1];
 	Split		split;
-	LinkedGeoPolygon *result;
 
 	/* Init data */
-	vertexNum = count_polygon_vertices(polygon, &ringNum);
-	split_init(&split, ringNum, vertexNum);
+	split_init(&split, multiPolygon, lastRing - firstRing,
+			   multiPolygon->ringCoords[lastRing] - multiPolygon->ringCoords[firstRing]);
 
 	/* Process rings */
-	FOREACH_LINKED_LOOP(polygon, ring)
+	for (int ring = firstRing; ring < lastRing; ring++)
 	{
-		if (ring == polygon->first || is_ring_crossed(ring))
-			split_process_ring(&split, ring);
+		const LatLng *coords = &multiPolygon->coords[multiPolygon->ringCoords[ring]];
+		int			num = multiPolygon->ringCoords[ring + 1] - multiPolygon->ringCoords[ring];
+
+		if (ring == firstRing || is_ring_crossed(coords, num))
+			split_process_ring(&split, coords, num);
 		else
 			split_add_hole(&split, ring);
 	}
@@ -321,24 +420,22 @@ split_polygon(const LinkedGeoPolygon * polygon)
 	split_prepare(&split);
 
 	/* Build result */
-	result = split_create_multi_polygon(&split);
+	split_create_multi_polygon(&split, output);
 
 	/* Cleanup */
 	split_cleanup(&split);
-
-	return result;
 }
 
 bool
-is_ring_crossed(const LinkedGeoLoop * ring)
+is_ring_crossed(const LatLng * coords, int num)
 {
-	if (!ring->first || !ring->first->next)
+	if (num < 2)
 		return false;
 
-	FOREACH_LINKED_LAT_LNG_PAIR(ring, cur, next)
+	for (int i = 0; i < num; i++)
 	{
-		double		lng = cur->vertex.lng;
-		double		nextLng = next->vertex.lng;
+		double		lng = coords[i].lng;
+		double		nextLng = coords[(i + 1) % num].lng;
 
 		if (SIGN(lng) != SIGN(nextLng)
 			&& fabs(lng - nextLng) > M_PI)
@@ -351,20 +448,21 @@ is_ring_crossed(const LinkedGeoLoop * ring)
 
 
 void
-split_init(Split * split, int ringNum, int vertexNum)
+split_init(Split * split, const FlatMultiPolygon * input, int ringNum, int vertexNum)
 {
 	*split = (Split)
 	{
 		0
 	};
 
+	split->input = input;
 	split->vertices = palloc0(vertexNum * sizeof(SplitVertex));
 
 	split->maxIntersectNum = INTERSECT_ARRAY_SIZE_INIT;
 	split->intersects = palloc0(split->maxIntersectNum * sizeof(SplitIntersect));
 
 	if (ringNum > 1)
-		split->holes = palloc0((ringNum - 1) * sizeof(LinkedGeoLoop *));
+		split->holes = palloc0((ringNum - 1) * sizeof(int));
 }
 
 void
@@ -386,27 +484,29 @@ split_cleanup(Split * split)
 }
 
 void
-split_process_ring(Split * split, const LinkedGeoLoop * ring)
+split_process_ring(Split * split, const LatLng * coords, int num)
 {
 	short		sign = 0;
 	int			vertexIdx = -1;
 	int			firstVertexIdx = -1;
 
-	SPLIT_ASSERT(ring->first && ring->first->next, "polygon ring must have at least 2 vertices");
+	SPLIT_ASSERT(num >= 2, "polygon ring must have at least 2 vertices");
 
-	FOREACH_LINKED_LAT_LNG_PAIR(ring, cur, next)
+	for (int i = 0; i < num; i++)
 	{
+		const LatLng *cur = &coords[i];
+		const LatLng *next = &coords[(i + 1) % num];
 		double		lng,
 					nextLng;
 		short		nextSign;
 
 		/* Add vertex */
-		vertexIdx = split_add_vertex(split, &cur->vertex);
+		vertexIdx = split_add_vertex(split, cur);
 		if (firstVertexIdx < 0)
 			firstVertexIdx = vertexIdx;
 
-		lng = cur->vertex.lng;
-		nextLng = next->vertex.lng;
+		lng = cur->lng;
+		nextLng = next->lng;
 		nextSign = SIGN(nextLng);
 
 		if (sign == 0)
@@ -431,7 +531,7 @@ split_process_ring(Split * split, const LinkedGeoLoop * ring)
 			/* Add intersection after current vertex */
 			SplitIntersectDir dir = (sign < 0) ? SplitIntersectDir_WE : SplitIntersectDir_EW;
 			int			isPrime = (fabs(lng - nextLng) < M_PI);
-			double		lat = split_180_lat(&cur->vertex, &next->vertex);
+			double		lat = split_180_lat(cur, next);
 
 			split_add_intersect_after(split, vertexIdx, dir, isPrime, lat);
 
@@ -449,17 +549,13 @@ split_prepare(Split * split)
 	split_sort_intersects(split);
 }
 
-LinkedGeoPolygon *
-split_create_multi_polygon(Split * split)
+void
+split_create_multi_polygon(Split * split, SplitOutput * output)
 {
-	LinkedGeoPolygon *multiPolygon = NULL;
-	LinkedGeoPolygon *lastPolygon = NULL;
 	int			vertexIdxStart = 0;
 
 	while (true)
 	{
-		LinkedGeoPolygon *polygon;
-
 		/* Get next unused vertex */
 		int			vertexIdx = split_find_next_vertex(split, &vertexIdxStart);
 
@@ -467,17 +563,8 @@ split_create_multi_polygon(Split * split)
 			break;				/* done */
 
 		/* Create next polygon */
-		polygon = split_create_polygon_vertex(split, vertexIdx);
-
-		/* Add to result */
-		if (!multiPolygon)
-			multiPolygon = polygon;
-		else
-			lastPolygon->next = polygon;
-		lastPolygon = polygon;
+		split_create_polygon_vertex(split, vertexIdx, output);
 	}
-
-	return multiPolygon;
 }
 
 int
@@ -541,9 +628,9 @@ split_link_vertices(Split * split, int idx1, int idx2)
 }
 
 void
-split_add_hole(Split * split, const LinkedGeoLoop * hole)
+split_add_hole(Split * split, int ring)
 {
-	split->holes[split->holeNum++] = hole;
+	split->holes[split->holeNum++] = ring;
 }
 
 void
@@ -618,11 +705,9 @@ split_find_next_vertex(const Split * split, int *start)
 	return -1;
 }
 
-LinkedGeoPolygon *
-split_create_polygon_vertex(Split * split, int vertexIdx)
+void
+split_create_polygon_vertex(Split * split, int vertexIdx, SplitOutput * output)
 {
-	LinkedGeoPolygon *polygon;
-	LinkedGeoLoop *loop;
 	int			idx,
 				nextIdx,
 				intersectIdx;
@@ -631,10 +716,8 @@ split_create_polygon_vertex(Split * split, int vertexIdx)
 	short		sign,
 				step;
 
-	polygon = palloc0(sizeof(LinkedGeoPolygon));
-
-	loop = palloc0(sizeof(LinkedGeoLoop));
-	add_linked_geo_loop(polygon, loop);
+	output_add_polygon(output);
+	output_add_ring(output);
 
 	idx = vertexIdx;
 	vertex = &split->vertices[idx];
@@ -643,7 +726,7 @@ split_create_polygon_vertex(Split * split, int vertexIdx)
 	while (vertex->latlngPtr)
 	{
 		/* Add vertex */
-		add_lat_lng(loop, vertex->latlngPtr);
+		output_add_lat_lng(output, vertex->latlngPtr);
 		vertex->latlngPtr = NULL;
 
 		/*
@@ -673,7 +756,7 @@ split_create_polygon_vertex(Split * split, int vertexIdx)
 
 			/* Add intersection vertex */
 			split_intersect_get_lat_lng(intersect, sign, &latlng);
-			add_lat_lng(loop, &latlng);
+			output_add_lat_lng(output, &latlng);
 
 			/* Find next intersection */
 			intersectSortOrder = (intersect->sortOrder % 2 == 0)
@@ -684,7 +767,7 @@ split_create_polygon_vertex(Split * split, int vertexIdx)
 
 			/* Add next intersection vertex */
 			split_intersect_get_lat_lng(intersect, sign, &latlng);
-			add_lat_lng(loop, &latlng);
+			output_add_lat_lng(output, &latlng);
 
 			/*
 			 * Does intersecting segment end in the same hemisphere where the
@@ -713,33 +796,39 @@ split_create_polygon_vertex(Split * split, int vertexIdx)
 	}
 
 	/* Assign holes */
-	split_polygon_assign_holes(split, sign, polygon);
-
-	return polygon;
+	split_polygon_assign_holes(split, sign, output);
 }
 
+/* Adds the non-split holes inside the outer ring just traced to its polygon */
 void
-split_polygon_assign_holes(Split * split, short sign, LinkedGeoPolygon * polygon)
+split_polygon_assign_holes(Split * split, short sign, SplitOutput * output)
 {
-	const LinkedGeoLoop *outerLoop;
+	const FlatMultiPolygon *input = split->input;
+	int			outerStart = output->ringCoords[output->numRings - 1];
+	int			outerNum = output->numCoords - outerStart;
 	Bbox3		bbox;
 
-	outerLoop = polygon->first;
-	bbox3_from_linked_loop(outerLoop, &bbox);
+	bbox3_from_ring(&output->coords[outerStart], outerNum, &bbox);
 
 	for (int i = 0; i < split->holeNum; ++i)
 	{
-		const LinkedGeoLoop *hole;
+		int			ring = split->holes[i];
+		const LatLng *hole;
+		int			holeNum;
 		short		pos = 0;
 
-		hole = split->holes[i];
-		if (!hole)
+		if (ring < 0)
 			continue;
 
+		hole = &input->coords[input->ringCoords[ring]];
+		holeNum = input->ringCoords[ring + 1] - input->ringCoords[ring];
+
 		/* Check if hole vertices are inside the outher shell of the polygon */
-		FOREACH_LINKED_LAT_LNG(hole, cur)
+		for (int j = 0; j < holeNum; j++)
 		{
-			pos = lat_lng_ring_pos(outerLoop, sign, &bbox, &cur->vertex);
+			/* adding holes may move the output coordinates */
+			pos = lat_lng_ring_pos(&output->coords[outerStart], outerNum,
+								   sign, &bbox, &hole[j]);
 			if (pos != 0)
 				break;			/* vertex is either inside or outside */
 		}
@@ -747,12 +836,10 @@ split_polygon_assign_holes(Split * split, short sign, LinkedGeoPolygon * polygon
 		if (pos != -1)
 		{
 			/* Add hole loop copy to polygon */
-			LinkedGeoLoop *hole_copy = copy_linked_geo_loop(hole);
-
-			add_linked_geo_loop(polygon, hole_copy);
+			output_add_ring_copy(output, hole, holeNum);
 
 			/* Remove hole from the list */
-			split->holes[i] = NULL;
+			split->holes[i] = -1;
 		}
 	}
 }
@@ -780,25 +867,8 @@ split_intersect_get_lat_lng(const SplitIntersect * intersect, short sign, LatLng
 		latlng->lng = (sign > 0) ? M_PI : -M_PI;
 }
 
-int
-count_polygon_vertices(const LinkedGeoPolygon * polygon, int *ringNum)
-{
-	int			num = 0;
-
-	if (ringNum)
-		*ringNum = 0;
-
-	FOREACH_LINKED_LOOP(polygon, ring)
-	{
-		if (ringNum)
-			++(*ringNum);
-		num += count_linked_lat_lng(ring);
-	}
-	return num;
-}
-
 short
-lat_lng_ring_pos(const LinkedGeoLoop * ring, short sign, const Bbox3 * bbox, const LatLng * latlng)
+lat_lng_ring_pos(const LatLng * ring, int num, short sign, const Bbox3 * bbox, const LatLng * latlng)
 {
 	short		signLatlng;
 	Vect3		vect,
@@ -826,7 +896,7 @@ lat_lng_ring_pos(const LinkedGeoLoop * ring, short sign, const Bbox3 * bbox, con
 
 
 	/* Check if ring is a single vertex exactly matching the point */
-	if (!ring->first->next)
+	if (num < 2)
 		return true;
 
 	/*
@@ -834,15 +904,15 @@ lat_lng_ring_pos(const LinkedGeoLoop * ring, short sign, const Bbox3 * bbox, con
 	 * segment
 	 */
 	intersectNum = 0;
-	vect3_from_lat_lng(&ring->first->vertex, &curVect);
-	FOREACH_LINKED_LAT_LNG_PAIR(ring, cur, next)
+	vect3_from_lat_lng(&ring[0], &curVect);
+	for (int i = 0; i < num; i++)
 	{
 		/* Check if point matches ring vertex */
 		if (vect3_eq(&vect, &curVect))
 			return 0;
 
 		/* Next vertex */
-		vect3_from_lat_lng(&next->vertex, &nextVect);
+		vect3_from_lat_lng(&ring[(i + 1) % num], &nextVect);
 
 		if (!vect3_eq(&curVect, &nextVect))
 		{
@@ -985,21 +1055,125 @@ point_segment_pos(const Vect3 * v1, const Vect3 * v2, const Vect3 * p)
 }
 
 void
-add_lat_lng(LinkedGeoLoop * loop, const LatLng * latlng)
+output_init(SplitOutput * output, const FlatMultiPolygon * input)
+{
+	/* room for a few split parts, grown as needed */
+	output->numPolygons = 0;
+	output->numRings = 0;
+	output->numCoords = 0;
+	output->maxPolygons = input->numPolygons + 4;
+	output->maxRings = input->numRings + 4;
+	output->maxCoords = input->ringCoords[input->numRings] + 16;
+	output->polygonRings = palloc(sizeof(int) * (output->maxPolygons + 1));
+	output->ringCoords = palloc(sizeof(int) * (output->maxRings + 1));
+	output->coords = palloc_extended(sizeof(LatLng) * output->maxCoords, MCXT_ALLOC_HUGE);
+}
+
+void
+output_add_polygon(SplitOutput * output)
+{
+	if (output->numPolygons == output->maxPolygons)
+	{
+		output->maxPolygons *= 2;
+		output->polygonRings = repalloc(output->polygonRings,
+										sizeof(int) * (output->maxPolygons + 1));
+	}
+	output->polygonRings[output->numPolygons++] = output->numRings;
+}
+
+void
+output_add_ring(SplitOutput * output)
 {
-	LinkedLatLng *linked;
+	if (output->numRings == output->maxRings)
+	{
+		output->maxRings *= 2;
+		output->ringCoords = repalloc(output->ringCoords,
+									  sizeof(int) * (output->maxRings + 1));
+	}
+	output->ringCoords[output->numRings++] = output->numCoords;
+}
 
-	if (loop->last)
+void
+output_add_lat_lng(SplitOutput * output, const LatLng * latlng)
+{
+	if (output->numCoords > output->ringCoords[output->numRings - 1])
 	{
 		/* Does new vertex exactly match the last one? */
-		const LatLng *last = &loop->last->vertex;
+		const LatLng *last = &output->coords[output->numCoords - 1];
 
 		if (last->lat == latlng->lat && last->lng == latlng->lng)
 			return;
 	}
 
-	linked = palloc0(sizeof(LinkedLatLng));
-	linked->vertex.lat = latlng->lat;
-	linked->vertex.lng = latlng->lng;
-	add_linked_lat_lng(loop, linked);
+	if (output->numCoords == output->maxCoords)
+	{
+		output->maxCoords *= 2;
+		output->coords = repalloc_huge(output->coords, sizeof(LatLng) * output->maxCoords);
+	}
+	output->coords[output->numCoords++] = *latlng;
+}
+
+void
+output_add_ring_copy(SplitOutput * output, const LatLng * coords, int num)
+{
+	output_add_ring(output);
+	if (output->numCoords + num > output->maxCoords)
+	{
+		output->maxCoords = Max(output->maxCoords * 2, output->numCoords + num);
+		output->coords = repalloc_huge(output->coords, sizeof(LatLng) * output->maxCoords);
+	}
+	memcpy(&output->coords[output->numCoords], coords, sizeof(LatLng) * num);
+	output->numCoords += num;
+}
+
+FlatMultiPolygon *
+output_finish(SplitOutput * output)
+{
+	FlatMultiPolygon *flat = palloc(sizeof(FlatMultiPolygon));
+
+	output->polygonRings[output->numPolygons] = output->numRings;
+	output->ringCoords[output->numRings] = output->numCoords;
+
+	flat->numPolygons = output->numPolygons;
+	flat->numRings = output->numRings;
+	flat->polygonRings = output->polygonRings;
+	flat->ringCoords = output->ringCoords;
+	flat->coords = output->coords;
+	return flat;
+}
+
+LinkedGeoPolygon *
+linked_multi_polygon_from_flat(const FlatMultiPolygon * multiPolygon)
+{
+	LinkedGeoPolygon *result = NULL;
+	LinkedGeoPolygon *last = NULL;
+
+	for (int polygon = 0; polygon < multiPolygon->numPolygons; polygon++)
+	{
+		LinkedGeoPolygon *linked = palloc0(sizeof(LinkedGeoPolygon));
+
+		for (int ring = multiPolygon->polygonRings[polygon];
+			 ring < multiPolygon->polygonRings[polygon + 1];
+			 ring++)
+		{
+			LinkedGeoLoop *loop = palloc0(sizeof(LinkedGeoLoop));
+
+			for (int i = multiPolygon->ringCoords[ring]; i < multiPolygon->ringCoords[ring + 1]; i++)
+			{
+				LinkedLatLng *latlng = palloc0(sizeof(LinkedLatLng));
+
+				latlng->vertex = multiPolygon->coords[i];
+				add_linked_lat_lng(loop, latlng);
+			}
+			add_linked_geo_loop(linked, loop);
+		}
+
+		if (!result)
+			result = linked;
+		else
+			last->next = linked;
+		last = linked;
+	}
+
+	return result;
 }
@@ -22,13 +22,22 @@
 #include <stdbool.h>
 
 #include "error.h"
+#include "wkb.h"
 
 bool
 			is_linked_polygon_crossed_by_180(const LinkedGeoPolygon * multiPolygon);
 
+/* Splits the linked polygons by going through their flat layout */
 LinkedGeoPolygon *
 			split_linked_polygon_by_180(const LinkedGeoPolygon * multiPolygon);
 
+/* Coordinates in radians */
+bool
+			is_flat_multi_polygon_crossed_by_180(const FlatMultiPolygon * multiPolygon);
+
+FlatMultiPolygon *
+			split_flat_multi_polygon_by_180(const FlatMultiPolygon * multiPolygon);
+
 double
 			split_180_lat(const LatLng * coord1, const LatLng * coord2);
 
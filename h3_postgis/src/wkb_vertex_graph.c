@@ -237,8 +237,6 @@ findNodeForEdge(const VertexGraph *graph, const LatLng *fromVtx,
 static uint32_t
 hash_vertex(const VertexGraph *graph, const LatLng *vertex)
 {
-	uint64_t	latHash;
-	uint64_t	lngHash;
 	int64_t		lat;
 	int64_t		lng;
 
@@ -254,11 +252,17 @@ hash_vertex(const VertexGraph *graph, const LatLng *vertex)
 	 */
 	lat = (int64_t) llround(vertex->lat * graph->resMultiplier);
 	lng = (int64_t) llround(vertex->lng * graph->resMultiplier);
-	latHash = mix_uint64((uint64_t) lat);
-	lngHash = mix_uint64((uint64_t) lng);
-	return (uint32_t) ((latHash ^ (lngHash + UINT64_C(0x9e3779b97f4a7c15)
-								   + (latHash << 6) + (latHash >> 2)))
-					   % (uint64_t) graph->numBuckets);
+	return (uint32_t) (hashVertexCell(lat, lng) % (uint64_t) graph->numBuckets);
+}
+
+uint64_t
+hashVertexCell(int64_t lat, int64_t lng)
+{
+	uint64_t	latHash = mix_uint64((uint64_t) lat);
+	uint64_t	lngHash = mix_uint64((uint64_t) lng);
+
+	return latHash ^ (lngHash + UINT64_C(0x9e3779b97f4a7c15)
+					  + (latHash << 6) + (latHash >> 2));
 }
 
 static uint64_t
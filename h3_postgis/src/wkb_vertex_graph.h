@@ -59,4 +59,10 @@ int removeVertexNode(VertexGraph *graph, VertexNode *node);
 VertexNode *findNodeForEdge(const VertexGraph *graph, const LatLng *fromVtx,
 							const LatLng *toVtx);
 
+/*
+ * Hash of a vertex quantized to integer grid coordinates, shared with the
+ * polygonizer's vertex lookup.
+ */
+uint64_t hashVertexCell(int64_t lat, int64_t lng);
+
 #endif
@@ -330,6 +330,33 @@ FROM (
 ) AS q2
 WHERE ABS(ABS(ST_X(p)) - 180) < :epsilon;
 
+--
+-- Test h3_cell_to_tile_wkb
+--
+
+-- matches PostGIS tile geometry
+SELECT ST_HausdorffDistance(
+    h3_cell_to_tile_geometry(:hexagon, 16, 42901, 30456),
+    ST_AsMVTGeom(ST_Transform(h3_cell_to_boundary_geometry(:hexagon), 3857), ST_TileEnvelope(16, 42901, 30456))
+) <= 1;
+
+-- with the same orientation
+SELECT ST_IsPolygonCCW(h3_cell_to_tile_geometry(:hexagon, 16, 42901, 30456))
+    = ST_IsPolygonCCW(ST_AsMVTGeom(ST_Transform(h3_cell_to_boundary_geometry(:hexagon), 3857), ST_TileEnvelope(16, 42901, 30456)));
+
+-- cells outside the tile are skipped
+SELECT h3_cell_to_tile_wkb(:hexagon, 16, 0, 0) IS NULL;
+
+-- edgecrossing cells show up on both sides of the antimeridian
+SELECT ST_IsValid(h3_cell_to_tile_geometry(:edgecross, 2, 0, 0))
+   AND ST_IsValid(h3_cell_to_tile_geometry(:edgecross, 2, 3, 0));
+
+-- polar cells reach the edge of the world
+SELECT ST_YMax(h3_cell_to_tile_geometry(:polar, 0, 0, 0)) = 4096 + 256;
+
+-- the tile must exist
+SELECT h3_cell_to_tile_wkb(:hexagon, 1, 2, 0);
+
 --
 -- Test h3_cells_to_multi_polygon_wkb
 --
@@ -462,6 +489,59 @@ SELECT ST_IsValid(h3_cells_to_multi_polygon_geometry(arr))
    AND ST_IsEmpty(ST_Difference((SELECT tile FROM tile), h3_cells_to_multi_polygon_geometry(arr)))
 FROM cells;
 
+--
+-- Test TWKB output
+--
+
+-- same encoding as PostGIS
+SELECT h3_cell_to_boundary_twkb(:hexagon) = ST_AsTWKB(h3_cell_to_boundary_geometry(:hexagon), 6);
+
+-- rings of tiny cells keep their minimum points at a low precision, like PostGIS
+SELECT ST_NPoints(ST_GeomFromTWKB(h3_cell_to_boundary_twkb(h3_cell_to_center_child(:hexagon, 15), 0))) >= 4
+   AND h3_cell_to_boundary_twkb(h3_cell_to_center_child(:hexagon, 15), 0)
+       = ST_AsTWKB(h3_cell_to_boundary_geometry(h3_cell_to_center_child(:hexagon, 15)), 0);
+
+-- edgecrossing cells are split like WKB
+SELECT GeometryType(ST_GeomFromTWKB(h3_cell_to_boundary_twkb(:edgecross))) = 'MULTIPOLYGON'
+   AND ST_HausdorffDistance(
+       ST_GeomFromTWKB(h3_cell_to_boundary_twkb(:edgecross)),
+       ST_SetSRID(h3_cell_to_boundary_geometry(:edgecross), 0)) < 1e-6;
+
+-- dissolved outlines match WKB at a fraction of the size
+WITH cells AS (
+    SELECT array(SELECT h3_polygon_to_cells(:transmeridianWithHoles, 4)) AS arr
+)
+SELECT ST_HausdorffDistance(
+           ST_GeomFromTWKB(h3_cells_to_multi_polygon_twkb(arr)),
+           ST_SetSRID(h3_cells_to_multi_polygon_geometry(arr), 0)) < 1e-6
+   AND octet_length(h3_cells_to_multi_polygon_twkb(arr)) * 2
+       < octet_length(h3_cells_to_multi_polygon_wkb(arr))
+FROM cells;
+
+-- precision is limited to what TWKB can encode
+SELECT h3_cell_to_boundary_twkb(:hexagon, 8);
+
+--
+-- Test h3_cells_to_geojson_agg
+--
+
+-- one feature per cell, matching its geometry and carrying its properties
+WITH collection AS (
+    SELECT h3_cells_to_geojson_agg(h3, jsonb_build_object('cell', h3)) AS fc
+    FROM (VALUES (:hexagon::h3index), (:edgecross), (NULL)) v(h3)
+),
+features AS (SELECT json_array_elements(fc->'features') AS f FROM collection)
+SELECT COUNT(*) = 2
+   AND BOOL_AND((f->>'id')::h3index = (f->'properties'->>'cell')::h3index)
+   AND BOOL_AND(ST_HausdorffDistance(
+       ST_GeomFromGeoJSON(f->>'geometry'),
+       h3_cell_to_boundary_geometry((f->>'id')::h3index)) < 1e-8)
+FROM features;
+
+-- no cells give an empty collection
+SELECT h3_cells_to_geojson_agg(h3, NULL)
+FROM (VALUES (:hexagon::h3index)) v(h3) WHERE false;
+
 -- h3_polygon_to_cells_experimental
 SELECT COUNT(*) = 48 FROM (
     SELECT h3_polygon_to_cells_experimental(:with2holes, 10, 'center')
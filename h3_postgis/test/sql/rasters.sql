@@ -140,6 +140,100 @@ WHERE c.count IS NULL
    OR s.stats IS NULL
    OR NOT h3_test_equal(c.count, (s.stats).count);
 
+-- Pixel fractions from `h3_raster_summary_coverage` should add up to whole
+-- pixels, and weighted sums to raster totals.
+WITH
+    coverage AS (
+        SELECT
+            sum((stats).count) AS count,
+            sum((stats).sum) AS sum
+        FROM (
+            SELECT (h3_raster_summary_coverage(r.rast, :resolution)).*
+            FROM h3_test_rasters r
+        ) t
+    ),
+    totals AS (
+        SELECT
+            sum((ST_SummaryStats(rast)).count) AS count,
+            sum((ST_SummaryStats(rast)).sum) AS sum
+        FROM h3_test_rasters
+    )
+SELECT ABS(c.count - t.count) < 1e-9 AND ABS(c.sum - t.sum) < 1e-9
+FROM coverage c, totals t;
+
+-- Class summary and summary stats (coverage) should agree on per-cell pixel
+-- counts.
+WITH
+    class_coverage AS (
+        SELECT
+            h3,
+            sum((summary).count) AS count
+        FROM (
+            SELECT (h3_raster_class_summary_coverage(r.rast, :resolution)).*
+            FROM h3_test_rasters r
+        ) t
+        GROUP BY 1
+    ),
+    stats_coverage AS (
+        SELECT
+            h3,
+            sum((stats).count) AS count
+        FROM (
+            SELECT (h3_raster_summary_coverage(r.rast, :resolution)).*
+            FROM h3_test_rasters r
+        ) t
+        GROUP BY 1
+    )
+SELECT COUNT(*)
+FROM class_coverage c FULL OUTER JOIN stats_coverage s ON c.h3 = s.h3
+WHERE c.count IS NULL
+   OR s.count IS NULL
+   OR ABS(c.count - s.count) > 1e-9;
+
+-- Class coverage areas of a non-4326 raster should add up to the area of its
+-- footprint.
+WITH
+    rast AS (
+        SELECT ST_Transform(rast, 3857) AS rast
+        FROM h3_test_rasters WHERE id = 1
+    ),
+    coverage AS (
+        SELECT sum((summary).area) AS area
+        FROM (
+            SELECT (h3_raster_class_summary_coverage(rast, :resolution)).*
+            FROM rast
+        ) t
+    )
+SELECT ABS(c.area / ST_Area(ST_Transform(ST_Envelope(r.rast), 4326)::geography) - 1) < 0.05
+FROM coverage c, rast r;
+
+-- Pixels of `h3_cells_to_raster` should get the value of the cell containing
+-- their center.
+WITH
+    rast AS (
+        SELECT rast FROM h3_test_rasters WHERE id = 1
+    ),
+    cells AS (
+        SELECT (h3_raster_summary_centroids(rast, :resolution)).*
+        FROM rast
+    ),
+    exported AS (
+        SELECT h3_cells_to_raster(
+            (SELECT array_agg(h3 ORDER BY h3) FROM cells),
+            (SELECT array_agg((stats).mean ORDER BY h3) FROM cells),
+            rast
+        ) AS rast
+        FROM rast
+    )
+SELECT
+    COUNT(*) = :raster_size * :raster_size
+    AND bool_and(h3_test_equal(p.val, (c.stats).mean))
+FROM
+    exported e,
+    ST_PixelAsCentroids(e.rast) p,
+    cells c
+WHERE c.h3 = h3_latlng_to_cell(p.geom, :resolution);
+
 DROP FUNCTION h3_test_raster_class_summary_item_equal(
     h3_raster_class_summary_item,
     h3_raster_class_summary_item);
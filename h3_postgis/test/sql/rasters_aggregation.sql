@@ -107,6 +107,75 @@ WITH
 SELECT h3_test_raster_summary_stats_equal(s1.stats, s2.stats)
 FROM summary1 s1, summary2 s2;
 
+-- Stats aggregation stability check:
+-- merging summaries of values with a large offset and a small spread should
+-- keep the standard deviation of the merged values.
+SELECT h3_test_equal(
+    (h3_raster_summary_stats_agg(ROW(1, v, v, 0, v, v)::h3_raster_summary_stats)).stddev,
+    stddev_pop(v))
+FROM (
+    SELECT 1e9 + x / 4.0 AS v
+    FROM generate_series(1, 8) x
+) t;
+
+-- Parallel aggregation check:
+-- partial states combined from parallel workers should give the serial result.
+CREATE TABLE h3_test_raster_parts AS
+SELECT
+    ROW(1, v, v, 0, v, v)::h3_raster_summary_stats AS stats,
+    ROW(1, 1, v)::h3_raster_class_summary_item AS item
+FROM (
+    SELECT 1e3 + (x % 97) / 4.0 AS v
+    FROM generate_series(1, 10000) x
+) t;
+
+CREATE FUNCTION h3_test_plan(query text)
+RETURNS SETOF text
+AS $$
+BEGIN
+    RETURN QUERY EXECUTE 'EXPLAIN (COSTS OFF) ' || query;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TABLE h3_test_raster_serial AS
+SELECT
+    h3_raster_summary_stats_agg(stats) AS stats,
+    h3_raster_class_summary_item_agg(item) AS item
+FROM h3_test_raster_parts;
+
+SET max_parallel_workers_per_gather TO 2;
+SET parallel_setup_cost TO 0;
+SET parallel_tuple_cost TO 0;
+SET min_parallel_table_scan_size TO 0;
+
+SELECT bool_or(plan LIKE '%Partial Aggregate%')
+   AND bool_or(plan LIKE '%Finalize Aggregate%')
+FROM h3_test_plan('
+    SELECT
+        h3_raster_summary_stats_agg(stats),
+        h3_raster_class_summary_item_agg(item)
+    FROM h3_test_raster_parts') plan;
+
+SELECT h3_test_raster_summary_stats_equal(p.stats, s.stats)
+   AND (p.item).val = (s.item).val
+   AND h3_test_equal((p.item).count, (s.item).count)
+   AND h3_test_equal((p.item).area, (s.item).area)
+FROM (
+    SELECT
+        h3_raster_summary_stats_agg(stats) AS stats,
+        h3_raster_class_summary_item_agg(item) AS item
+    FROM h3_test_raster_parts
+) p, h3_test_raster_serial s;
+
+RESET min_parallel_table_scan_size;
+RESET parallel_tuple_cost;
+RESET parallel_setup_cost;
+SET max_parallel_workers_per_gather TO 0;
+
+DROP FUNCTION h3_test_plan(text);
+DROP TABLE h3_test_raster_serial;
+DROP TABLE h3_test_raster_parts;
+
 DROP FUNCTION h3_test_raster_summary_stats_equal(
     h3_raster_summary_stats,
     h3_raster_summary_stats);
@@ -54,6 +54,33 @@ SELECT count(*) FILTER (WHERE NOT ST_IsValid(g)) = 0
    ) = 0
 FROM buffered_geoms;
 
+-- Same sweep for the native tile cover, with and without margin.
+WITH native_tiles AS (
+    SELECT z::int AS z, x::int AS x, y::int AS y, margin,
+           ST_Transform(ST_TileEnvelope(z::int, x::int, y::int, margin => margin), 4326) AS tile,
+           h3_get_resolution_from_tile_zoom(z::int) AS res
+    FROM generate_series(0, 8) AS z
+    CROSS JOIN LATERAL generate_series(0, (1 << z) - 1) AS x
+    CROSS JOIN LATERAL generate_series(0, (1 << z) - 1) AS y
+    CROSS JOIN (VALUES (0.0), (0.125)) AS m(margin)
+),
+native_cells AS (
+    SELECT z, x, y, tile, array_agg(h3 ORDER BY h3) AS arr
+    FROM native_tiles,
+         h3_tile_to_cells(z, x, y, res, margin) AS h3
+    GROUP BY z, x, y, margin, tile
+),
+native_geoms AS (
+    SELECT z, x, y, tile, h3_cells_to_multi_polygon_geometry(arr) AS g
+    FROM native_cells
+)
+SELECT count(*) FILTER (WHERE NOT ST_IsValid(g)) = 0
+   AND count(*) FILTER (
+        WHERE ST_IsValid(g)
+          AND NOT ST_IsEmpty(ST_Difference(tile, g))
+   ) = 0
+FROM native_geoms;
+
 -- Exhaustive coverage/validity sweep for linear EPSG:4326 tiles.
 WITH plain_4326_tiles AS (
     SELECT z::int AS z,
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+
+#include <math.h>
+
+#include <fmgr.h>		   // find_rendezvous_variable
+#include <utils/memutils.h> // TopMemoryContext
+
+#include "cell_cache.h"
+
+/* Each module links its own copy, all of them point at h3's state */
+static H3CellCacheState **rendezvous = NULL;
+
+/* Drops all entries, keeping the counters */
+static void
+cache_clear(H3CellCacheState * state)
+{
+	if (state->context == NULL)
+		return;
+
+	MemoryContextDelete(state->context);
+	state->context = NULL;
+	state->entries = NULL;
+	dlist_init(&state->lru);
+}
+
+/* Evicts the least recently used entries until at most limit are left */
+static void
+cache_evict(H3CellCacheState * state, long limit)
+{
+	while (hash_get_num_entries(state->entries) > limit)
+	{
+		H3CellCacheEntry *victim =
+		dlist_tail_element(H3CellCacheEntry, lru, &state->lru);
+
+		dlist_delete(&victim->lru);
+		hash_search(state->entries, &victim->cell, HASH_REMOVE, NULL);
+		state->evictions++;
+	}
+}
+
+/* Applies a lowered h3.cell_cache_size */
+static void
+cache_trim(H3CellCacheState * state)
+{
+	if (*state->capacity <= 0)
+		cache_clear(state);
+	else if (state->entries != NULL)
+		cache_evict(state, *state->capacity);
+}
+
+/* Returns the cache, or NULL when it is unavailable or disabled */
+static H3CellCacheState *
+cache_state(void)
+{
+	H3CellCacheState *state;
+
+	if (rendezvous == NULL)
+		rendezvous = (H3CellCacheState **) find_rendezvous_variable(H3_CELL_CACHE_RENDEZVOUS);
+
+	state = *rendezvous;
+	if (state == NULL)
+		return NULL;
+
+	cache_trim(state);
+	return *state->capacity > 0 ? state : NULL;
+}
+
+static H3CellCacheEntry *
+cache_lookup(H3CellCacheState * state, H3Index cell)
+{
+	H3CellCacheEntry *entry;
+
+	if (state->entries == NULL)
+		return NULL;
+
+	entry = hash_search(state->entries, &cell, HASH_FIND, NULL);
+	if (entry != NULL)
+		dlist_move_head(&state->lru, &entry->lru);
+	return entry;
+}
+
+/* Adds an empty entry for the cell, evicting the least recently used ones */
+static H3CellCacheEntry *
+cache_insert(H3CellCacheState * state, H3Index cell)
+{
+	H3CellCacheEntry *entry;
+
+	if (state->entries == NULL)
+	{
+		HASHCTL		ctl;
+
+		state->context = AllocSetContextCreate(TopMemoryContext,
+											   "h3 cell cache",
+											   ALLOCSET_DEFAULT_SIZES);
+		ctl.keysize = sizeof(H3Index);
+		ctl.entrysize = sizeof(H3CellCacheEntry);
+		ctl.hcxt = state->context;
+		state->entries = hash_create("h3 cell cache", 256, &ctl,
+									 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+		dlist_init(&state->lru);
+	}
+
+	cache_evict(state, *state->capacity - 1);
+
+	entry = hash_search(state->entries, &cell, HASH_ENTER, NULL);
+	entry->hasBoundary = false;
+	for (int i = 0; i < H3_CELL_AREA_UNITS; i++)
+		entry->area[i] = NAN;
+	dlist_push_head(&state->lru, &entry->lru);
+	return entry;
+}
+
+H3Error
+h3_cell_to_boundary_cached(H3Index cell, CellBoundary * boundary)
+{
+	H3CellCacheState *state = cache_state();
+	H3CellCacheEntry *entry;
+	H3Error		error;
+
+	if (state == NULL)
+		return cellToBoundary(cell, boundary);
+
+	entry = cache_lookup(state, cell);
+	if (entry != NULL && entry->hasBoundary)
+	{
+		state->hits++;
+		*boundary = entry->boundary;
+		return E_SUCCESS;
+	}
+
+	state->misses++;
+	error = cellToBoundary(cell, boundary);
+	if (error)
+		return error;
+
+	if (entry == NULL)
+		entry = cache_insert(state, cell);
+	entry->boundary = *boundary;
+	entry->hasBoundary = true;
+	return E_SUCCESS;
+}
+
+static H3Error
+cell_area(H3Index cell, H3CellAreaUnit unit, double *area)
+{
+	switch (unit)
+	{
+		case H3_CELL_AREA_RADS2:
+			return cellAreaRads2(cell, area);
+		case H3_CELL_AREA_KM2:
+			return cellAreaKm2(cell, area);
+		case H3_CELL_AREA_M2:
+			return cellAreaM2(cell, area);
+		default:
+			return E_OPTION_INVALID;
+	}
+}
+
+H3Error
+h3_cell_area_cached(H3Index cell, H3CellAreaUnit unit, double *area)
+{
+	H3CellCacheState *state = cache_state();
+	H3CellCacheEntry *entry;
+	H3Error		error;
+
+	if (state == NULL)
+		return cell_area(cell, unit, area);
+
+	entry = cache_lookup(state, cell);
+	if (entry != NULL && !isnan(entry->area[unit]))
+	{
+		state->hits++;
+		*area = entry->area[unit];
+		return E_SUCCESS;
+	}
+
+	state->misses++;
+	error = cell_area(cell, unit, area);
+	if (error)
+		return error;
+
+	if (entry == NULL)
+		entry = cache_insert(state, cell);
+	entry->area[unit] = *area;
+	return E_SUCCESS;
+}
+
+long
+h3_cell_cache_entries(H3CellCacheState * state)
+{
+	cache_trim(state);
+	if (state->entries == NULL)
+		return 0;
+	return hash_get_num_entries(state->entries);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_CELL_CACHE_H
+#define H3_CELL_CACHE_H
+
+#include <h3api.h>
+#include <lib/ilist.h>
+#include <utils/hsearch.h>
+
+/*
+ * Backend-local LRU cache of cell geometry, sized by h3.cell_cache_size.
+ *
+ * Like the execution statistics, the cache belongs to the h3 module and is
+ * published through a rendezvous variable, so that h3_postgis shares the
+ * same entries. Without h3 loaded the lookups fall through to H3.
+ */
+
+#define H3_CELL_CACHE_RENDEZVOUS "h3_cell_cache"
+
+typedef enum
+{
+	H3_CELL_AREA_RADS2,
+	H3_CELL_AREA_KM2,
+	H3_CELL_AREA_M2,
+	H3_CELL_AREA_UNITS
+}	H3CellAreaUnit;
+
+typedef struct
+{
+	H3Index		cell;			/* hash key */
+	dlist_node	lru;
+	bool		hasBoundary;
+	CellBoundary boundary;		/* radians, as returned by cellToBoundary */
+	double		area[H3_CELL_AREA_UNITS];	/* NaN until computed */
+}	H3CellCacheEntry;
+
+typedef struct
+{
+	int		   *capacity;		/* h3.cell_cache_size */
+	MemoryContext context;		/* holds entries, NULL while empty */
+	HTAB	   *entries;
+	dlist_head	lru;			/* most recently used first */
+	uint64		hits;
+	uint64		misses;
+	uint64		evictions;
+}	H3CellCacheState;
+
+/* cellToBoundary() going through the cache */
+H3Error		h3_cell_to_boundary_cached(H3Index cell, CellBoundary * boundary);
+
+/* cellAreaRads2(), cellAreaKm2() or cellAreaM2() going through the cache */
+H3Error		h3_cell_area_cached(H3Index cell, H3CellAreaUnit unit, double *area);
+
+/* Number of cached cells */
+long		h3_cell_cache_entries(H3CellCacheState * state);
+
+/* h3 only: publishes the cache */
+void		_cell_cache_init(void);
+
+#endif /* H3_CELL_CACHE_H */
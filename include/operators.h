@@ -22,6 +22,12 @@
 
 #include <h3api.h>
 
+/* Index strategy of <@ (h3index, h3_grid_radius), past RTMaxStrategyNumber */
+#define H3_GRID_RADIUS_STRATEGY 31
+
 H3Error h3index_grid_distance(H3Index a, H3Index b, int64_t *distance);
+int64_t h3index_grid_distance_lower_bound(H3Index ancestor, H3Index query, int64_t stopAt);
+void h3_grid_radius_from_datum(Datum radius, H3Index *origin, int *k);
+bool h3index_within_grid_radius(H3Index cell, H3Index origin, int k);
 
 #endif /* H3_OPERATORS_H */
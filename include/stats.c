@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+
+#include <fmgr.h>		   // find_rendezvous_variable, load_file
+#include <utils/memutils.h> // MemoryContextMemAllocated
+
+#include "stats.h"
+
+/* Each module links its own copy, all of them point at h3's state */
+static H3StatsState **rendezvous = NULL;
+
+static H3StatsState *
+tracking_state(void)
+{
+	H3StatsState *state;
+
+	if (rendezvous == NULL)
+	{
+		rendezvous = (H3StatsState **) find_rendezvous_variable(H3_STATS_RENDEZVOUS);
+
+		/* h3_postgis may be called first, h3 sets the variable when loaded */
+		if (*rendezvous == NULL)
+			load_file("h3", false);
+	}
+
+	state = *rendezvous;
+	if (state == NULL || !*state->track)
+		return NULL;
+	return state;
+}
+
+void
+h3_stats_begin(H3StatTimer * timer)
+{
+	timer->state = tracking_state();
+	if (timer->state == NULL)
+		return;
+
+	timer->context = CurrentMemoryContext;
+	timer->allocated = MemoryContextMemAllocated(timer->context, true);
+	INSTR_TIME_SET_CURRENT(timer->start);
+}
+
+void
+h3_stats_end(H3StatTimer * timer, H3Stat stat, int64 cells)
+{
+	H3StatEntry *entry;
+	instr_time	elapsed;
+	uint64		time;
+	Size		allocated;
+
+	if (timer->state == NULL)
+		return;
+
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, timer->start);
+	time = (uint64) (INSTR_TIME_GET_DOUBLE(elapsed) * 1e9);
+	allocated = MemoryContextMemAllocated(timer->context, true);
+
+	entry = &timer->state->pending[stat];
+	entry->calls++;
+	entry->total_time += time;
+	entry->max_time = Max(entry->max_time, time);
+	entry->cells += cells;
+	if (allocated > timer->allocated)
+		entry->max_mem_growth_bytes = Max(entry->max_mem_growth_bytes, allocated - timer->allocated);
+	timer->state->dirty = true;
+}
+
+void
+h3_stats_end_cells(H3StatTimer * timer, H3Stat stat, const H3Index * cells, int64 n)
+{
+	int64		count = 0;
+
+	if (timer->state == NULL)
+		return;
+
+	for (int64 i = 0; i < n; i++)
+	{
+		if (cells[i])
+			count++;
+	}
+	h3_stats_end(timer, stat, count);
+}
+
+void
+h3_stats_count(H3Stat stat)
+{
+	H3StatsState *state = tracking_state();
+
+	if (state == NULL)
+		return;
+
+	state->pending[stat].calls++;
+	state->dirty = true;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2026 Darafei Praliaskouski
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_STATS_H
+#define H3_STATS_H
+
+#include <h3api.h>
+#include <portability/instr_time.h>
+
+/*
+ * Execution statistics collected while h3.track_stats is on.
+ *
+ * The h3 module owns the statistics: it defines the GUC, keeps the
+ * counters in shared memory (or backend-local memory when h3 is not in
+ * shared_preload_libraries) and publishes the backend's pending counters
+ * through a rendezvous variable, so that h3_postgis can record into the
+ * same place without linking against h3. h3_postgis loads h3 when nothing
+ * has yet, so its calls are not lost before the first h3 call.
+ */
+
+#define H3_STATS_RENDEZVOUS "h3_stats"
+
+typedef enum
+{
+	H3_STAT_LATLNG_TO_CELL,
+	H3_STAT_CELL_TO_BOUNDARY,
+	H3_STAT_CELL_TO_BOUNDARY_WKB,
+	H3_STAT_CELL_TO_BOUNDARY_TWKB,
+	H3_STAT_CELL_TO_TILE_WKB,
+	H3_STAT_POLYGON_TO_CELLS,
+	H3_STAT_POLYGON_TO_CELLS_EXPERIMENTAL,
+	H3_STAT_POLYGON_TO_CELLS_PARTITION,
+	H3_STAT_REGION_PREPARE,
+	H3_STAT_TILE_TO_CELLS,
+	H3_STAT_CELLS_TO_MULTI_POLYGON,
+	H3_STAT_CELLS_TO_MULTI_POLYGON_WKB,
+	H3_STAT_CELLS_TO_MULTI_POLYGON_TWKB,
+	H3_STAT_GRID_DISK,
+	H3_STAT_GRID_DISK_DISTANCES,
+	H3_STAT_COMPACT_CELLS,
+	H3_STAT_UNCOMPACT_CELLS,
+	/* index support functions, only calls are counted */
+	H3_STAT_GIST_CONSISTENT,
+	H3_STAT_GIST_RECHECK,
+	H3_STAT_GIST_DISTANCE,
+	H3_STAT_SPGIST_INNER_CONSISTENT,
+	H3_STAT_SPGIST_LEAF_CONSISTENT,
+	H3_STAT_COUNT
+}	H3Stat;
+
+typedef struct
+{
+	uint64		calls;
+	uint64		total_time;		/* nanoseconds */
+	uint64		max_time;		/* nanoseconds */
+	uint64		cells;			/* cells produced or consumed */
+	uint64		max_mem_growth_bytes;	/* largest memory growth of a single call */
+}	H3StatEntry;
+
+/* Counters of the current backend, not yet flushed to the shared area */
+typedef struct
+{
+	bool	   *track;			/* h3.track_stats */
+	bool		dirty;
+	H3StatEntry pending[H3_STAT_COUNT];
+}	H3StatsState;
+
+typedef struct
+{
+	H3StatsState *state;		/* NULL when not tracking */
+	instr_time	start;
+	MemoryContext context;
+	Size		allocated;
+}	H3StatTimer;
+
+/* Time and memory of one call, finished by one of the h3_stats_end*() */
+void		h3_stats_begin(H3StatTimer * timer);
+void		h3_stats_end(H3StatTimer * timer, H3Stat stat, int64 cells);
+/* Like h3_stats_end(), counting the non-zero entries of cells[n] */
+void		h3_stats_end_cells(H3StatTimer * timer, H3Stat stat, const H3Index * cells, int64 n);
+/* Counts one call of an index support function */
+void		h3_stats_count(H3Stat stat);
+
+/* h3 only: defines h3.track_stats and sets up the counters */
+void		_stats_init(void);
+
+#endif /* H3_STATS_H */
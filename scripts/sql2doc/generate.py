@@ -239,6 +239,15 @@ class CreateAggregateStmt(StmtBase):
             ", ".join([str(arg) for arg in self.arguments]))
 
 
+class CreateViewStmt(StmtBase):
+    def __init__(self, name: str):
+        super().__init__(2)
+        self.name = name
+
+    def __str__(self):
+        return "{} (view)".format(self.name)
+
+
 class CreateTypeStmt(StmtBase):
     def __str__(self):
         return ""
@@ -361,10 +370,19 @@ class SQLTransformer(Transformer):
     def create_agg_stmt(self, name: str, arguments, *params):
         return CreateAggregateStmt(name, arguments)
 
+    # -- CREATE VIEW -----------------------------------------------------------
+    @v_args(inline=True)
+    def create_view_stmt(self, name: str, query):
+        return CreateViewStmt(name)
+
     # -- DO -------------------------------------------------------------------
     def do_stmt(self, children):
         return visitors.Discard
 
+    # -- REVOKE ----------------------------------------------------------------
+    def revoke_stmt(self, children):
+        return visitors.Discard
+
     # -- CREATE COMMENT --------------------------------------------------------
     @v_args(inline=True)
     def comment_on_stmt(self, child, text):